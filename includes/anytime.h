@@ -0,0 +1,59 @@
+#ifndef __ANYTIME_H__
+#define __ANYTIME_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+/// @brief The progress of a run, given to the progress callback each time a grid of lower cost is found
+struct solver_progress
+{
+    int lowest_cost; // unweighted cost of the best grid found so far
+    int tries;       // number of tries started (annealing)
+    int generations; // number of generations made (memetic engine)
+    long long moves; // number of moves made by the annealing
+    double time;     // wall time since the start of the solving (seconds)
+    int **grid;      // the best grid found so far, only valid during the call
+};
+
+/// @brief Called by the solver each time a grid of lower cost is found, on the thread solving the puzzle
+typedef void (*solver_progress_callback)(const struct solver_progress *progress, void *data);
+
+/// @brief Watches a run for the anytime solving: its deadline, and the lowest cost reported to its progress callback.
+///        The annealing is watched at the end of each temperature step, the memetic engine at the end of each generation
+struct anytime_watch
+{
+    bool active;                       // if the run has a deadline or a progress callback, nothing is watched otherwise
+    double start_time;                 // when the solving started
+    double deadline;                   // when the solving stops, 0 without deadline
+    solver_progress_callback progress; // NULL without callback
+    void *data;                        // given to the callback
+    int lowest_cost;                   // the lowest unweighted cost found so far
+    bool expired;                      // if the deadline expired
+};
+
+/// @brief Starts watching a run
+/// @param watch the watch
+/// @param budget the wall time budget of the solving (seconds), 0 without deadline
+/// @param progress the progress callback, NULL without callback
+/// @param data given to the callback
+void anytime_watch_init(struct anytime_watch *watch, double budget, solver_progress_callback progress, void *data);
+
+/// @brief Compares the cost of a grid to the lowest one found so far, and reports it to the progress callback if it is lower
+/// @param watch the watch
+/// @param cost the unweighted cost of the grid
+/// @param grid the grid
+/// @param tries the number of tries started
+/// @param generations the number of generations made
+/// @param moves the number of moves made
+/// @return true if the grid is the best one found so far, the caller keeps it
+bool anytime_watch_improved(struct anytime_watch *watch, int cost, int **grid, int tries, int generations, long long moves);
+
+/// @brief Finds if the deadline of the run expired
+/// @param watch the watch
+/// @return true once the deadline expired
+bool anytime_watch_expired(struct anytime_watch *watch);
+
+#endif
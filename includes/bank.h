@@ -0,0 +1,161 @@
+#ifndef __BANK_H__
+#define __BANK_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "decoder.h"
+
+// identifies the sidecar index files of the puzzle banks and their version
+#define BANK_INDEX_MAGIC "SDKIDX01"
+// identifies the puzzle banks in the binary format and their version
+#define BANK_BINARY_MAGIC "SDKBIN01"
+// the bytes of the nibble-packed digits of a puzzle and of its 48-bit hash in the binary format
+#define RECORD_DIGITS ((PUZZLE_SIZE + 1) / 2)
+#define RECORD_HASH 6
+
+/// @brief The formats of the puzzle banks, found from the start of the file
+enum bank_format
+{
+    BANK_TEXT,  // the text format of the sudoku-exchange-puzzle-bank, with a sidecar index
+    BANK_BINARY // records sorted by hash, with an optional block index
+};
+
+/// @brief An entry of the index of a puzzle bank: the hash of a puzzle and the offset of its record in the bank
+struct bank_entry
+{
+    char hash[HASH_SIZE]; // the hash of the puzzle, not null terminated
+    uint32_t length;      // the length of the record, without the linefeed
+    uint64_t offset;      // the offset of the record in the bank
+};
+
+/// @brief The header of the sidecar index of a puzzle bank, the index is rebuilt if the bank doesn't match it anymore
+struct bank_index_header
+{
+    char magic[8];    // BANK_INDEX_MAGIC
+    uint64_t size;    // the size of the bank when the index was built
+    int64_t mtime;    // the last modification time of the bank when the index was built
+    uint64_t entries; // the number of entries of the index, sorted by hash
+};
+
+/// @brief The header of a puzzle bank in the binary format, followed by the records and then the block index if any
+struct bank_binary_header
+{
+    char magic[8];               // BANK_BINARY_MAGIC
+    uint32_t record_size;        // the size of a record, sizeof(struct bank_record)
+    uint32_t block_records;      // the number of records of a block of the block index, 0 without block index
+    uint64_t records;            // the number of records, sorted by hash
+    uint64_t block_index_offset; // the offset of the block index: the hash of the first record of each block
+    char reserved[32];
+};
+
+/// @brief A puzzle of a bank in the binary format (48 bytes)
+struct bank_record
+{
+    uint8_t hash[RECORD_HASH];     // the 12 hexadecimal digits of the hash, big-endian
+    uint8_t digits[RECORD_DIGITS]; // the digits of the puzzle, two per byte (the first one in the high nibble), 0 for an empty cell
+    uint8_t rating;                // the rating of the puzzle in tenths, up to 25.5
+};
+
+/// @brief A memory-mapped puzzle bank and its index sorted by hash
+struct puzzle_bank
+{
+    enum bank_format format;
+    enum compression compression;      // the compression of the bank file, its content is then decoded in memory
+    const char *data;                  // the content of the bank
+    size_t size;                       // the size of the bank
+    size_t n;                          // the number of puzzles of the bank
+
+    // text format
+    const struct bank_entry *entries;  // the entries of the index, sorted by hash
+    void *index_map;                   // the mapping of the sidecar index, NULL if the index is in memory
+    size_t index_size;                 // the size of the mapping of the sidecar index
+
+    // binary format
+    const struct bank_record *records; // the records, sorted by hash
+    const uint64_t *blocks;            // the hash of the first record of each block, NULL without block index
+    size_t block_records;              // the number of records of a block
+    size_t n_blocks;                   // the number of blocks
+};
+
+/// @brief Opens a puzzle bank, in the text or the binary format. The bank is memory-mapped and so is the sidecar index of
+///        a text bank (the bank file name followed by BANK_INDEX_SUFFIX), which is built first if it is missing or out of date.
+///        A gzip or zstd compressed bank is decoded in memory instead, and a text one indexed while it is decoded
+/// @param bank the puzzle bank
+/// @param filename the file of the bank
+void puzzle_bank_open(struct puzzle_bank *bank, const char *filename);
+
+/// @brief Closes a puzzle bank
+/// @param bank the puzzle bank
+void puzzle_bank_close(struct puzzle_bank *bank);
+
+/// @brief Builds the index of a memory-mapped bank: the hash and offset of each record, sorted by hash
+/// @param data the content of the bank
+/// @param size the size of the bank
+/// @param n the number of entries of the index
+/// @return the entries of the index, allocated
+struct bank_entry *puzzle_bank_build_index(const char *data, size_t size, size_t *n);
+
+/// @brief Finds a puzzle of the bank by binary search in its index
+/// @param bank the puzzle bank
+/// @param puzzle_hash the hash of the puzzle
+/// @return the entry of the puzzle, NULL if the bank doesn't hold it
+const struct bank_entry *puzzle_bank_find(struct puzzle_bank *bank, const char *puzzle_hash);
+
+/// @brief Reads the grid of a puzzle of the bank
+/// @param bank the puzzle bank
+/// @param entry the entry of the puzzle
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+/// @return true if the record of the puzzle is valid, false otherwise
+bool puzzle_bank_read(struct puzzle_bank *bank, const struct bank_entry *entry, int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating);
+
+/// @brief Finds a puzzle of the bank by its hash and reads its grid, whatever the format of the bank
+/// @param bank the puzzle bank
+/// @param puzzle_hash the hash of the puzzle
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+/// @return true if the puzzle was found, false otherwise
+bool puzzle_bank_get(struct puzzle_bank *bank, const char *puzzle_hash, int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating);
+
+/// @brief Reads the k-th puzzle of the bank in the order of the hashes, whatever the format of the bank
+/// @param bank the puzzle bank
+/// @param k the index of the puzzle, lower than the number of puzzles of the bank
+/// @param hash the hash of the puzzle, null terminated
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+/// @return true if the record of the puzzle is valid, false otherwise
+bool puzzle_bank_at(struct puzzle_bank *bank, size_t k, char hash[HASH_SIZE + 1], int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating);
+
+/// @brief Converts the 12 hexadecimal digits of a hash to a 48-bit number
+/// @param hash the hash
+/// @param key the 48-bit number
+/// @return true if the hash is made of 12 hexadecimal digits, false otherwise
+bool bank_hash_key(const char *hash, uint64_t *key);
+
+/// @brief Packs a puzzle into a record of the binary format
+/// @param record the record
+/// @param key the 48-bit hash of the puzzle
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle
+void bank_record_encode(struct bank_record *record, uint64_t key, int grid[SUDOKU_SIZE][SUDOKU_SIZE], double rating);
+
+/// @brief Unpacks a record of the binary format
+/// @param record the record
+/// @param hash the hash of the puzzle, null terminated, can be NULL
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+void bank_record_decode(const struct bank_record *record, char hash[HASH_SIZE + 1], int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating);
+
+/// @brief Converts a puzzle bank (text or binary) to the binary format, written to a temporary file renamed once complete
+/// @param input the file of the bank to convert
+/// @param output the file of the bank in the binary format
+/// @param block_records the number of records of a block of the block index, 0 without block index
+/// @return the number of puzzles converted, -1 if the output couldn't be written
+long puzzle_bank_convert(const char *input, const char *output, size_t block_records);
+
+#endif
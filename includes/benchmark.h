@@ -23,4 +23,14 @@ void sudoku_plot_difficulty_benchmark(int argc, char *argv[], const char *diffic
 /// @param filename the given file
 void sudoku_plot_cost_per_difficulty(const char *filename);
 
+/// @brief Creates histogram comparing the average execution time of the unweighted and weighted (breakout) cost functions
+///        for each sudoku difficulty using the given file
+/// @param filename the given file
+void sudoku_plot_weighting_benchmark(const char *filename);
+
+/// @brief Creates histograms comparing the moves per second and the sweeps over the non fixed cells needed by each order
+///        of the cells changed, for each sudoku difficulty using the given file
+/// @param filename the given file
+void sudoku_plot_sweep_benchmark(const char *filename);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef __CACHE_H__
+#define __CACHE_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "bank.h"
+#include "canonical.h"
+
+// identifies the solution cache files and their version
+#define CACHE_MAGIC "SDKCCH01"
+
+/// @brief The header of a solution cache file, followed by the records
+struct cache_header
+{
+    char magic[8];        // CACHE_MAGIC
+    uint32_t record_size; // the size of a record, sizeof(struct cache_record)
+    uint32_t reserved;
+};
+
+/// @brief A puzzle of the cache and its solution, both in canonical form (82 bytes)
+struct cache_record
+{
+    uint8_t puzzle[RECORD_DIGITS];   // the digits of the canonical puzzle, two per byte (the first one in the high nibble)
+    uint8_t solution[RECORD_DIGITS]; // the digits of its solution, mapped through the same symmetry
+};
+
+/// @brief The solutions of the puzzles already solved, keyed by the canonical form of the puzzles: loaded in a hash table at
+///        the start and extended by appending a record to the file for each new puzzle solved
+struct solution_cache
+{
+    int fd;
+    struct cache_record *records; // the records, in the order of the file
+    size_t n;                     // the number of records
+    size_t capacity;              // the number of records allocated
+    size_t *slots;                // the index + 1 of the record in each slot of the hash table, 0 for an empty slot
+    size_t size;                  // the number of slots (a power of two)
+    pthread_rwlock_t lock;        // the puzzles are looked up by several threads at once, the new ones are added one at a time
+    long hits;                    // the number of puzzles found in the cache
+    long misses;                  // the number of puzzles not found in the cache
+};
+
+/// @brief Opens a solution cache file and loads its records, a truncated last record is ignored
+/// @param cache the solution cache
+/// @param filename the cache file, created if needed
+void solution_cache_open(struct solution_cache *cache, const char *filename);
+
+/// @brief Looks a puzzle up in the cache, the solution found is mapped back through the inverse symmetry of the canonical form
+///        and only given if it is a valid grid agreeing with the puzzle
+/// @param cache the solution cache
+/// @param form the canonical form of the puzzle
+/// @param solution the solution of the puzzle, allocated by the caller
+/// @return true if the puzzle was found, false otherwise
+bool solution_cache_find(struct solution_cache *cache, const struct canonical_form *form, int **solution);
+
+/// @brief Adds the solution of a puzzle to the cache and appends it to the file, unless the puzzle is already in the cache
+/// @param cache the solution cache
+/// @param form the canonical form of the puzzle
+/// @param solution the solution of the puzzle
+/// @return false if the solution couldn't be added (out of memory) or appended to the file, true otherwise
+bool solution_cache_store(struct solution_cache *cache, const struct canonical_form *form, int **solution);
+
+/// @brief Closes a solution cache file and frees its records
+/// @param cache the solution cache
+void solution_cache_close(struct solution_cache *cache);
+
+#endif
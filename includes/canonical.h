@@ -0,0 +1,42 @@
+#ifndef __CANONICAL_H__
+#define __CANONICAL_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+
+/// @brief The canonical form of a grid under the symmetries of the sudoku (transposition, permutations of the bands and of
+///        the stacks, of the lines inside each band and of the columns inside each stack, relabeling of the digits) and the
+///        symmetry mapping the grid to it. The canonical form is the smallest grid (read line by line, empty cells first) of
+///        every equivalent grid once its digits are relabeled in the order they appear
+struct canonical_form
+{
+    uint8_t digits[PUZZLE_SIZE]; // the canonical grid, 0 for an empty cell
+    bool transposed;             // if the grid is transposed before the permutations
+    int line[SUDOKU_SIZE];       // the line of the (transposed) grid at each line of the canonical grid
+    int column[SUDOKU_SIZE];     // the column of the (transposed) grid at each column of the canonical grid
+    int label[SUDOKU_SIZE + 1];  // the canonical digit of each digit of the grid (label[0] is 0)
+};
+
+/// @brief Finds the canonical form of a grid and the symmetry mapping the grid to it. The symmetries are explored line by line
+///        of the canonical grid and a branch is left as soon as its lines are larger than the smallest grid found
+/// @param grid the grid, its empty cells are 0
+/// @param form the canonical form of the grid
+void sudoku_canonicalize(int **grid, struct canonical_form *form);
+
+/// @brief Maps a grid equivalent to the canonicalized one (its solution) through the same symmetry
+/// @param form the canonical form
+/// @param grid the grid
+/// @param digits the digits of the grid mapped, line by line
+void canonical_form_apply(const struct canonical_form *form, int **grid, uint8_t *digits);
+
+/// @brief Maps a grid back through the inverse of the symmetry of the canonical form
+/// @param form the canonical form
+/// @param digits the digits of a grid equivalent to the canonical grid (its solution), line by line
+/// @param grid the grid mapped back
+void canonical_form_restore(const struct canonical_form *form, const uint8_t *digits, int **grid);
+
+#endif
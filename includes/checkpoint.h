@@ -0,0 +1,105 @@
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "solver.h"
+
+// identifies the checkpoint files and their version
+#define CHECKPOINT_MAGIC "SDKCKP01"
+
+/// @brief The settings a run is resumed with, they must be the ones it was started with
+struct checkpoint_settings
+{
+    int32_t weighting;
+    int32_t adaptive;
+    int32_t tightening;
+    int32_t strategy;
+    int32_t cost_function;
+    int32_t initializer;
+    int32_t sweep_order;
+    int32_t multiple_tries;
+    double perturbation;
+    double cycle_probability;
+    double chain_probability;
+    int32_t givens[SUDOKU_SIZE][SUDOKU_SIZE]; // the grid of the puzzle
+};
+
+/// @brief The whole state of an annealing run between two tries: enough to go on with the next try exactly as the
+///        uninterrupted run would have. The file is only read back by the program that wrote it (same configuration)
+struct solver_checkpoint
+{
+    char magic[8];                     // CHECKPOINT_MAGIC
+    uint32_t size;                     // sizeof(struct solver_checkpoint), the files of other builds are refused
+    uint32_t seed;                     // the state of the pseudo random number generator
+    struct checkpoint_settings settings;
+
+    int32_t tries;                     // the number of tries done
+    int32_t weight_raises;             // the number of raises of the weights of the units
+    int32_t lowest_cost;               // the lowest unweighted cost found so far
+    int32_t has_best;                  // if the best grid is kept
+    int64_t moves;                     // the number of moves made so far
+    double elapsed;                    // the wall time of the run so far (seconds)
+    double start_temperature;          // the calibrated temperatures, not calibrated again
+    double stop_temperature;
+    char date[FILE_SIZE];              // the date naming the stats files of the run, which go on in the same files
+
+    int32_t lines[SUDOKU_SIZE][SUDOKU_SIZE]; // the grid at the end of the last try
+    int32_t best[SUDOKU_SIZE][SUDOKU_SIZE];  // the best grid found so far
+    int32_t weights[UNITS];                  // the weight of each unit (weighting)
+    struct restart_policy policy;
+    struct cell_sweep sweep;
+    struct operator_selector selector;
+
+    int32_t fixed[SUDOKU_SIZE][SUDOKU_SIZE];  // the givens and the cells promoted (tightening)
+    int32_t domain[SUDOKU_SIZE][SUDOKU_SIZE]; // the candidates of each cell (tightening)
+    int32_t promoted;
+    int32_t rejected;
+    int32_t rounds;
+    int32_t stable;
+    int32_t probed;
+    int32_t refuted;
+    int32_t cursor;
+    int32_t tested[SUDOKU_SIZE][SUDOKU_SIZE]; // the candidates tested without contradiction (tightening)
+};
+
+/// @brief Starts a checkpoint of a run: the header and the settings, the state is filled by the solver
+/// @param checkpoint the checkpoint
+/// @param original_grid the grid of the puzzle
+/// @param options the settings of the run
+void solver_checkpoint_init(struct solver_checkpoint *checkpoint, int **original_grid, const struct solver_options *options);
+
+/// @brief Copies a grid into a checkpoint
+/// @param grid the grid of the checkpoint
+/// @param lines the grid copied
+void checkpoint_grid_save(int32_t grid[SUDOKU_SIZE][SUDOKU_SIZE], int **lines);
+
+/// @brief Copies a grid of a checkpoint back
+/// @param lines the grid, allocated by the caller
+/// @param grid the grid of the checkpoint
+void checkpoint_grid_load(int **lines, const int32_t grid[SUDOKU_SIZE][SUDOKU_SIZE]);
+
+/// @brief Writes a checkpoint atomically: to a temporary file synced to the disk then renamed over the previous checkpoint,
+///        so the file always holds a whole checkpoint, even if the process is killed while writing it
+/// @param filename the checkpoint file
+/// @param checkpoint the checkpoint
+/// @return false if the checkpoint couldn't be written (the previous one is kept), true otherwise
+bool solver_checkpoint_write(const char *filename, const struct solver_checkpoint *checkpoint);
+
+/// @brief Reads a checkpoint, the program stops if the file isn't a checkpoint of this build or of this puzzle and settings
+/// @param filename the checkpoint file
+/// @param checkpoint the checkpoint read
+/// @param original_grid the grid of the puzzle
+/// @param options the settings of the run
+/// @return false if there is no checkpoint file, true otherwise
+bool solver_checkpoint_read(const char *filename, struct solver_checkpoint *checkpoint, int **original_grid, const struct solver_options *options);
+
+/// @brief Removes the checkpoint of a finished run
+/// @param filename the checkpoint file
+void solver_checkpoint_remove(const char *filename);
+
+#endif
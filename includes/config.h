@@ -23,8 +23,34 @@
 #define LINE_SIZE 100
 
 #define SUDOKU_DIR "./ressources/"
+#define BANK_INDEX_SUFFIX ".idx" // the sidecar index of a puzzle bank, next to the bank
+#define BANK_BLOCK_RECORDS 4096 // the number of puzzles of a block of the block index of the binary puzzle banks
+#define DECODER_CHUNK 65536 // the size of the blocks read and decoded at once from the compressed puzzle banks
+#define ZSTD_COMMAND "zstd" // the program decoding the zstd compressed puzzle banks
+#define RESULT_FORMAT "jsonl" // the format of the result files: jsonl (one JSON object per line) or binary (fixed-size records)
+#define SINK_BUFFER_SIZE 65536 // the size of the batches of lines written to the JSONL result files
+#define SINK_BLOCK_RECORDS 1024 // the number of records the binary result files are extended by
+#define STREAM_WINDOW 256 // the maximum number of puzzles read from the standard input and not written yet when the solutions are written in order
 #define FILE_SIZE 256
 #define DEBUG_SIZE 256
+#define LOGGER_RING_SIZE (1 << 20) // the size of the ring buffer of each thread writing stats or debug lines
+#define LOGGER_THREADS 64 // the maximum number of threads writing stats or debug lines, the lines of the others are dropped
+#define LOGGER_FILES 16 // the number of stats or debug files kept open by the logger
+#define LOGGER_FILE_BUFFER 65536 // the size of the buffer of each file kept open by the logger
+#define LOGGER_LINE_SIZE 1024 // the maximum length of a stats or debug line, longer lines are truncated
+#define LOGGER_INTERVAL 10 // the time the logger sleeps when no line is waiting (ms)
+#define LOGGER_BLOCK (false) // wait for room when the ring buffer of a thread is full, instead of dropping the line
+#define TRACE_LEVEL "accepted" // what the traces of the annealing record: sampled (grid snapshots), accepted (accepted moves) or complete (every move)
+#define TRACE_BUFFER_SIZE (1 << 20) // the size of the blocks of events written at once to the trace files
+#define CACHE_SLOTS 4096 // the initial number of slots of the hash table of the solution cache (a power of two)
+#define TRACE_SAMPLE_PERIOD 10000 // the number of moves between two snapshots of the grid in the sampled traces
+#define CHECKPOINT_INTERVAL 60 // the minimum time between two checkpoints of a run (seconds), they are only saved between two tries
+#define VERIFY_BATCH 65536 // the number of results verified at once by the verifier, spread over the threads
+#define SERVER_CONNECTIONS 64 // the maximum number of clients connected to the solver daemon at once
+#define SERVER_QUEUE 1024 // the maximum number of puzzles waiting for a worker of the daemon, the clients are not read anymore past it
+#define SERVER_PIPELINE 256 // the maximum number of puzzles of a client queued or being solved by the daemon, its next ones wait in the socket
+#define SERVER_INPUT_SIZE 4096 // the size of the buffer of the bytes received from a client and not parsed yet
+#define SERVER_SEND_TIMEOUT 10 // the time an answer waits for a client not reading them before the client is dropped (seconds)
 
 // configuration of the solving algorithm
 #define MAX_TRIES 1000
@@ -39,7 +65,21 @@
 
 #define KEEP_START (false)
 
-#define OLD (true)
+// the cost function of the annealing: pairs (pairs of cells in conflict), free (conflicts of the non fixed cells) or missing (digits missing from each unit)
+#define COST_FUNCTION "pairs"
+// the initial grid of each try: random (independent digits), box (permutation of the missing digits of each region),
+// greedy (digit in the fewest conflicts) or presolved (forced cells first, then box)
+#define INITIALIZER "random"
+// the order of the non fixed cells changed by the single cell moves: random, sequential, box or permutation (a new one each sweep)
+#define SWEEP_ORDER "random"
+// the number of new values proposed at once for a cell by the multiple-try Metropolis moves, 1 for the usual single proposal
+#define MULTIPLE_TRIES 1
+#define MULTIPLE_TRIES_MAX 64 // the maximum number of new values proposed at once for a cell
+// tighten the candidates of each cell and promote the forced cells to fixed cells during the run
+#define DOMAIN_TIGHTENING (false)
+// the number of candidates tested by propagation between two tries when tightening, among the ones the grid of the try
+// doesn't hold: a candidate whose assumption leads to a contradiction is removed
+#define DOMAIN_PROBES 32
 
 #define TEMP_STEP 1 //the temperature is divided by two each step (depends on the numbers of tries)
 #define SOLUTION_COST 0 // the cost of the wanted solution of the sudoku
@@ -47,6 +87,46 @@
 #define TEMPERATURE_CEILING 0.00273852
 #define PRESUMED_PUZZLE_SIZE PUZZLE_SIZE
 
+// calibration of the start and stop temperatures from the initial grid of the tries (see INITIALIZER)
+#define AUTO_TEMPERATURE (true)
+#define CALIBRATION_SAMPLES 1000 // the number of random cell changes sampled to calibrate the temperatures
+#define CALIBRATION_ROUNDS 32 // the maximum number of refinements of the start temperature
+#define START_ACCEPTANCE 0.8 // the wanted acceptance rate of the uphill moves at the start temperature
+#define STOP_ACCEPTANCE 0.001 // the wanted acceptance rate of the smallest uphill move at the stop temperature
+#define COOLING_STEPS 365 // the number of temperature steps between the calibrated temperatures (as many as the static schedule)
+
+// restart policy of the solving algorithm (see restart.h)
+#define RESTART_STRATEGY "fixed" // fixed, luby, geometric or plateau
+#define RESTART_BASE 32 // the number of temperature steps of a unit try (luby and geometric strategies)
+#define RESTART_FACTOR 1.5 // the growth factor of the length of each try (geometric strategy)
+#define RESTART_PLATEAU_STEPS 60 // the number of temperature steps without improvement before restarting (plateau strategy)
+#define RESTART_PERTURBATION 0.0 // the fraction of the free cells of the best grid randomized at each restart (0 randomizes the whole grid)
+
+// constraint weighting (breakout) of the cost function
+#define WEIGHT_INCREMENT 1 // the raise of the weight of a violated unit at each local minimum
+#define WEIGHT_DECAY 0.5 // the factor applied to the extra weight of every unit when decaying
+#define WEIGHT_DECAY_PERIOD 10 // the number of raises of the weights between each decay
+
+// compound moves mixed with the single cell changes (see moves.h)
+#define CYCLE_PROBABILITY 0.0 // the probability of a move to rotate three non fixed cells of a region
+#define CHAIN_PROBABILITY 0.0 // the probability of a move to be an ejection chain
+#define CHAIN_LENGTH 3 // the maximum number of cells changed by an ejection chain
+
+// adaptive selection of the kind of each move (see operators.h)
+#define ADAPTIVE_OPERATORS (false)
+#define ADAPTIVE_MIN_PROBABILITY 0.05 // the lowest probability of each kind of move
+#define ADAPTIVE_LEARNING_RATE 0.3 // the weight of the last temperature step in the quality of each kind of move
+#define ADAPTIVE_TIMING_PERIOD 16 // one move of each kind out of this many is timed
+
+// memetic engine (see memetic.h)
+#define POPULATION_SIZE 24 // the number of grids kept at each generation
+#define MEMETIC_CHILDREN 24 // the number of children created at each generation
+#define MEMETIC_GENERATIONS 1000 // the maximum number of generations
+#define MEMETIC_TOURNAMENT 2 // the number of individuals competing to be chosen as a parent
+#define MEMETIC_REGION_CROSSOVER 0.5 // the probability of a crossover to exchange regions rather than lines
+#define MEMETIC_POLISH_STEPS 40 // the number of temperature steps of the annealing polish of each child
+#define MEMETIC_POLISH_TEMPERATURE 0.25 // the start temperature of the polish, as a fraction of the calibrated start temperature
+
 #define GET_STATS (false)
 
 // gnuplot configuration
@@ -60,7 +140,10 @@
 
 extern const char plot_colors[10][10];
 
-//output settings
-#define DATA_PIPE "/tmp/sudoku"
+// live visualization of a run, with the solver built by `make show` (see snapshot.h)
+#define SNAPSHOT_NAME "/sudoku" // the shared memory segment the solver publishes the state of its run to
+#define SNAPSHOT_RATE 60 // the maximum number of states published per second
+#define SNAPSHOT_CHECK_PERIOD 4096 // the number of moves between two looks at the clock of the solver (a power of two)
+#define VISUALIZATION_FPS 20 // the number of frames drawn per second by the viewer
 
 #endif
\ No newline at end of file
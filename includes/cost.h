@@ -0,0 +1,153 @@
+#ifndef __COST_H__
+#define __COST_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "config.h"
+
+// the lines, columns and regions of the grid are the units of the constraints, each with its own weight:
+// the weights of the lines come first, then the ones of the columns and then the ones of the regions
+#define UNITS (3 * SUDOKU_SIZE)
+#define line_unit(L) (L)
+#define column_unit(C) (SUDOKU_SIZE + (C))
+#define region_unit(R) (2 * SUDOKU_SIZE + (R))
+
+/// @brief The cost functions of the solving algorithm, all of them are 0 only for a solved grid
+enum cost_function
+{
+    COST_PAIRS,      // pairs of cells violating a constraint (sudoku_constraints_old)
+    COST_FREE_CELLS, // constraints violated by each non fixed cell (sudoku_constraints)
+    COST_MISSING,    // digits missing from each line, column and region (sudoku_missing_digits)
+    COST_FUNCTIONS   // the number of cost functions
+};
+
+/// @brief The cost model of the solving algorithm: the cost function, the fixed cells and the weight of each unit if any
+struct cost_model
+{
+    enum cost_function kind;
+    int **original_grid; // the starting grid, the cells different from 0 are fixed
+    int *weights;        // the weight of each unit, NULL for the unweighted cost
+};
+
+/// @brief Calculates the total amount of constraints violated in the sudoku grid by checking
+///        the occurence of a given number in the lines, columns and regions of the sudoku
+/// @param nb the given number to find the total amount of constraints violated
+/// @param start_l the starting index of the line
+/// @param start_c the starting index of the column
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of constraints violated in the given sudoku for the given cell
+int sudoku_cell_constraints(int nb, int start_l, int start_c, int **lines, int ***columns, int ***regions);
+
+/// @brief Checks the total amount of constraints violated of every non fixed cell in the provided grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of constraints violated in the given sudoku
+int sudoku_constraints(int **original_grid, int **lines, int ***columns, int ***regions);
+
+/// @brief Counts the pairs of cells of the provided grid violating a constraint
+/// @param original_grid the starting grid
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of pairs of cells violating a constraint
+int sudoku_constraints_old(int **original_grid, int **lines, int ***columns, int ***regions);
+
+/// @brief Counts the digits missing from each line, column and region of the provided grid
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of digits missing from the units of the grid
+int sudoku_missing_digits(int **lines, int ***columns, int ***regions);
+
+/// @brief Initializes a cost model
+/// @param model the cost model
+/// @param kind the cost function used
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param weights the weight of each unit, NULL for the unweighted cost
+void cost_model_init(struct cost_model *model, enum cost_function kind, int **original_grid, int *weights);
+
+/// @brief Finds the cost function corresponding to the given name
+/// @param name the name of the cost function (pairs, free or missing)
+/// @param kind the corresponding cost function
+/// @return true if the name is a known cost function, false otherwise
+bool cost_function_parse(const char *name, enum cost_function *kind);
+
+/// @brief Gets the name of the given cost function
+/// @param kind the cost function
+/// @return the name of the cost function
+const char *cost_function_name(enum cost_function kind);
+
+/// @brief Gets the line and column indexes of the k-th cell of the given unit
+/// @param unit the unit (see line_unit, column_unit and region_unit)
+/// @param k the index of the cell in the unit
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+void sudoku_unit_cell(int unit, int k, int *line, int *column);
+
+/// @brief Calculates the cost of each unit (line, column and region) of the grid for the cost function of the model
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param costs the cost of each unit
+void sudoku_unit_costs(int **lines, int ***columns, int ***regions, struct cost_model *model, int costs[UNITS]);
+
+/// @brief Calculates the cost of the provided grid for the cost function of the model, weighted by the weight of each unit if any
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @return the cost of the grid
+int sudoku_cost(int **lines, int ***columns, int ***regions, struct cost_model *model);
+
+/// @brief Calculates the change of the cost of the grid if the given non fixed cell took the given number (the cell isn't modified),
+///        in a single pass over the line, column and region of the cell
+/// @param nb the new number of the cell
+/// @param start_l the line index of the cell
+/// @param start_c the column index of the cell
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @return the change of the cost
+int sudoku_cell_delta(int nb, int start_l, int start_c, int **lines, int ***columns, int ***regions, struct cost_model *model);
+
+/// @brief Calculates the change of the cost of the grid for every number the given non fixed cell could take (the cell isn't modified),
+///        in a single pass over the line, column and region of the cell
+/// @param start_l the line index of the cell
+/// @param start_c the column index of the cell
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param deltas the change of the cost for each number from 1 to SUDOKU_SIZE (0 for the current number of the cell)
+void sudoku_cell_deltas(int start_l, int start_c, int **lines, int ***columns, int ***regions, struct cost_model *model, int deltas[SUDOKU_SIZE + 1]);
+
+/// @brief Sets the weight of every unit to 1, the weighted cost is then the unweighted one
+/// @param weights the weight of each unit
+void sudoku_weights_init(int *weights);
+
+/// @brief Raises the weight of every unit still violating a constraint by WEIGHT_INCREMENT
+/// @param model the cost model, with the weight of each unit
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the number of units whose weight was raised
+int sudoku_weights_bump(struct cost_model *model, int **lines, int ***columns, int ***regions);
+
+/// @brief Decays the weight of every unit towards 1 by the WEIGHT_DECAY factor
+/// @param weights the weight of each unit
+void sudoku_weights_decay(int *weights);
+
+/// @brief Prints the configuration of the cost function of the sudoku solving algorithm
+/// @param model the cost model
+void print_cost_config(struct cost_model *model);
+
+#endif
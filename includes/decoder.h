@@ -0,0 +1,62 @@
+#ifndef __DECODER_H__
+#define __DECODER_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "config.h"
+
+#define COMPRESSION_MAGIC_SIZE 4 // the size of the longest magic of the compressions, the first bytes read to find them
+
+/// @brief The compressions of the puzzle banks, found from their first bytes
+enum compression
+{
+    COMPRESSION_NONE, // plain text or binary bank
+    COMPRESSION_GZIP, // gzip, decoded with zlib
+    COMPRESSION_ZSTD  // zstd, decoded by the ZSTD_COMMAND program
+};
+
+/// @brief A compressed input decoded on a background thread: the decoded bytes are read from a pipe while the rest of
+///        the input is still being decoded
+struct stream_decoder
+{
+    enum compression kind;
+    FILE *input;      // the compressed input
+    FILE *output;     // the decoded input, the read end of the pipe
+    int pipe;         // the write end of the pipe, the decoded bytes are written to it
+    pthread_t thread; // decodes the input (gzip) or feeds it to the decoding process (zstd)
+    pid_t process;    // the decoding process (zstd), -1 if none
+    bool failed;      // if the input is corrupted or truncated
+    unsigned char prefix[COMPRESSION_MAGIC_SIZE]; // the first bytes of the input, already read from it to find its compression
+    size_t prefixed;  // the number of bytes of the prefix, decoded before the rest of the input
+};
+
+/// @brief Finds the compression of an input from its first bytes
+/// @param bytes the first bytes of the input
+/// @param n the number of bytes given, an input shorter than the magic of a compression isn't compressed
+/// @return the compression of the input, COMPRESSION_NONE if it isn't compressed
+enum compression compression_detect(const unsigned char *bytes, size_t n);
+
+/// @brief Gets the name of the given compression
+/// @param kind the compression
+/// @return the name of the compression
+const char *compression_name(enum compression kind);
+
+/// @brief Starts decoding a compressed input on a background thread, the decoded bytes are read from the output of the decoder
+/// @param decoder the decoder
+/// @param input the compressed input, from its start or right after the given prefix
+/// @param kind the compression of the input
+/// @param prefix the first bytes of the input, already read from it (a pipe can't be rewound), NULL if none
+/// @param prefixed the number of bytes of the prefix, at most COMPRESSION_MAGIC_SIZE
+void stream_decoder_open(struct stream_decoder *decoder, FILE *input, enum compression kind, const unsigned char *prefix,
+                         size_t prefixed);
+
+/// @brief Stops the decoder, the output is closed (the input isn't) and the background thread joined
+/// @param decoder the decoder
+/// @return true if the part of the input read was decoded without error, false if it is corrupted or truncated
+bool stream_decoder_close(struct stream_decoder *decoder);
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef __DOMAINS_H__
+#define __DOMAINS_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+// every number of a domain, as the bits 1 to SUDOKU_SIZE
+#define DOMAIN_ALL (((1 << SUDOKU_SIZE) - 1) << 1)
+
+/// @brief The candidate numbers of each cell of the grid. A cell whose domain is reduced to a single number is promoted to
+///        a fixed cell, the solver then stops changing it
+struct cell_domains
+{
+    int **givens;                          // the starting grid, never modified
+    int **fixed;                           // the starting grid with the promoted cells, the cells different from 0 are fixed
+    int domain[SUDOKU_SIZE][SUDOKU_SIZE];  // the candidates of each cell, bit nb is set if the cell can still hold nb
+    int promoted;                          // number of cells promoted to fixed cells
+    int rejected;                          // number of promotions rejected by the verification against the givens
+    int rounds;                            // number of tightening rounds done
+    bool stable;                           // true once a tightening round didn't remove any candidate
+    int probed;                            // number of candidates tested by propagation
+    int refuted;                           // number of candidates removed because assuming them led to a contradiction
+    int cursor;                            // the cell the next candidates tested start from, line by line
+    int tested[SUDOKU_SIZE][SUDOKU_SIZE];  // the candidates tested without contradiction since the domains last shrank
+};
+
+/// @brief Initializes the domains of the cells from the givens and promotes the cells forced by them
+/// @param domains the domains of the cells
+/// @param original_grid the starting grid
+/// @return false if the grid of the fixed cells couldn't be allocated, true otherwise
+bool cell_domains_init(struct cell_domains *domains, int **original_grid);
+
+/// @brief Frees the grid of the fixed cells of the domains
+/// @param domains the domains of the cells
+void cell_domains_free(struct cell_domains *domains);
+
+/// @brief Promotes the given cell to a fixed cell holding the given number, after checking that the number doesn't conflict
+///        with the givens of the original grid nor with the cells already fixed. The number is removed from the domains
+///        of the other cells of its line, column and region
+/// @param domains the domains of the cells
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param nb the number of the cell
+/// @return true if the cell was promoted, false if the promotion was rejected
+bool cell_domains_promote(struct cell_domains *domains, int line, int column, int nb);
+
+/// @brief Promotes every cell forced by the domains: a single candidate left in the cell (naked single) or a single cell left
+///        for a number in a line, column or region (hidden single), until no cell is forced anymore
+/// @param domains the domains of the cells
+/// @return the number of cells promoted
+int cell_domains_propagate(struct cell_domains *domains);
+
+/// @brief Tightening round: removes the candidates excluded by the locked candidates (a number of a region confined to a line or
+///        a column, or the other way round) and the naked pairs of each line, column and region, then promotes the forced cells
+/// @param domains the domains of the cells
+/// @return the number of cells promoted
+int cell_domains_tighten(struct cell_domains *domains);
+
+/// @brief Probing round guided by the annealing: the candidates of the non fixed cells that the grid of the try doesn't hold
+///        are the likely wrong ones, up to DOMAIN_PROBES of them not tested yet are assumed one at a time and propagated on a
+///        copy of the domains. A candidate leading to a contradiction can't be part of the solution, it is removed, then the
+///        forced cells are promoted (still verified against the givens)
+/// @param domains the domains of the cells
+/// @param sudoku_grid the grid found by the last try
+/// @return the number of cells promoted
+int cell_domains_probe(struct cell_domains *domains, int **sudoku_grid);
+
+/// @brief Copies the numbers of the fixed cells into the given grid
+/// @param domains the domains of the cells
+/// @param sudoku_grid the given sudoku grid
+void cell_domains_apply(struct cell_domains *domains, int **sudoku_grid);
+
+/// @brief Chooses a random number of the domain of the given cell, different from its current number
+/// @param domains the domains of the cells
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param current the current number of the cell
+/// @param seed the seed used in the pseudo random number generator
+/// @return the number chosen
+int cell_domains_value(struct cell_domains *domains, int line, int column, int current, unsigned int *seed);
+
+/// @brief Prints the state of the domains of the sudoku solving algorithm
+/// @param domains the domains of the cells
+void cell_domains_print(struct cell_domains *domains);
+
+#endif
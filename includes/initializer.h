@@ -0,0 +1,85 @@
+#ifndef __INITIALIZER_H__
+#define __INITIALIZER_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "config.h"
+
+/// @brief The ways of filling the non fixed cells of the grid at the start of a try
+enum sudoku_initializer
+{
+    INIT_RANDOM,    // each non fixed cell gets an independent random digit
+    INIT_BOX,       // each region gets a random permutation of its missing digits
+    INIT_GREEDY,    // the non fixed cells are visited in a random order and get the digit in the fewest conflicts
+    INIT_PRESOLVED, // the cells forced by the fixed ones are filled first, then each region gets a permutation of its missing digits
+    INITIALIZERS    // the number of initializers
+};
+
+/// @brief The initializer of the grid, with the presolved grid when needed
+struct grid_initializer
+{
+    enum sudoku_initializer kind;
+    int **original_grid; // the starting grid, the cells different from 0 are fixed
+    int **presolved;     // the starting grid with the forced cells filled (presolved initializer), NULL otherwise
+    int forced;          // number of cells filled by the presolve
+};
+
+/// @brief Initializes the grid initializer, the starting grid is presolved once if needed
+/// @param initializer the grid initializer
+/// @param kind the way of filling the grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @return false if the presolved grid couldn't be allocated, true otherwise
+bool grid_initializer_init(struct grid_initializer *initializer, enum sudoku_initializer kind, int **original_grid);
+
+/// @brief Frees the presolved grid of the initializer if any
+/// @param initializer the grid initializer
+void grid_initializer_free(struct grid_initializer *initializer);
+
+/// @brief Copies the cells of the starting grid fixed since the initializer was initialized into its presolved grid
+/// @param initializer the grid initializer
+void grid_initializer_refresh(struct grid_initializer *initializer);
+
+/// @brief Finds the initializer corresponding to the given name
+/// @param name the name of the initializer (random, box, greedy or presolved)
+/// @param kind the corresponding initializer
+/// @return true if the name is a known initializer, false otherwise
+bool sudoku_initializer_parse(const char *name, enum sudoku_initializer *kind);
+
+/// @brief Gets the name of the given initializer
+/// @param kind the initializer
+/// @return the name of the initializer
+const char *sudoku_initializer_name(enum sudoku_initializer kind);
+
+/// @brief Fills each region of the grid with a random permutation of the digits missing from its fixed cells
+/// @param sudoku_grid the given sudoku grid
+/// @param original_grid the grid whose cells different from 0 are kept
+/// @param seed the randomization seed used
+void sudoku_fill_regions(int ***sudoku_grid, int **original_grid, unsigned int *seed);
+
+/// @brief Fills the non fixed cells of the grid in a random order, each one with the digit appearing the fewest times
+///        in its line, column and region among the cells already filled (ties are broken at random)
+/// @param sudoku_grid the given sudoku grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param seed the randomization seed used
+void sudoku_fill_greedy(int ***sudoku_grid, int **original_grid, unsigned int *seed);
+
+/// @brief Fills the cells of the grid forced by the other ones (a single candidate left in the cell, or a single cell left
+///        for a digit in a line, column or region) until no cell is forced anymore
+/// @param sudoku_grid the given sudoku grid, its empty cells are 0
+/// @return the number of cells filled
+int sudoku_presolve(int **sudoku_grid);
+
+/// @brief Fills the non fixed cells of the grid with the initializer
+/// @param initializer the grid initializer
+/// @param sudoku_grid the given sudoku grid
+/// @param seed the randomization seed used
+void sudoku_initialize(struct grid_initializer *initializer, int ***sudoku_grid, unsigned int *seed);
+
+/// @brief Prints the configuration of the initializer of the sudoku solving algorithm
+/// @param initializer the grid initializer
+void grid_initializer_print(struct grid_initializer *initializer);
+
+#endif
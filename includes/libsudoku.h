@@ -0,0 +1,46 @@
+#ifndef __LIBSUDOKU_H__
+#define __LIBSUDOKU_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "solver.h"
+
+/// @brief The outcome of a call of the library
+enum libsudoku_status
+{
+    LIBSUDOKU_OK,             // the puzzle was solved or the run ended, the solution holds the grid found
+    LIBSUDOKU_ERROR_ARGUMENT, // a pointer given is NULL
+    LIBSUDOKU_ERROR_PUZZLE,   // the puzzle isn't 81 digits ('0' or '.' for an empty cell) or two givens are in conflict
+    LIBSUDOKU_ERROR_OPTIONS,  // a setting is out of its range, or asks for a trace or a checkpoint (program only)
+    LIBSUDOKU_ERROR_MEMORY,   // an allocation failed, the memory allocated by the call before is freed
+    LIBSUDOKU_STATUSES        // the number of outcomes
+};
+
+/// @brief The outcome of the solving of a puzzle by the library, in a buffer given by the caller
+struct libsudoku_solution
+{
+    char grid[PUZZLE_SIZE + 1];  // the grid found, line by line, digits '1' to '9' (null terminated)
+    struct solver_result result; // the outcome of the solving
+};
+
+/// @brief Gets the name of the given outcome
+/// @param status the outcome
+/// @return the name of the outcome
+const char *libsudoku_status_name(enum libsudoku_status status);
+
+/// @brief Solves a puzzle. Nothing is printed nor logged and the program is never stopped, the state of the call only lives
+///        in the call and in the buffers of the caller: several threads can solve puzzles at once, with the same options
+/// @param puzzle the puzzle: 81 digits line by line, '0' or '.' for the empty cells
+/// @param options the settings of the solving (solver_options_init), the printing settings are left out. A solution cache
+///        may be shared by the calls, a solution that can't be stored in it is still returned. With a deadline, the best grid
+///        found is returned once it expires, the progress callback is called on the calling thread
+/// @param seed the seed of the pseudo random number generator, the same seed and settings make the same run
+/// @param solution the grid found and the outcome of the solving
+/// @return LIBSUDOKU_OK, or the error that stopped the call (the solution is then left as it is)
+enum libsudoku_status libsudoku_solve(const char *puzzle, const struct solver_options *options, unsigned int seed,
+                                      struct libsudoku_solution *solution);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef __LOGGER_H__
+#define __LOGGER_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#include "config.h"
+
+/// @brief Appends a line to a file without waiting for the disk: the line is copied to the ring buffer of the calling thread
+///        and written later by the background thread of the logger, which keeps the files open. The logger is started at the
+///        first line and flushed when the program exits. When the ring is full the line is dropped (and counted), or the
+///        thread waits for room with LOGGER_BLOCK
+/// @param filename the file the line is appended to, created if needed
+/// @param format the format of the line, as for printf
+void logger_write(const char *filename, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/// @brief Waits until every line logged so far is written to its file
+void logger_flush(void);
+
+/// @brief Stops the logger: the lines logged so far are written, the files closed and the number of lines dropped reported
+void logger_stop(void);
+
+/// @brief Gets the number of lines dropped because the ring buffer of their thread was full
+/// @return the number of lines dropped
+long logger_dropped(void);
+
+#endif
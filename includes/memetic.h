@@ -0,0 +1,70 @@
+#ifndef __MEMETIC_H__
+#define __MEMETIC_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "cost.h"
+#include "anytime.h"
+
+/// @brief An individual of the population of the memetic engine: a full grid with its cost
+struct sudoku_individual
+{
+    int **lines;
+    int ***columns;
+    int ***regions;
+    int cost;
+};
+
+/// @brief The statistics of a run of the memetic engine
+struct memetic_stats
+{
+    int generations;   // number of generations made
+    double time;       // wall time of the run (seconds)
+    int best_cost;     // lowest cost of the population
+};
+
+/// @brief Allocates an individual with the content of the given grid
+/// @param sudoku_grid the given grid
+/// @param individual the individual to allocate
+/// @return false if the grids couldn't be allocated (nothing is left allocated), true otherwise
+bool sudoku_individual_create(int **sudoku_grid, struct sudoku_individual *individual);
+
+/// @brief Frees the grids of an individual
+/// @param individual the individual
+void sudoku_individual_free(struct sudoku_individual *individual);
+
+/// @brief Creates a child from two parents: each region (or each line) of the child is copied from one of the parents
+///        at random. The fixed cells are the same in both parents, so they stay intact in the child
+/// @param child the created child
+/// @param first the first parent
+/// @param second the second parent
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_crossover(struct sudoku_individual *child, struct sudoku_individual *first, struct sudoku_individual *second, unsigned int *seed);
+
+/// @brief Short simulated annealing of an individual with single cell changes, from the given temperature down to
+///        the stop temperature in MEMETIC_POLISH_STEPS temperature steps
+/// @param individual the individual to polish, its cost is updated
+/// @param model the cost model, with the starting grid used to find the non fixed cells
+/// @param start_temperature the temperature at the start of the polish
+/// @param stop_temperature the temperature at the end of the polish
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_polish(struct sudoku_individual *individual, struct cost_model *model, double start_temperature, double stop_temperature, unsigned int *seed);
+
+/// @brief Solves the sudoku with a population of grids: at each generation, children are created by crossover of parents
+///        chosen by tournament and polished by a short annealing in parallel, then the best distinct grids are kept
+/// @param model the cost model (unweighted), with the starting grid
+/// @param solution the best grid found
+/// @param seed the seed used in the pseudo random number generator
+/// @param start_temperature the calibrated start temperature of the annealing
+/// @param stop_temperature the calibrated stop temperature of the annealing
+/// @param verbose if the progress of the engine is printed
+/// @param watch the deadline of the run and its progress callback, looked at after each generation
+/// @param stats the statistics of the run
+/// @return the cost of the best grid found, -1 if the population couldn't be allocated
+int sudoku_memetic(struct cost_model *model, int **solution, unsigned int *seed, double start_temperature, double stop_temperature, bool verbose,
+                   struct anytime_watch *watch, struct memetic_stats *stats);
+
+#endif
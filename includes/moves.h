@@ -0,0 +1,137 @@
+#ifndef __MOVES_H__
+#define __MOVES_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "config.h"
+#include "cost.h"
+
+// the maximum number of cells changed by a single move
+#define MOVE_MAX_CELLS 4
+
+/// @brief A move changing the value of one or more cells of the grid, with the previous value of each cell so it can be undone
+struct sudoku_move
+{
+    int size;                    // number of cells changed by the move, 0 if no move could be made
+    int line[MOVE_MAX_CELLS];    // line index of each changed cell
+    int column[MOVE_MAX_CELLS];  // column index of each changed cell
+    int previous[MOVE_MAX_CELLS]; // value of each changed cell before the move
+};
+
+/// @brief The orders in which the single cell changes visit the non fixed cells of the grid
+enum sweep_order
+{
+    SWEEP_RANDOM,      // each change picks a random non fixed cell
+    SWEEP_SEQUENTIAL,  // sweeps over the non fixed cells line by line
+    SWEEP_BOX,         // sweeps over the non fixed cells region by region
+    SWEEP_PERMUTATION, // sweeps over the non fixed cells in a new random order at each sweep
+    SWEEP_ORDERS       // the number of orders
+};
+
+/// @brief The non fixed cells of the grid and the position of the current sweep over them
+struct cell_sweep
+{
+    enum sweep_order order;
+    int n;                  // number of non fixed cells
+    int cells[PUZZLE_SIZE]; // index (line * SUDOKU_SIZE + column) of each non fixed cell in the order of the sweep
+    int position;           // number of cells visited in the current sweep
+    int sweeps;             // number of sweeps done, counted every n cells for the random order
+};
+
+/// @brief Chooses a random cell from the sudoku grid. If i or j != -1 then the random cell chosen needs to be different
+///        from the previous cell chosen by the function. This is done to avoid repeated randomly chosen cells
+/// @param sudoku_grid the provided sudoku grid
+/// @param i the line index
+/// @param j the column index
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_get_random_cell(int **sudoku_grid, int *i, int *j, unsigned int *seed);
+
+/// @brief Initializes the sweep over the non fixed cells of the grid
+/// @param sweep the sweep
+/// @param order the order in which the cells are visited
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param seed the seed used in the pseudo random number generator
+void cell_sweep_init(struct cell_sweep *sweep, enum sweep_order order, int **original_grid, unsigned int *seed);
+
+/// @brief Rebuilds the sweep after cells were promoted to fixed cells, the number of sweeps done is kept
+/// @param sweep the sweep
+/// @param original_grid the grid of the fixed cells, used to find the non fixed cells
+/// @param seed the seed used in the pseudo random number generator
+void cell_sweep_update(struct cell_sweep *sweep, int **original_grid, unsigned int *seed);
+
+/// @brief Finds the sweep order corresponding to the given name
+/// @param name the name of the order (random, sequential, box or permutation)
+/// @param order the corresponding order
+/// @return true if the name is a known order, false otherwise
+bool sweep_order_parse(const char *name, enum sweep_order *order);
+
+/// @brief Gets the name of the given sweep order
+/// @param order the sweep order
+/// @return the name of the order
+const char *sweep_order_name(enum sweep_order order);
+
+/// @brief Chooses the next non fixed cell to change: a random one for the random order, the next cell of the sweep otherwise
+/// @param sweep the sweep
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param i the line index, the previous one on input (see sudoku_get_random_cell)
+/// @param j the column index, the previous one on input (see sudoku_get_random_cell)
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_sweep_cell(struct cell_sweep *sweep, int **original_grid, int *i, int *j, unsigned int *seed);
+
+/// @brief Prints the configuration of the sweep of the sudoku solving algorithm
+/// @param sweep the sweep
+void cell_sweep_print(struct cell_sweep *sweep);
+
+/// @brief Rotates the values of three random non fixed cells of a random region of the grid (a -> b -> c -> a).
+///        The values of the region stay the same, only the lines and columns of the cells are affected
+/// @param move the move made, to undo it if needed
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param seed the seed used in the pseudo random number generator
+/// @return the change of the cost of the grid made by the move
+int sudoku_move_cycle(struct sudoku_move *move, int **original_grid, int **lines, int ***columns, int ***regions, struct cost_model *model, unsigned int *seed);
+
+/// @brief Changes a random non fixed cell to a new random value, then repeatedly ejects a non fixed cell of the same line,
+///        column or region holding the value just placed and gives it its least conflicting value (up to CHAIN_LENGTH cells)
+/// @param move the move made, to undo it if needed
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param seed the seed used in the pseudo random number generator
+/// @return the change of the cost of the grid made by the move
+int sudoku_move_chain(struct sudoku_move *move, int **original_grid, int **lines, int ***columns, int ***regions, struct cost_model *model, unsigned int *seed);
+
+/// @brief Multiple-try Metropolis change of the given non fixed cell: the given number of new values are proposed and scored at once,
+///        one of them is chosen in proportion to its Boltzmann weight and accepted with the multiple-try acceptance ratio. The
+///        values are drawn among the candidates of the cell
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param candidates the values the cell may hold, as the bits 1 to SUDOKU_SIZE (DOMAIN_ALL without tightening the domains)
+/// @param tries the number of new values proposed, at most MULTIPLE_TRIES_MAX
+/// @param temperature the current temperature of the annealing
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param seed the seed used in the pseudo random number generator
+/// @param nb the new value chosen for the cell (the cell isn't modified)
+/// @param delta the change of the cost of the grid made by the new value
+/// @return true if the change is accepted, false otherwise
+bool sudoku_multiple_try(int line, int column, int candidates, int tries, double temperature, int **lines, int ***columns,
+                         int ***regions, struct cost_model *model, unsigned int *seed, int *nb, int *delta);
+
+/// @brief Undoes the given move, restoring the previous value of each changed cell
+/// @param move the move to undo
+/// @param lines 2D array containing each line of the sudoku grid
+void sudoku_move_undo(struct sudoku_move *move, int **lines);
+
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef __OPERATORS_H__
+#define __OPERATORS_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "config.h"
+
+/// @brief The kinds of moves (operators) proposed by the solving algorithm
+enum sudoku_operator
+{
+    OPERATOR_CHANGE, // a single non fixed cell gets a new random value
+    OPERATOR_CYCLE,  // the values of three non fixed cells of a region are rotated
+    OPERATOR_CHAIN,  // ejection chain across the lines, columns and regions
+    OPERATORS        // the number of operators
+};
+
+/// @brief The selection of the operator of each move, either with fixed probabilities or adaptive (probability matching):
+///        each operator is credited with the cost improvement it made per second of CPU time and the probabilities
+///        follow the credits of the operators, with a floor of ADAPTIVE_MIN_PROBABILITY so that none is abandoned
+struct operator_selector
+{
+    bool adaptive;
+    double probability[OPERATORS]; // probability of each operator to be chosen
+    double quality[OPERATORS];     // running average of the improvement per second of each operator (adaptive)
+
+    long uses[OPERATORS];     // number of uses of each operator since the last update
+    double gain[OPERATORS];   // cost improvement made by each operator since the last update
+    long timed[OPERATORS];    // number of timed uses of each operator
+    double time[OPERATORS];   // total CPU time of the timed uses of each operator
+    long total[OPERATORS];    // number of uses of each operator since the start
+};
+
+/// @brief Initializes the operator selector with the given starting probabilities
+/// @param selector the operator selector
+/// @param cycle_probability the probability of a move to rotate three cells of a region
+/// @param chain_probability the probability of a move to be an ejection chain
+/// @param adaptive if the probabilities are adapted during the run
+void operator_selector_init(struct operator_selector *selector, double cycle_probability, double chain_probability, bool adaptive);
+
+/// @brief Chooses the operator of the next move
+/// @param selector the operator selector
+/// @param seed the seed used in the pseudo random number generator
+/// @return the chosen operator
+enum sudoku_operator operator_select(struct operator_selector *selector, unsigned int *seed);
+
+/// @brief Tells if the next use of the given operator must be timed, only one use every ADAPTIVE_TIMING_PERIOD is timed
+/// @param selector the operator selector
+/// @param operator the operator
+/// @return true if the use must be timed
+bool operator_timed(struct operator_selector *selector, enum sudoku_operator operator);
+
+/// @brief Records the CPU time taken by a timed use of the given operator
+/// @param selector the operator selector
+/// @param operator the operator
+/// @param time the CPU time taken to propose and evaluate the move
+void operator_time(struct operator_selector *selector, enum sudoku_operator operator, double time);
+
+/// @brief Credits the given operator with the cost improvement made by its move (0 when the move was rejected)
+/// @param selector the operator selector
+/// @param operator the operator
+/// @param gain the decrease of the cost of the grid
+void operator_credit(struct operator_selector *selector, enum sudoku_operator operator, int gain);
+
+/// @brief Updates the probabilities of the operators from the credits since the last update (adaptive selection only)
+/// @param selector the operator selector
+void operator_selector_update(struct operator_selector *selector);
+
+/// @brief Gets the name of the given operator
+/// @param operator the operator
+/// @return the name of the operator
+const char *operator_name(enum sudoku_operator operator);
+
+/// @brief Prints the configuration of the operator selection of the sudoku solving algorithm
+/// @param selector the operator selector
+void operator_selector_print(struct operator_selector *selector);
+
+#endif
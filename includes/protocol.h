@@ -0,0 +1,125 @@
+#ifndef __PROTOCOL_H__
+#define __PROTOCOL_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+
+/// @brief The messages exchanged with the solver daemon over its UNIX socket. Each one is a frame: a header giving the size
+///        of the whole frame, then the body of its type. The daemon and its clients run on the same machine, the fields are
+///        in its byte order
+enum protocol_type
+{
+    PROTOCOL_SOLVE,    // a puzzle to solve (client)
+    PROTOCOL_STATS,    // a query of the counters of the daemon (client)
+    PROTOCOL_SOLUTION, // the outcome of the solving of a puzzle (daemon)
+    PROTOCOL_COUNTERS, // the counters of the daemon (daemon)
+    PROTOCOL_PROGRESS, // a grid of lower cost found while solving a puzzle, sent before its solution when asked for (daemon)
+    PROTOCOL_TYPES     // the number of types
+};
+
+/// @brief The header of a frame
+struct protocol_header
+{
+    uint32_t length; // the size of the whole frame, the header included
+    uint32_t type;   // the type of the message
+    uint32_t id;     // chosen by the client, the answer to a request carries the id of the request
+    uint32_t reserved;
+};
+
+// the flags of a puzzle to solve
+#define PROTOCOL_WITH_PROGRESS 1 // the grids of lower cost found are sent while solving the puzzle
+
+/// @brief A puzzle to solve
+struct protocol_solve
+{
+    double deadline;           // wall time budget of the solving (seconds), the best grid found is answered once spent,
+                               // 0 for the deadline of the daemon
+    uint32_t seed;             // the seed of the pseudo random number generator, the same seed makes the same run
+    uint32_t flags;            // PROTOCOL_WITH_PROGRESS or 0
+    char puzzle[PUZZLE_SIZE];  // 81 digits line by line, '0' or '.' for the empty cells (not null terminated)
+    uint8_t padding[7];
+};
+
+/// @brief The outcome of the solving of a puzzle
+struct protocol_solution
+{
+    int64_t moves;           // number of moves made by the annealing
+    double time;             // wall time of the solving (seconds)
+    int32_t cost;            // unweighted cost of the final grid
+    int32_t lowest_cost;     // lowest unweighted cost found during the run
+    int32_t tries;           // number of tries started (annealing)
+    int32_t generations;     // number of generations made (memetic engine)
+    uint8_t status;          // the outcome of the call of the library (enum libsudoku_status), the rest is 0 if it isn't ok
+    uint8_t solved;          // 1 if a grid of cost SOLUTION_COST was found
+    uint8_t cached;          // 1 if the solution was found in the solution cache
+    uint8_t expired;         // 1 if the deadline expired, the grid is the best one found
+    char grid[PUZZLE_SIZE];  // the grid found, digits '1' to '9' (not null terminated)
+    uint8_t padding[3];
+};
+
+/// @brief A grid of lower cost found while solving a puzzle
+struct protocol_progress
+{
+    int64_t moves;           // number of moves made by the annealing
+    double time;             // wall time since the start of the solving (seconds)
+    int32_t lowest_cost;     // unweighted cost of the grid
+    int32_t tries;           // number of tries started (annealing)
+    int32_t generations;     // number of generations made (memetic engine)
+    char grid[PUZZLE_SIZE];  // the grid, digits '1' to '9' (not null terminated)
+    uint8_t padding[3];
+};
+
+/// @brief The counters of the daemon since it started
+struct protocol_counters
+{
+    uint64_t requests;    // number of puzzles received
+    uint64_t answered;    // number of puzzles answered
+    uint64_t solved;      // number of puzzles solved (cost SOLUTION_COST)
+    uint64_t cached;      // number of puzzles answered from the solution cache
+    uint64_t errors;      // number of puzzles answered with an error (invalid puzzle, out of memory)
+    uint64_t dropped;     // number of answers lost with the connection of their client
+    double uptime;        // time since the start of the daemon (seconds)
+    double busy;          // time spent solving by the workers (seconds)
+    uint32_t workers;     // number of workers
+    uint32_t connections; // number of clients connected
+    uint32_t queued;      // number of puzzles waiting for a worker
+    uint32_t running;     // number of puzzles being solved
+};
+
+/// @brief A message, its header and the body of its type
+struct protocol_message
+{
+    struct protocol_header header;
+    union
+    {
+        struct protocol_solve solve;
+        struct protocol_solution solution;
+        struct protocol_counters counters;
+        struct protocol_progress progress;
+    } body;
+};
+
+/// @brief Starts a message of the given type, its header filled and its body zeroed
+/// @param message the message
+/// @param type the type of the message
+/// @param id the id of the message
+void protocol_message_init(struct protocol_message *message, enum protocol_type type, uint32_t id);
+
+/// @brief Parses the frame at the start of a buffer
+/// @param buffer the bytes received
+/// @param n the number of bytes received
+/// @param message the message parsed
+/// @return the size of the frame, 0 if the frame isn't complete yet, -1 if it isn't a valid frame
+long protocol_parse(const uint8_t *buffer, size_t n, struct protocol_message *message);
+
+/// @brief Sends the frame of a message on a blocking socket, a broken connection doesn't raise SIGPIPE
+/// @param fd the socket
+/// @param message the message
+/// @return false if the frame couldn't be sent whole (connection closed, send timeout), true otherwise
+bool protocol_send(int fd, const struct protocol_message *message);
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef __RESTART_H__
+#define __RESTART_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+
+#include "config.h"
+
+/// @brief The strategies deciding when a try of the solving algorithm is stopped and restarted
+enum restart_strategy
+{
+    RESTART_FIXED,     // each try goes down the whole temperature schedule
+    RESTART_LUBY,      // each try is RESTART_BASE times the next term of the Luby sequence temperature steps long
+    RESTART_GEOMETRIC, // each try is RESTART_FACTOR times longer than the previous one
+    RESTART_PLATEAU    // a try is stopped when its cost didn't improve for RESTART_PLATEAU_STEPS temperature steps
+};
+
+/// @brief The restart policy of the solving algorithm and the state of the current try
+struct restart_policy
+{
+    enum restart_strategy strategy;
+    int base;            // number of temperature steps of a unit try (luby and geometric strategies)
+    double factor;       // growth factor of the tries (geometric strategy)
+    int plateau;         // number of temperature steps without improvement before restarting (plateau strategy)
+    double perturbation; // fraction of the free cells of the best grid randomized at each restart (0 randomizes the whole grid)
+
+    int tries;     // number of tries started
+    int budget;    // number of temperature steps of the current try
+    int steps;     // number of temperature steps done in the current try
+    int best_cost; // lowest cost found during the current try
+    int stale;     // number of temperature steps since the last improvement of the current try
+};
+
+/// @brief Initializes the restart policy with the default settings from the configuration
+/// @param policy the restart policy
+/// @param strategy the restart strategy used
+/// @param perturbation fraction of the free cells of the best grid randomized at each restart
+void restart_policy_init(struct restart_policy *policy, enum restart_strategy strategy, double perturbation);
+
+/// @brief Finds the restart strategy corresponding to the given name
+/// @param name the name of the strategy (fixed, luby, geometric or plateau)
+/// @param strategy the corresponding strategy
+/// @return true if the name is a known strategy, false otherwise
+bool restart_strategy_parse(const char *name, enum restart_strategy *strategy);
+
+/// @brief Gets the name of the given restart strategy
+/// @param strategy the restart strategy
+/// @return the name of the strategy
+const char *restart_strategy_name(enum restart_strategy strategy);
+
+/// @brief Gets the i-th term of the Luby sequence (1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...)
+/// @param i the index of the term, starting at 1
+/// @return the i-th term of the sequence
+int luby(int i);
+
+/// @brief Starts a new try and computes its length
+/// @param policy the restart policy
+/// @param cost the cost of the grid at the start of the try
+/// @return the number of temperature steps of the try
+int restart_policy_start_try(struct restart_policy *policy, int cost);
+
+/// @brief Records a temperature step of the current try and decides if the try must be restarted
+/// @param policy the restart policy
+/// @param cost the cost of the grid at the end of the temperature step
+/// @return true if the current try must be stopped, false otherwise
+bool restart_policy_step(struct restart_policy *policy, int cost);
+
+/// @brief Prints the restart policy along with the configuration of the sudoku solving algorithm
+/// @param policy the restart policy
+void restart_policy_print(struct restart_policy *policy);
+
+#endif
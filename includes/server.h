@@ -0,0 +1,91 @@
+#ifndef __SERVER_H__
+#define __SERVER_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "solver.h"
+#include "protocol.h"
+
+/// @brief A client connected to the daemon
+struct server_connection
+{
+    int fd;                      // the socket, -1 if the slot is free
+    bool reading;                // false once the client closed its side or sent an invalid frame, its answers are still sent
+    bool broken;                 // if an answer couldn't be sent, the next ones are dropped
+    int pending;                 // the number of puzzles and queries of the client queued or being answered
+    pthread_mutex_t write_lock;  // a single answer is sent at a time on the socket
+    uint8_t input[SERVER_INPUT_SIZE]; // the bytes received and not parsed yet
+    size_t filled;               // the number of bytes received and not parsed yet
+};
+
+/// @brief A puzzle or a query of the counters waiting for a worker
+struct server_job
+{
+    struct server_connection *connection; // the client the answer is sent to
+    uint32_t id;                          // the id of the request
+    bool stats;                           // a query of the counters, answered by a worker too so the polling never blocks
+    uint32_t seed;                        // the seed of the solving
+    double deadline;                      // the wall time budget of the solving (seconds), 0 without one
+    bool progress;                        // if the grids of lower cost found are sent while solving
+    char puzzle[PUZZLE_SIZE + 1];         // the puzzle, null terminated
+};
+
+/// @brief The solver daemon: a thread polls the socket and the clients and queues their puzzles, a pool of workers solves
+///        them and sends the answers as soon as they are found, so a client can send many puzzles before reading the answers
+///        (pipelining). When the queue or the requests in flight of a client are full, its socket isn't read anymore and it
+///        blocks once the buffers of the socket are full (backpressure)
+struct sudoku_server
+{
+    const char *path;      // the path of the UNIX socket
+    int listener;          // the listening socket
+    int wake[2];           // written by the workers and the signal handler to wake up the polling thread
+    struct solver_options *options;
+    int workers;           // the number of workers
+    double start_time;     // when the daemon started
+
+    struct server_connection *connections; // SERVER_CONNECTIONS slots
+    struct server_job *queue;              // ring of SERVER_QUEUE requests waiting for a worker
+    int head;              // the position of the next puzzle of the queue
+    int queued;            // the number of requests in the queue
+
+    pthread_mutex_t lock;  // guards the queue, the puzzles pending of the clients and the counters
+    pthread_cond_t work;   // signaled when a puzzle is queued or the daemon stops
+    volatile sig_atomic_t stop; // set to stop the daemon
+    bool stopping;         // if the workers stop after their puzzle
+    int connected;         // the number of clients connected
+    int running;           // the number of puzzles being solved
+    struct protocol_counters counters;
+};
+
+/// @brief Opens the daemon: the UNIX socket is created at the given path (a socket left by a daemon that isn't running
+///        anymore is replaced), the program stops if it can't be
+/// @param server the daemon
+/// @param path the path of the socket
+/// @param options the settings of the solving algorithm, shared by the workers, their deadline is the one of the puzzles
+///        sent without one
+/// @param workers the number of workers
+void sudoku_server_open(struct sudoku_server *server, const char *path, struct solver_options *options, int workers);
+
+/// @brief Serves the clients until the daemon is stopped, the puzzles being solved are then answered and the queued ones dropped
+/// @param server the daemon
+void sudoku_server_run(struct sudoku_server *server);
+
+/// @brief Stops the daemon, can be called from a signal handler
+/// @param server the daemon
+void sudoku_server_stop(struct sudoku_server *server);
+
+/// @brief Gets the counters of the daemon
+/// @param server the daemon
+/// @param counters the counters
+void sudoku_server_counters(struct sudoku_server *server, struct protocol_counters *counters);
+
+/// @brief Closes the daemon: the clients are disconnected and the socket removed
+/// @param server the daemon
+void sudoku_server_close(struct sudoku_server *server);
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef __SINK_H__
+#define __SINK_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "bank.h"
+#include "solver.h"
+
+// identifies the binary result files and their version
+#define SINK_BINARY_MAGIC "SDKRES01"
+
+/// @brief The formats of the result files
+enum sink_format
+{
+    SINK_JSONL,  // one JSON object per line, appended
+    SINK_BINARY, // fixed-size records at the offset of the index of their puzzle, in a memory-mapped file
+    SINK_FORMATS // the number of formats
+};
+
+/// @brief The header of a binary result file, followed by the records
+struct sink_header
+{
+    char magic[8];        // SINK_BINARY_MAGIC
+    uint32_t record_size; // the size of a record, sizeof(struct sink_record)
+    uint32_t reserved;
+    uint64_t records;     // the number of records, one past the highest index written
+};
+
+/// @brief The result of a puzzle in a binary result file (96 bytes), a record never written is all zeros
+struct sink_record
+{
+    char hash[HASH_SIZE];            // the hash of the puzzle, not null terminated (padded with zeros)
+    uint8_t written;                 // 1 once the record is written
+    uint8_t solved;                  // 1 if a grid of cost SOLUTION_COST was found
+    uint8_t reserved[2];
+    int32_t cost;                    // unweighted cost of the final grid
+    int32_t best_cost;               // lowest unweighted cost found during the run
+    int32_t tries;                   // number of tries started (annealing)
+    int32_t generations;             // number of generations made (memetic engine)
+    int64_t moves;                   // number of moves made by the annealing
+    double time;                     // wall time of the solving (seconds)
+    uint8_t solution[RECORD_DIGITS]; // the digits of the final grid, two per byte (the first one in the high nibble)
+    uint8_t padding[7];
+};
+
+/// @brief A result file the result of each puzzle solved is written to, the writes are batched
+struct result_sink
+{
+    enum sink_format format;
+    int fd;
+
+    // JSONL format
+    char *buffer;    // the lines not written yet
+    size_t used;     // the size of the lines not written yet
+
+    // binary format
+    char *map;       // the mapping of the file, the header then the records
+    size_t capacity; // the number of records the mapping holds
+    long base;       // the number of records the file held when opened, the indexes of the puzzles start after them
+    long next;       // the index of the next record appended
+};
+
+/// @brief Finds the result format corresponding to the given name
+/// @param name the name of the format (jsonl or binary)
+/// @param format the corresponding format
+/// @return true if the name is a known format, false otherwise
+bool sink_format_parse(const char *name, enum sink_format *format);
+
+/// @brief Gets the name of the given result format
+/// @param format the result format
+/// @return the name of the format
+const char *sink_format_name(enum sink_format format);
+
+/// @brief Opens a result file, the results are appended to the ones it already holds
+/// @param sink the result sink
+/// @param filename the result file, created if needed
+/// @param format the format of the file
+void result_sink_open(struct result_sink *sink, const char *filename, enum sink_format format);
+
+/// @brief Writes the result of a puzzle: appended to the JSONL lines, or at the offset of its index in a binary file
+/// @param sink the result sink
+/// @param index the index of the puzzle (its position in the input, written after the records the file held when opened),
+///        -1 to append it after the results already written
+/// @param hash the hash of the puzzle
+/// @param result the outcome of the solving
+/// @param solution the grid found
+void result_sink_write(struct result_sink *sink, long index, const char *hash, struct solver_result *result, int **solution);
+
+/// @brief Writes the results batched so far to the file
+/// @param sink the result sink
+void result_sink_flush(struct result_sink *sink);
+
+/// @brief Flushes and closes a result file
+/// @param sink the result sink
+void result_sink_close(struct result_sink *sink);
+
+/// @brief Prints the records of a binary result file as JSONL
+/// @param filename the result file
+/// @param output the output the lines are written to
+/// @return the number of records printed, -1 if the file isn't a binary result file
+long result_sink_dump(const char *filename, FILE *output);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "config.h"
+
+/// @brief The last state of the run published by the solver, in a shared memory segment. The solver never waits for the
+///        viewers: it makes the sequence odd while writing and even again once done (seqlock), a viewer copies the state and
+///        copies it again if the sequence changed meanwhile
+struct sudoku_snapshot
+{
+    _Atomic uint32_t sequence;      // odd while the solver writes the state
+    int32_t pid;                    // the process of the run
+    double started;                 // the time the run started at (seconds since the epoch), tells the runs apart
+    uint8_t givens[PUZZLE_SIZE];    // the digits of the puzzle, 0 for an empty cell
+    uint8_t grid[PUZZLE_SIZE];      // the digits of the current grid
+    int32_t cost;                   // the cost of the current grid
+    int32_t lowest_cost;            // the lowest unweighted cost found, negative before the end of the first try
+    int32_t tries;                  // the number of the current try
+    int32_t finished;               // 1 once the run is over
+    int32_t solved;                 // 1 if a solution was found
+    double temperature;             // the current temperature
+    int64_t moves;                  // the number of moves made
+    double time;                    // the wall time of the run so far (seconds)
+    uint64_t published;             // the number of states published
+};
+
+/// @brief The shared memory segment the solver publishes the state of its run to
+struct snapshot_channel
+{
+    struct sudoku_snapshot *snapshot; // the mapping of the segment, NULL if it couldn't be created
+    double start;                     // the time the run started at (omp_get_wtime)
+    double last;                      // the time of the last state published (omp_get_wtime)
+};
+
+/// @brief Creates the shared memory segment of the run, replacing the one of a previous run
+/// @param channel the channel
+/// @param original_grid the grid of the puzzle
+/// @return true if the segment was created, the run isn't shown otherwise
+bool snapshot_channel_open(struct snapshot_channel *channel, int **original_grid);
+
+/// @brief Publishes the state of the run, at most SNAPSHOT_RATE times per second unless forced. The solver only calls it
+///        every SNAPSHOT_CHECK_PERIOD moves, so it pays nothing between two states
+/// @param channel the channel
+/// @param lines the current grid
+/// @param cost the cost of the grid
+/// @param lowest_cost the lowest unweighted cost found
+/// @param tries the number of the current try
+/// @param temperature the current temperature
+/// @param moves the number of moves made
+/// @param force if the state is published whatever the time of the last one
+void snapshot_publish(struct snapshot_channel *channel, int **lines, int cost, int lowest_cost, int tries, double temperature,
+                      long long moves, bool force);
+
+/// @brief Publishes the final state of the run and removes the segment, the viewers attached keep the last state
+/// @param channel the channel
+/// @param lines the final grid
+/// @param cost the unweighted cost of the grid
+/// @param lowest_cost the lowest unweighted cost found
+/// @param solved if a solution was found
+/// @param moves the number of moves made
+void snapshot_channel_close(struct snapshot_channel *channel, int **lines, int cost, int lowest_cost, bool solved, long long moves);
+
+/// @brief Attaches to the shared memory segment of the current run
+/// @return the mapping of the segment (read only), NULL if no run is shown
+const struct sudoku_snapshot *snapshot_attach(void);
+
+/// @brief Detaches from the shared memory segment of a run
+/// @param snapshot the mapping of the segment
+void snapshot_detach(const struct sudoku_snapshot *snapshot);
+
+/// @brief Copies a consistent state of the run, retrying while the solver writes it
+/// @param snapshot the mapping of the segment
+/// @param copy the state copied
+void snapshot_read(const struct sudoku_snapshot *snapshot, struct sudoku_snapshot *copy);
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef __SOLVER_H__
+#define __SOLVER_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <signal.h>
+
+#include "config.h"
+#include "restart.h"
+#include "cost.h"
+#include "moves.h"
+#include "operators.h"
+#include "initializer.h"
+#include "trace.h"
+#include "cache.h"
+#include "anytime.h"
+
+/// @brief The settings of the sudoku solving algorithm, given by the flags of the programs
+struct solver_options
+{
+    bool verbose;    // if the progress of the solving is printed
+    bool quiet;      // if nothing is printed nor logged (configuration, solutions found, stats), to solve several puzzles at once
+    bool weighting;  // if the constraints of each line, column and region are weighted (breakout)
+    bool adaptive;   // if the probabilities of the moves are adapted during the run
+    bool memetic;    // if the memetic engine replaces the restarts of the annealing
+    bool tightening; // if the candidates of the cells are tightened and the forced cells promoted during the run
+    enum restart_strategy strategy;
+    enum cost_function cost_function;
+    enum sudoku_initializer initializer;
+    enum sweep_order sweep_order;
+    double perturbation;      // fraction of the cells of the best grid randomized at each restart
+    double cycle_probability; // probability of a move to rotate three cells of a region
+    double chain_probability; // probability of a move to be an ejection chain
+    int multiple_tries;       // number of new values proposed at once for a cell
+    struct trace_writer *trace; // the trace the annealing is recorded to, NULL if not traced
+    struct solution_cache *cache; // the solutions of the puzzles already solved, NULL without cache
+    const char *checkpoint;       // the file the state of the run is saved to between two tries, NULL without checkpoints
+    bool resume;                  // if the run goes on from the state saved in the checkpoint file (when there is one)
+    volatile sig_atomic_t *interrupted; // set (by a signal handler) to save the run and stop it at the end of the try, NULL if never
+    double deadline;                    // wall time budget of the solving (seconds), the best grid found is returned once spent, 0 without one
+    solver_progress_callback progress;  // called each time a grid of lower cost is found, NULL without callback
+    void *progress_data;                // given to the progress callback
+};
+
+/// @brief The outcome of the solving of a puzzle
+struct solver_result
+{
+    bool solved;                    // if a grid of cost SOLUTION_COST was found
+    bool cached;                    // if the solution was found in the solution cache, without annealing
+    bool interrupted;               // if the run was stopped before its end, its state saved in the checkpoint file
+    bool expired;                   // if the run was stopped by its deadline, the grid found is the best one found so far
+    int cost;                       // unweighted cost of the final grid
+    int lowest_cost;                // lowest unweighted cost found during the run
+    int tries;                      // number of tries started (annealing)
+    int generations;                // number of generations made (memetic engine)
+    long long moves;                // number of moves made by the annealing
+    double sweeps;                  // number of sweeps over the non fixed cells
+    double time;                    // wall time of the solving (seconds)
+    bool adaptive;                  // if the probabilities of the moves were learned
+    double probability[OPERATORS];  // probabilities of the moves at the end of the run
+};
+
+/// @brief Initializes the options with the default settings from the configuration
+/// @param options the options
+void solver_options_init(struct solver_options *options);
+
+/// @brief Calibrates the start and stop temperatures of the annealing from the given (randomized) grid.
+///        Random cell changes are sampled without being applied and the uphill cost deltas are kept, the start temperature
+///        is then refined until the uphill moves are accepted with a START_ACCEPTANCE rate on average and the stop temperature
+///        is the one where the smallest uphill move is only accepted with a STOP_ACCEPTANCE rate
+/// @param model the cost model, with the starting grid used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param seed the seed used in the pseudo random number generator
+/// @param start_temperature the calibrated start temperature
+/// @param stop_temperature the calibrated stop temperature
+void sudoku_calibrate_temperature(struct cost_model *model, int **lines, int ***columns, int ***regions, unsigned int *seed,
+                                  double *start_temperature, double *stop_temperature);
+
+/// @brief Solves a puzzle with the simulated annealing (or the memetic engine). Only the given grids and seed are used,
+///        so several puzzles can be solved at once by different threads. With a solution cache, a puzzle equivalent to one
+///        already solved is answered from it without annealing, and the new solutions found are added to it.
+///        With a checkpoint file, the state of the annealing is saved every CHECKPOINT_INTERVAL seconds between two tries,
+///        and when the run is interrupted, so that a resumed run makes the very same moves as the uninterrupted one would have
+/// @param original_grid the grid of the puzzle, its empty cells are 0
+/// @param puzzle_hash the hash of the puzzle, used to name the stats files
+/// @param options the settings of the solving algorithm
+/// @param solution the grid found at the end of the run, allocated by the caller
+/// @param seed the seed used in the pseudo random number generator
+/// @param result the outcome of the solving
+/// @return the unweighted cost of the grid found, -1 if the grids of the run couldn't be allocated (the memory allocated by the
+///         call is freed and the solution is left as it is)
+int sudoku_solve(int **original_grid, char *puzzle_hash, struct solver_options *options, int **solution, unsigned int *seed,
+                 struct solver_result *result);
+
+#endif
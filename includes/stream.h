@@ -0,0 +1,90 @@
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "solver.h"
+#include "decoder.h"
+#include "sink.h"
+
+/// @brief A puzzle of the stream with its solution once solved
+struct stream_puzzle
+{
+    long sequence;                             // the position of the puzzle in the stream, from 0
+    char hash[HASH_SIZE + 1];                  // the hash of the puzzle, its position in the stream (from 1) if it has none
+    int grid[SUDOKU_SIZE][SUDOKU_SIZE];        // the grid of the puzzle, its empty cells are 0
+    int solution[SUDOKU_SIZE][SUDOKU_SIZE];    // the grid found
+    struct solver_result result;               // the outcome of the solving
+    bool done;                                 // if the puzzle is solved and waits for the previous ones to be written
+};
+
+/// @brief A stream of puzzles solved by several threads: the puzzles are read one after the other, solved in parallel and
+///        their solutions written as soon as they are found (or in the order of the puzzles, once the previous ones are written)
+struct sudoku_stream
+{
+    FILE *input;
+    FILE *output;
+    enum compression compression; // the compression of the input, decoded on a background thread
+    struct stream_decoder decoder;
+    bool binary;         // if the puzzles are records of a binary bank, lines of text otherwise
+    long records;        // the number of records left in a binary stream
+    long line;           // the number of lines read from a text stream
+    char first[LINE_SIZE * 2]; // the first line of a text stream, read while looking for the header of a binary bank
+    bool pending;        // if the first line is still to be parsed
+
+    struct solver_options *options;
+    struct result_sink *sink; // the result file each solution is written to as well, NULL if none
+    unsigned int seed;   // the seed the seeds of the puzzles are made from
+    bool ordered;        // if the solutions are written in the order of the puzzles
+    int window;          // the maximum number of puzzles read and not written yet, when ordered
+    struct stream_puzzle *slots; // the puzzles read and not written yet, by sequence modulo the window, when ordered
+
+    pthread_mutex_t lock;  // guards the input, the output and the counters
+    pthread_cond_t space;  // signaled when a puzzle is written, so a new one can be read
+    bool end;              // if the input is exhausted
+    long read;             // the number of puzzles read
+    long written;          // the number of puzzles written
+    long solved;           // the number of puzzles solved (cost SOLUTION_COST)
+    long invalid;          // the number of records skipped
+};
+
+/// @brief Opens a stream of puzzles: lines of 81 digits ('0' or '.' for the empty cells), lines of the text bank format
+///        (hash, puzzle and rating) or a binary bank, found from the start of the input, which may be gzip or zstd compressed
+/// @param stream the stream
+/// @param input the input the puzzles are read from
+/// @param output the output the solutions are written to
+/// @param options the settings of the solving algorithm
+/// @param ordered if the solutions are written in the order of the puzzles
+/// @param window the maximum number of puzzles read and not written yet, when ordered
+/// @param seed the seed the seeds of the puzzles are made from
+/// @param sink the result file each solution is written to as well, at the index of its puzzle, NULL if none
+void sudoku_stream_open(struct sudoku_stream *stream, FILE *input, FILE *output, struct solver_options *options, bool ordered,
+                        int window, unsigned int seed, struct result_sink *sink);
+
+/// @brief Closes a stream of puzzles, the input and output aren't closed
+/// @param stream the stream
+/// @return true if the input was decoded without error (always true if it isn't compressed)
+bool sudoku_stream_close(struct sudoku_stream *stream);
+
+/// @brief Reads the next valid puzzle of the stream, the invalid records are skipped with a warning
+/// @param stream the stream
+/// @param puzzle the puzzle read
+/// @return true if a puzzle was read, false at the end of the input
+bool sudoku_stream_read(struct sudoku_stream *stream, struct stream_puzzle *puzzle);
+
+/// @brief Writes the solution of a puzzle on a line: the hash of the puzzle, the grid found, its cost and the solving time
+/// @param stream the stream
+/// @param puzzle the solved puzzle
+void sudoku_stream_write(struct sudoku_stream *stream, struct stream_puzzle *puzzle);
+
+/// @brief Solves every puzzle of the stream with the given number of threads, each one solving a puzzle at a time
+/// @param stream the stream
+/// @param threads the number of threads
+/// @return the number of puzzles solved (cost SOLUTION_COST)
+long sudoku_stream_solve(struct sudoku_stream *stream, int threads);
+
+#endif
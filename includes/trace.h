@@ -0,0 +1,176 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "bank.h"
+#include "moves.h"
+
+// identifies the trace files and their version
+#define TRACE_MAGIC "SDKTRC01"
+// the largest size of an event (a whole grid)
+#define TRACE_EVENT_SIZE 96
+
+// the settings of the run which make its costs differ from the unweighted cost of the grid
+#define TRACE_WEIGHTED 0x1  // the constraints are weighted
+#define TRACE_TIGHTENED 0x2 // cells are promoted to fixed cells by the domains
+
+/// @brief What a trace records of the annealing
+enum trace_level
+{
+    TRACE_SAMPLED,  // a snapshot of the grid every TRACE_SAMPLE_PERIOD moves, and the temperature steps
+    TRACE_ACCEPTED, // every accepted move, any grid of the run can be rebuilt
+    TRACE_COMPLETE, // every move, accepted or rejected
+    TRACE_LEVELS    // the number of levels
+};
+
+/// @brief The events of a trace. Each one is a tag byte (the event, the acceptance of a move and its number of cells),
+///        the number of moves since the previous event as a varint, then its content
+enum trace_event
+{
+    TRACE_TRY = 1,     // start of a try: its number, the whole grid and its cost
+    TRACE_GRID,        // the whole grid and its cost (sampled snapshot, or cells promoted by the domains)
+    TRACE_MOVE,        // the cells of a move with their new values, then the change of the cost
+    TRACE_TEMPERATURE, // the new temperature (float)
+    TRACE_COST,        // the new cost of the grid (the weights of the constraints were raised)
+    TRACE_END          // the end of the run: the unweighted cost of the final grid
+};
+
+/// @brief The header of a trace file, followed by the events
+struct trace_header
+{
+    char magic[8];                 // TRACE_MAGIC
+    uint32_t level;                // the trace level
+    uint32_t seed;                 // the seed of the run
+    uint32_t cost_function;        // the cost function of the annealing
+    uint32_t sample_period;        // the number of moves between two snapshots (sampled level)
+    uint32_t flags;                // TRACE_WEIGHTED and TRACE_TIGHTENED
+    uint8_t givens[RECORD_DIGITS]; // the digits of the puzzle, two per byte (the first one in the high nibble), 0 for an empty cell
+    uint8_t reserved[11];
+};
+
+/// @brief A trace file being written, the events are buffered and written in large blocks
+struct trace_writer
+{
+    FILE *fp;
+    enum trace_level level;
+    unsigned char *buffer; // the events not written yet
+    size_t used;           // the size of the events not written yet
+    long long moves;       // the number of moves made
+    long long last;        // the number of moves made at the previous event
+    long long sample;      // the number of moves made at the previous snapshot (sampled level)
+    bool failed;           // if a write failed, the next events are dropped
+};
+
+/// @brief A trace file being read, event by event
+struct trace_reader
+{
+    FILE *fp;
+    struct trace_header header;
+    long long moves; // the number of moves made at the last event read
+};
+
+/// @brief An event read from a trace file
+struct trace_record
+{
+    enum trace_event event;
+    long long moves;                       // the number of moves made when the event happened
+    bool accepted;                         // if the move is accepted (move)
+    int n;                                 // the number of cells of the move (move)
+    int line[MOVE_MAX_CELLS];              // the line index of each cell (move)
+    int column[MOVE_MAX_CELLS];            // the column index of each cell (move)
+    int value[MOVE_MAX_CELLS];             // the new value of each cell (move)
+    int delta;                             // the change of the cost (move)
+    int cost;                              // the cost of the grid (try, grid, cost and end)
+    int try;                               // the number of the try (try)
+    double temperature;                    // the new temperature (temperature)
+    int grid[SUDOKU_SIZE][SUDOKU_SIZE];    // the whole grid (try and grid)
+};
+
+/// @brief Finds the trace level corresponding to the given name
+/// @param name the name of the level (sampled, accepted or complete)
+/// @param level the corresponding level
+/// @return true if the name is a known level, false otherwise
+bool trace_level_parse(const char *name, enum trace_level *level);
+
+/// @brief Gets the name of the given trace level
+/// @param level the trace level
+/// @return the name of the level
+const char *trace_level_name(enum trace_level level);
+
+/// @brief Creates a trace file
+/// @param trace the trace
+/// @param filename the trace file
+/// @param level what the trace records
+/// @return false if the file or its buffer couldn't be created (nothing is left open), true otherwise
+bool trace_open(struct trace_writer *trace, const char *filename, enum trace_level level);
+
+/// @brief Writes the header of the trace, at the start of the run
+/// @param trace the trace
+/// @param original_grid the grid of the puzzle
+/// @param seed the seed of the run
+/// @param cost_function the cost function of the annealing
+/// @param flags TRACE_WEIGHTED and TRACE_TIGHTENED
+void trace_begin(struct trace_writer *trace, int **original_grid, unsigned int seed, int cost_function, unsigned int flags);
+
+/// @brief Records the start of a try
+/// @param trace the trace
+/// @param try the number of the try
+/// @param lines the starting grid of the try
+/// @param cost the cost of the grid
+void trace_try(struct trace_writer *trace, int try, int **lines, int cost);
+
+/// @brief Records the whole grid, after cells were changed outside of the moves
+/// @param trace the trace
+/// @param lines the grid
+/// @param cost the cost of the grid
+void trace_grid(struct trace_writer *trace, int **lines, int cost);
+
+/// @brief Records a move, before it is undone if rejected: the cells hold their new values. Only the accepted moves are
+///        needed to rebuild the grids, the sampled level only keeps a snapshot of the grid once in a while
+/// @param trace the trace
+/// @param lines the grid, with the cells of the move changed
+/// @param n the number of cells of the move
+/// @param line the line index of each cell
+/// @param column the column index of each cell
+/// @param accepted if the move is accepted
+/// @param delta the change of the cost made by the move
+/// @param cost the cost of the grid once the move is accepted or undone
+void trace_move(struct trace_writer *trace, int **lines, int n, const int *line, const int *column, bool accepted, int delta, int cost);
+
+/// @brief Records a new temperature
+/// @param trace the trace
+/// @param temperature the temperature
+void trace_temperature(struct trace_writer *trace, double temperature);
+
+/// @brief Records a new cost of the grid, when the weights of the constraints were raised
+/// @param trace the trace
+/// @param cost the cost
+void trace_cost(struct trace_writer *trace, int cost);
+
+/// @brief Records the end of the run and closes the trace file
+/// @param trace the trace
+/// @param cost the unweighted cost of the final grid
+void trace_close(struct trace_writer *trace, int cost);
+
+/// @brief Opens a trace file and reads its header
+/// @param reader the trace being read
+/// @param filename the trace file
+/// @return true if the file is a trace, false otherwise
+bool trace_reader_open(struct trace_reader *reader, const char *filename);
+
+/// @brief Reads the next event of a trace
+/// @param reader the trace being read
+/// @param record the event read
+/// @return true if an event was read, false at the end of the trace or if it is truncated
+bool trace_read(struct trace_reader *reader, struct trace_record *record);
+
+/// @brief Closes a trace file being read
+/// @param reader the trace being read
+void trace_reader_close(struct trace_reader *reader);
+
+#endif
@@ -40,6 +40,32 @@ int get_bound_random(unsigned int *seed, unsigned int lBound, unsigned int uBoun
 /// @return 
 int **read_sudoku_file(char *filename, size_t sudoku_dimension, char *puzzle_hash);
 
+/// @brief Returns a 2D array containing each region in order (from left to right)
+/// Each value points to the values in the provided array
+/// @param sudoku_grid the provided array
+/// @return An integer array containing every region of the sudoku grid in a 1D array for each region block, NULL if the memory
+///         couldn't be allocated
+int ***create_sudoku_region(int **sudoku_grid);
+
+/// @brief Returns a deep copy of the provided sudoku grid, structured with lines
+/// @param sudoku_grid the provided array
+/// @return the copy of the grid, NULL if the memory couldn't be allocated
+int **create_sudoku_lines(int **sudoku_grid);
+
+/// @brief Returns a 2D array containing each column of the sudoku grid in order (from left to right)
+/// Each value points to the values in the provided array
+/// @param sudoku_grid the provided array
+/// @return the columns of the grid, NULL if the memory couldn't be allocated
+int ***create_sudoku_columns(int **sudoku_grid);
+
+/// @brief Frees memory from each line and the sudoku grid itself
+/// @param sudoku_grid
+void sudoku_free(int **sudoku_grid);
+
+/// @brief Frees memory from each line and the sudoku grid of pointers itself
+/// @param sudoku_grid
+void sudoku_free_pointers(int ***sudoku_grid);
+
 /// @brief Prints a sudoku grid from a 2D array, assuming the 2D grid is structured with lines and columns
 /// @param sudoku_grid the provided sudoku grid
 void print_sudoku(int **sudoku_grid);
@@ -53,6 +79,13 @@ void print_sudoku_pointers(int ***sudoku_grid);
 /// @param seed the randomization seed used
 void sudoku_randomize(int ***sudoku_grid, int ** original_grid, unsigned int * seed);
 
+/// @brief Randomize a fraction of the non fixed cells of the given sudoku grid with new random values between 1 and 9
+/// @param sudoku_grid the given sudoku grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param fraction the fraction of the non fixed cells to randomize, between 0 and 1
+/// @param seed the randomization seed used
+void sudoku_perturb(int ***sudoku_grid, int ** original_grid, double fraction, unsigned int * seed);
+
 /// @brief Copies the content of a sudoku grid into another
 /// @param sudoku_grid the grid to modify the content of
 /// @param content the content to copy
@@ -65,6 +98,21 @@ void sudoku_copy_content(int ***sudoku_grid, int **content);
 /// @param date
 void sudoku_write_stats(char * filename, int score, int n_try, char * date);
 
+/// @brief Utility function to record the calibrated temperatures of the algorithm at the top of the statistics file
+/// @param filename the file in question, is created if doesn't exist yet. We assume it corresponds to the sudoku hash
+/// @param start_temperature the start temperature of each try
+/// @param stop_temperature the temperature at which each try stops
+/// @param date 
+void sudoku_write_calibration(char * filename, double start_temperature, double stop_temperature, char * date);
+
+/// @brief Utility function to append the probability of each kind of move learned during a try to a file
+/// @param filename the file in question, is created if doesn't exist yet. We assume it corresponds to the sudoku hash
+/// @param n_try the current try number
+/// @param probabilities the probability of each kind of move
+/// @param n the number of kinds of moves
+/// @param date 
+void sudoku_write_operators(char * filename, int n_try, double * probabilities, int n, char * date);
+
 /// @brief Utility function to debug the output of the sudoku solving algorithm
 /// @param filename 
 /// @param info 
@@ -72,7 +120,9 @@ void sudoku_write_stats(char * filename, int score, int n_try, char * date);
 void sudoku_debug_output(char * filename, char * info, char * date);
 
 /// @brief Prints the current configuration of the sudoku solving alogrithm
-void print_config();
+/// @param start_temperature the start temperature used by the algorithm
+/// @param stop_temperature the stop temperature used by the algorithm
+void print_config(double start_temperature, double stop_temperature);
 
 void print_sudoku_grid(int sudoku_grid[][SUDOKU_SIZE]);
 
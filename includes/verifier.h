@@ -0,0 +1,49 @@
+#ifndef __VERIFIER_H__
+#define __VERIFIER_H__
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+
+/// @brief The outcome of the verification of a solution against its puzzle
+enum verify_outcome
+{
+    VERIFY_VALID,   // a complete grid, valid and agreeing with the givens
+    VERIFY_DIGITS,  // a cell of the solution doesn't hold a digit from 1 to 9
+    VERIFY_GIVENS,  // a given of the puzzle is changed by the solution
+    VERIFY_UNITS,   // a digit is twice in a line, a column or a region
+    VERIFY_OUTCOMES // the number of outcomes
+};
+
+/// @brief Gets the name of the given outcome
+/// @param outcome the outcome
+/// @return the name of the outcome
+const char *verify_outcome_name(enum verify_outcome outcome);
+
+/// @brief Verifies a solution against its puzzle: the digits and the givens are compared 16 cells at once, then the digits
+///        of each cell are turned into bits and the bits of the lines, the columns and the regions are OR-ed together, every
+///        unit of a valid grid holding the 9 bits
+/// @param puzzle the digits of the puzzle, line by line, 0 for an empty cell
+/// @param solution the digits of the solution, line by line
+/// @return the outcome of the verification
+enum verify_outcome sudoku_verify(const uint8_t *puzzle, const uint8_t *solution);
+
+/// @brief Verifies a solution against its puzzle, both with their digits packed two per byte (the first one in the high
+///        nibble) as in the records of the banks, the result files and the solution cache
+/// @param puzzle the packed digits of the puzzle
+/// @param solution the packed digits of the solution
+/// @return the outcome of the verification
+enum verify_outcome sudoku_verify_packed(const uint8_t *puzzle, const uint8_t *solution);
+
+/// @brief Verifies a batch of solutions against their puzzles, spread over the threads
+/// @param puzzles the digits of the puzzles, PUZZLE_SIZE bytes each
+/// @param solutions the digits of the solutions, PUZZLE_SIZE bytes each
+/// @param n the number of solutions
+/// @param outcomes the outcome of each verification
+/// @return the number of valid solutions
+long sudoku_verify_batch(const uint8_t *puzzles, const uint8_t *solutions, size_t n, enum verify_outcome *outcomes);
+
+#endif
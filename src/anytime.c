@@ -0,0 +1,52 @@
+#include <omp.h>
+
+#include "anytime.h"
+
+/// @brief Starts watching a run
+/// @param watch the watch
+/// @param budget the wall time budget of the solving (seconds), 0 without deadline
+/// @param progress the progress callback, NULL without callback
+/// @param data given to the callback
+void anytime_watch_init(struct anytime_watch *watch, double budget, solver_progress_callback progress, void *data)
+{
+    watch->active = (budget > 0 || progress != NULL);
+    watch->start_time = omp_get_wtime();
+    watch->deadline = (budget > 0) ? watch->start_time + budget : 0;
+    watch->progress = progress;
+    watch->data = data;
+    watch->lowest_cost = -1;
+    watch->expired = false;
+}
+
+/// @brief Compares the cost of a grid to the lowest one found so far, and reports it to the progress callback if it is lower
+/// @param watch the watch
+/// @param cost the unweighted cost of the grid
+/// @param grid the grid
+/// @param tries the number of tries started
+/// @param generations the number of generations made
+/// @param moves the number of moves made
+/// @return true if the grid is the best one found so far, the caller keeps it
+bool anytime_watch_improved(struct anytime_watch *watch, int cost, int **grid, int tries, int generations, long long moves)
+{
+    if (!watch->active || (watch->lowest_cost != -1 && cost >= watch->lowest_cost))
+        return false;
+    watch->lowest_cost = cost;
+
+    if (watch->progress != NULL)
+    {
+        struct solver_progress progress = {.lowest_cost = cost, .tries = tries, .generations = generations, .moves = moves,
+                                           .time = omp_get_wtime() - watch->start_time, .grid = grid};
+        watch->progress(&progress, watch->data);
+    }
+    return true;
+}
+
+/// @brief Finds if the deadline of the run expired
+/// @param watch the watch
+/// @return true once the deadline expired
+bool anytime_watch_expired(struct anytime_watch *watch)
+{
+    if (!watch->expired && watch->deadline > 0 && omp_get_wtime() >= watch->deadline)
+        watch->expired = true;
+    return watch->expired;
+}
@@ -0,0 +1,652 @@
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bank.h"
+
+/// @brief Compares two entries of the index of a bank by hash
+/// @param a the first entry
+/// @param b the second entry
+/// @return the order of the entries
+static int bank_entry_compare(const void *a, const void *b)
+{
+    return memcmp(((const struct bank_entry *)a)->hash, ((const struct bank_entry *)b)->hash, HASH_SIZE);
+}
+
+/// @brief Adds the records of a bank from the given offset to its index, up to the last complete line, or to the end of
+///        the bank when it is complete
+/// @param data the content of the bank
+/// @param size the size of the content
+/// @param offset the offset of the first record to add
+/// @param complete if the content is the whole bank, the last record may have no linefeed
+/// @param entries the entries of the index, grown as needed
+/// @param n the number of entries of the index
+/// @param capacity the number of entries allocated
+/// @return the offset of the first record not added
+static size_t bank_index_records(const char *data, size_t size, size_t offset, bool complete, struct bank_entry **entries,
+                                 size_t *n, size_t *capacity)
+{
+    while (offset < size)
+    {
+        const char *end = memchr(data + offset, '\n', size - offset);
+        if (end == NULL && !complete)
+            break;
+        size_t length = (end != NULL) ? (size_t)(end - (data + offset)) : size - offset;
+
+        if (length > HASH_SIZE)
+        {
+            if (*n == *capacity)
+            { // the records are shorter than LINE_SIZE
+                *capacity *= 2;
+                if ((*entries = (struct bank_entry *)realloc(*entries, sizeof(struct bank_entry) * *capacity)) == NULL)
+                {
+                    fprintf(stderr, "ERROR: Out of memory!!\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            memcpy((*entries)[*n].hash, data + offset, HASH_SIZE);
+            (*entries)[*n].length = (uint32_t)length;
+            (*entries)[*n].offset = offset;
+            (*n)++;
+        }
+        offset += length + 1;
+    }
+    return offset;
+}
+
+/// @brief Builds the index of a memory-mapped bank: the hash and offset of each record, sorted by hash
+/// @param data the content of the bank
+/// @param size the size of the bank
+/// @param n the number of entries of the index
+/// @return the entries of the index, allocated
+struct bank_entry *puzzle_bank_build_index(const char *data, size_t size, size_t *n)
+{
+    size_t capacity = size / LINE_SIZE + 1;
+    struct bank_entry *entries = (struct bank_entry *)malloc(sizeof(struct bank_entry) * capacity);
+    if (entries == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    *n = 0;
+    bank_index_records(data, size, 0, true, &entries, n, &capacity);
+    qsort(entries, *n, sizeof(struct bank_entry), bank_entry_compare);
+    return entries;
+}
+
+/// @brief Maps the sidecar index of a bank if it is up to date with the bank
+/// @param bank the puzzle bank
+/// @param index_filename the file of the sidecar index
+/// @param status the status of the bank file
+/// @return true if the index was mapped, false otherwise
+static bool puzzle_bank_map_index(struct puzzle_bank *bank, const char *index_filename, struct stat *status)
+{
+    struct stat index_status;
+    int fd = open(index_filename, O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    if (fstat(fd, &index_status) == -1 || (size_t)index_status.st_size < sizeof(struct bank_index_header))
+    {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, index_status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    const struct bank_index_header *header = (const struct bank_index_header *)map;
+    if (memcmp(header->magic, BANK_INDEX_MAGIC, sizeof(header->magic)) != 0 || header->size != (uint64_t)status->st_size ||
+        header->mtime != (int64_t)status->st_mtime ||
+        header->entries > ((size_t)index_status.st_size - sizeof(struct bank_index_header)) / sizeof(struct bank_entry) ||
+        sizeof(struct bank_index_header) + header->entries * sizeof(struct bank_entry) != (size_t)index_status.st_size)
+    { // the bank changed since the index was built
+        munmap(map, index_status.st_size);
+        return false;
+    }
+
+    bank->index_map = map;
+    bank->index_size = index_status.st_size;
+    bank->entries = (const struct bank_entry *)((const char *)map + sizeof(struct bank_index_header));
+    bank->n = header->entries;
+    return true;
+}
+
+/// @brief Writes the sidecar index of a bank, to a temporary file renamed once complete so a concurrent run never reads
+///        a partial index
+/// @param index_filename the file of the sidecar index
+/// @param entries the entries of the index
+/// @param n the number of entries of the index
+/// @param status the status of the bank file
+static void puzzle_bank_write_index(const char *index_filename, const struct bank_entry *entries, size_t n, struct stat *status)
+{
+    char temp_filename[FILE_SIZE + 32];
+    snprintf(temp_filename, sizeof(temp_filename), "%s.%d", index_filename, (int)getpid());
+
+    FILE *fp = fopen(temp_filename, "wb");
+    if (!fp)
+        return; // read-only directory, the index stays in memory
+
+    struct bank_index_header header;
+    memcpy(header.magic, BANK_INDEX_MAGIC, sizeof(header.magic));
+    header.size = status->st_size;
+    header.mtime = status->st_mtime;
+    header.entries = n;
+
+    bool written = (fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(entries, sizeof(struct bank_entry), n, fp) == n);
+    if (fclose(fp) != 0 || !written || rename(temp_filename, index_filename) == -1)
+        unlink(temp_filename);
+}
+
+/// @brief Sets up a memory-mapped bank in the binary format, after checking its header
+/// @param bank the puzzle bank
+/// @param filename the file of the bank
+static void puzzle_bank_open_binary(struct puzzle_bank *bank, const char *filename)
+{
+    const struct bank_binary_header *header = (const struct bank_binary_header *)bank->data;
+
+    // the counts of the header are checked against the size of the file before any size is computed from them, so a
+    // corrupted count can't wrap around
+    if (bank->size < sizeof(struct bank_binary_header) || header->record_size != sizeof(struct bank_record) ||
+        header->records > (bank->size - sizeof(struct bank_binary_header)) / sizeof(struct bank_record))
+    {
+        fprintf(stderr, "ERROR: invalid binary puzzle file %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    size_t records_end = sizeof(struct bank_binary_header) + header->records * sizeof(struct bank_record);
+
+    bank->format = BANK_BINARY;
+    bank->n = header->records;
+    bank->records = (const struct bank_record *)(bank->data + sizeof(struct bank_binary_header));
+    bank->blocks = NULL;
+    bank->block_records = header->block_records;
+    bank->n_blocks = 0;
+    if (header->block_records > 0)
+    {
+        size_t n_blocks = (bank->n + header->block_records - 1) / header->block_records;
+        if (header->block_index_offset >= records_end && header->block_index_offset <= bank->size &&
+            n_blocks <= (bank->size - header->block_index_offset) / sizeof(uint64_t))
+        {
+            bank->blocks = (const uint64_t *)(bank->data + header->block_index_offset);
+            bank->n_blocks = n_blocks;
+        }
+    }
+}
+
+/// @brief Loads a compressed bank in memory: the bank is decoded on a background thread while the records of a text bank
+///        already decoded are indexed
+/// @param bank the puzzle bank
+/// @param filename the file of the bank
+/// @param kind the compression of the bank
+/// @param compressed_size the size of the bank file
+static void puzzle_bank_load(struct puzzle_bank *bank, const char *filename, enum compression kind, size_t compressed_size)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp)
+    {
+        perror("Problem encountered when opening puzzle file");
+        exit(EXIT_FAILURE);
+    }
+
+    struct stream_decoder decoder;
+    stream_decoder_open(&decoder, fp, kind, NULL, 0);
+
+    size_t capacity = compressed_size * 4 + DECODER_CHUNK, size = 0;
+    char *data = (char *)malloc(capacity);
+    struct bank_entry *entries = NULL;
+    size_t n = 0, entries_capacity = 0, indexed = 0;
+    bool binary = false;
+    ssize_t got;
+    if (data == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // read returns as soon as a block is decoded, unlike fread which waits for the whole buffer
+    while ((got = read(fileno(decoder.output), data + size, capacity - size)) != 0)
+    {
+        if (got == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Problem encountered when decoding puzzle file");
+            exit(EXIT_FAILURE);
+        }
+        size += got;
+        if (size == capacity)
+        {
+            capacity *= 2;
+            if ((data = (char *)realloc(data, capacity)) == NULL)
+            {
+                fprintf(stderr, "ERROR: Out of memory!!\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        // once the start of the bank is known, the records of a text bank are indexed as soon as they are decoded
+        if (entries == NULL && !binary && size >= strlen(BANK_BINARY_MAGIC))
+        {
+            binary = (memcmp(data, BANK_BINARY_MAGIC, strlen(BANK_BINARY_MAGIC)) == 0);
+            entries_capacity = capacity / LINE_SIZE + 1;
+            if (!binary && (entries = (struct bank_entry *)malloc(sizeof(struct bank_entry) * entries_capacity)) == NULL)
+            {
+                fprintf(stderr, "ERROR: Out of memory!!\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (entries != NULL)
+            indexed = bank_index_records(data, size, indexed, false, &entries, &n, &entries_capacity);
+    }
+
+    bool decoded = stream_decoder_close(&decoder);
+    fclose(fp);
+    if (!decoded || size == 0)
+    {
+        fprintf(stderr, "ERROR: corrupted or empty %s puzzle file %s\n", compression_name(kind), filename);
+        exit(EXIT_FAILURE);
+    }
+
+    bank->compression = kind;
+    bank->data = data;
+    bank->size = size;
+    if (binary)
+    {
+        puzzle_bank_open_binary(bank, filename);
+        return;
+    }
+
+    if (entries == NULL)
+    { // the bank is shorter than the magic of the binary format
+        entries_capacity = 1;
+        if ((entries = (struct bank_entry *)malloc(sizeof(struct bank_entry))) == NULL)
+        {
+            fprintf(stderr, "ERROR: Out of memory!!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    bank_index_records(data, size, indexed, true, &entries, &n, &entries_capacity);
+    qsort(entries, n, sizeof(struct bank_entry), bank_entry_compare);
+    bank->format = BANK_TEXT;
+    bank->entries = entries;
+    bank->n = n;
+}
+
+/// @brief Opens a puzzle bank, in the text or the binary format. The bank is memory-mapped and so is the sidecar index of
+///        a text bank (the bank file name followed by BANK_INDEX_SUFFIX), which is built first if it is missing or out of date.
+///        A gzip or zstd compressed bank is decoded in memory instead, and a text one indexed while it is decoded
+/// @param bank the puzzle bank
+/// @param filename the file of the bank
+void puzzle_bank_open(struct puzzle_bank *bank, const char *filename)
+{
+    struct stat status;
+    int fd;
+
+    if ((fd = open(filename, O_RDONLY)) == -1)
+    {
+        perror("Problem encountered when opening puzzle file");
+        exit(EXIT_FAILURE);
+    }
+    if (fstat(fd, &status) == -1 || status.st_size == 0)
+    {
+        fprintf(stderr, "ERROR: empty or unreadable puzzle file %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    bank->compression = COMPRESSION_NONE;
+    bank->index_map = NULL;
+    bank->index_size = 0;
+    bank->entries = NULL;
+    bank->records = NULL;
+
+    unsigned char magic[COMPRESSION_MAGIC_SIZE];
+    ssize_t got = pread(fd, magic, sizeof(magic), 0);
+    enum compression kind = (got > 0) ? compression_detect(magic, got) : COMPRESSION_NONE;
+    if (kind != COMPRESSION_NONE)
+    { // a compressed bank can't be mapped, it is decoded in memory
+        close(fd);
+        puzzle_bank_load(bank, filename, kind, status.st_size);
+        return;
+    }
+
+    void *data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror("Problem encountered when mapping puzzle file");
+        exit(EXIT_FAILURE);
+    }
+    madvise(data, status.st_size, MADV_RANDOM); // only the records looked up are read
+    bank->data = (const char *)data;
+    bank->size = status.st_size;
+
+    if (bank->size >= sizeof(struct bank_binary_header) && memcmp(bank->data, BANK_BINARY_MAGIC, 8) == 0)
+    { // the binary format needs no index, its records are sorted by hash
+        puzzle_bank_open_binary(bank, filename);
+        return;
+    }
+
+    bank->format = BANK_TEXT;
+    char index_filename[FILE_SIZE];
+    snprintf(index_filename, FILE_SIZE, "%s%s", filename, BANK_INDEX_SUFFIX);
+    if (puzzle_bank_map_index(bank, index_filename, &status))
+        return;
+
+    // build the index once, the next runs map it
+    size_t n;
+    struct bank_entry *entries = puzzle_bank_build_index(bank->data, bank->size, &n);
+    puzzle_bank_write_index(index_filename, entries, n, &status);
+    bank->entries = entries;
+    bank->n = n;
+}
+
+/// @brief Closes a puzzle bank
+/// @param bank the puzzle bank
+void puzzle_bank_close(struct puzzle_bank *bank)
+{
+    if (bank->index_map != NULL)
+        munmap(bank->index_map, bank->index_size);
+    else if (bank->format == BANK_TEXT)
+        free((void *)bank->entries);
+    if (bank->compression != COMPRESSION_NONE)
+        free((void *)bank->data);
+    else
+        munmap((void *)bank->data, bank->size);
+    bank->entries = NULL;
+    bank->data = NULL;
+}
+
+/// @brief Finds a puzzle of the bank by binary search in its index
+/// @param bank the puzzle bank
+/// @param puzzle_hash the hash of the puzzle
+/// @return the entry of the puzzle, NULL if the bank doesn't hold it
+const struct bank_entry *puzzle_bank_find(struct puzzle_bank *bank, const char *puzzle_hash)
+{
+    if (strlen(puzzle_hash) != HASH_SIZE)
+        return NULL;
+
+    size_t low = 0, high = bank->n;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        int order = memcmp(bank->entries[middle].hash, puzzle_hash, HASH_SIZE);
+        if (order == 0)
+            return &bank->entries[middle];
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return NULL;
+}
+
+/// @brief Reads the grid of a puzzle of the bank
+/// @param bank the puzzle bank
+/// @param entry the entry of the puzzle
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+/// @return true if the record of the puzzle is valid, false otherwise
+bool puzzle_bank_read(struct puzzle_bank *bank, const struct bank_entry *entry, int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating)
+{
+    char line_buffer[LINE_SIZE * 2];
+    char hash[HASH_SIZE + 1];
+    char puzzle[PUZZLE_SIZE + 1];
+    double difficulty = 0;
+
+    size_t length = (entry->length < sizeof(line_buffer) - 1) ? entry->length : sizeof(line_buffer) - 1;
+    memcpy(line_buffer, bank->data + entry->offset, length);
+    line_buffer[length] = '\0';
+
+    if (sscanf(line_buffer, "%12s %81s %lf", hash, puzzle, &difficulty) < 2 || strlen(puzzle) != PUZZLE_SIZE)
+    {
+        fprintf(stderr, "ERROR: invalid input line %s|\n|", line_buffer);
+        return false;
+    }
+
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+    {
+        char c = puzzle[i];
+        grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE] = (c >= '1' && c <= '9') ? c - '0' : 0; // '0' and '.' are empty cells
+    }
+    if (rating != NULL)
+        *rating = difficulty;
+    return true;
+}
+
+/// @brief Converts the 12 hexadecimal digits of a hash to a 48-bit number
+/// @param hash the hash
+/// @param key the 48-bit number
+/// @return true if the hash is made of 12 hexadecimal digits, false otherwise
+bool bank_hash_key(const char *hash, uint64_t *key)
+{
+    *key = 0;
+    for (int i = 0; i < HASH_SIZE; i++)
+    {
+        char c = hash[i];
+        int digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            return false;
+        *key = (*key << 4) | digit;
+    }
+    return hash[HASH_SIZE] == '\0' || hash[HASH_SIZE] == ' ';
+}
+
+/// @brief Gets the 48-bit hash of a record of the binary format
+/// @param record the record
+/// @return the 48-bit hash
+static uint64_t bank_record_key(const struct bank_record *record)
+{
+    uint64_t key = 0;
+    for (int i = 0; i < RECORD_HASH; i++)
+        key = (key << 8) | record->hash[i];
+    return key;
+}
+
+/// @brief Packs a puzzle into a record of the binary format
+/// @param record the record
+/// @param key the 48-bit hash of the puzzle
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle
+void bank_record_encode(struct bank_record *record, uint64_t key, int grid[SUDOKU_SIZE][SUDOKU_SIZE], double rating)
+{
+    for (int i = RECORD_HASH - 1; i >= 0; i--, key >>= 8)
+        record->hash[i] = key & 0xFF;
+
+    memset(record->digits, 0, RECORD_DIGITS);
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        record->digits[i / 2] |= grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE] << ((i % 2 == 0) ? 4 : 0);
+
+    int tenths = (int)(rating * 10 + 0.5);
+    record->rating = (tenths < 0) ? 0 : (tenths > 255) ? 255 : tenths;
+}
+
+/// @brief Unpacks a record of the binary format
+/// @param record the record
+/// @param hash the hash of the puzzle, null terminated, can be NULL
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+void bank_record_decode(const struct bank_record *record, char hash[HASH_SIZE + 1], int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating)
+{
+    if (hash != NULL)
+        snprintf(hash, HASH_SIZE + 1, "%012llx", (unsigned long long)bank_record_key(record));
+
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE] = (record->digits[i / 2] >> ((i % 2 == 0) ? 4 : 0)) & 0xF;
+
+    if (rating != NULL)
+        *rating = record->rating / 10.0;
+}
+
+/// @brief Finds a record of a bank in the binary format by binary search, first in the block index if any
+/// @param bank the puzzle bank
+/// @param key the 48-bit hash of the puzzle
+/// @return the record of the puzzle, NULL if the bank doesn't hold it
+static const struct bank_record *puzzle_bank_find_record(struct puzzle_bank *bank, uint64_t key)
+{
+    size_t low = 0, high = bank->n;
+
+    if (bank->blocks != NULL)
+    { // the last block starting at or before the hash, the small block index stays in cache
+        size_t first = 0, last = bank->n_blocks;
+        while (first < last)
+        {
+            size_t middle = first + (last - first) / 2;
+            if (bank->blocks[middle] <= key)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+        if (first == 0)
+            return NULL;
+        low = (first - 1) * bank->block_records;
+        high = (low + bank->block_records < bank->n) ? low + bank->block_records : bank->n;
+    }
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        uint64_t middle_key = bank_record_key(&bank->records[middle]);
+        if (middle_key == key)
+            return &bank->records[middle];
+        if (middle_key < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return NULL;
+}
+
+/// @brief Finds a puzzle of the bank by its hash and reads its grid, whatever the format of the bank
+/// @param bank the puzzle bank
+/// @param puzzle_hash the hash of the puzzle
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+/// @return true if the puzzle was found, false otherwise
+bool puzzle_bank_get(struct puzzle_bank *bank, const char *puzzle_hash, int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating)
+{
+    if (bank->format == BANK_BINARY)
+    {
+        uint64_t key;
+        const struct bank_record *record;
+        if (strlen(puzzle_hash) != HASH_SIZE || !bank_hash_key(puzzle_hash, &key) || (record = puzzle_bank_find_record(bank, key)) == NULL)
+            return false;
+        bank_record_decode(record, NULL, grid, rating);
+        return true;
+    }
+
+    const struct bank_entry *entry = puzzle_bank_find(bank, puzzle_hash);
+    return entry != NULL && puzzle_bank_read(bank, entry, grid, rating);
+}
+
+/// @brief Reads the k-th puzzle of the bank in the order of the hashes, whatever the format of the bank
+/// @param bank the puzzle bank
+/// @param k the index of the puzzle, lower than the number of puzzles of the bank
+/// @param hash the hash of the puzzle, null terminated
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @param rating the rating of the puzzle, can be NULL
+/// @return true if the record of the puzzle is valid, false otherwise
+bool puzzle_bank_at(struct puzzle_bank *bank, size_t k, char hash[HASH_SIZE + 1], int grid[SUDOKU_SIZE][SUDOKU_SIZE], double *rating)
+{
+    if (bank->format == BANK_BINARY)
+    {
+        bank_record_decode(&bank->records[k], hash, grid, rating);
+        return true;
+    }
+
+    memcpy(hash, bank->entries[k].hash, HASH_SIZE);
+    hash[HASH_SIZE] = '\0';
+    return puzzle_bank_read(bank, &bank->entries[k], grid, rating);
+}
+
+/// @brief Compares two records of the binary format by hash
+/// @param a the first record
+/// @param b the second record
+/// @return the order of the records
+static int bank_record_compare(const void *a, const void *b)
+{
+    return memcmp(((const struct bank_record *)a)->hash, ((const struct bank_record *)b)->hash, RECORD_HASH);
+}
+
+/// @brief Converts a puzzle bank (text or binary) to the binary format, written to a temporary file renamed once complete
+/// @param input the file of the bank to convert
+/// @param output the file of the bank in the binary format
+/// @param block_records the number of records of a block of the block index, 0 without block index
+/// @return the number of puzzles converted, -1 if the output couldn't be written
+long puzzle_bank_convert(const char *input, const char *output, size_t block_records)
+{
+    struct puzzle_bank bank;
+    puzzle_bank_open(&bank, input);
+
+    struct bank_record *records = (struct bank_record *)malloc(sizeof(struct bank_record) * (bank.n + 1));
+    if (records == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t n = 0;
+    for (size_t k = 0; k < bank.n; k++)
+    {
+        char hash[HASH_SIZE + 1];
+        int grid[SUDOKU_SIZE][SUDOKU_SIZE];
+        double rating = 0;
+        uint64_t key;
+
+        if (!puzzle_bank_at(&bank, k, hash, grid, &rating))
+            continue;
+        if (!bank_hash_key(hash, &key))
+        {
+            fprintf(stderr, "Skipping puzzle %s: the hash isn't made of %d hexadecimal digits\n", hash, HASH_SIZE);
+            continue;
+        }
+        bank_record_encode(&records[n++], key, grid, rating);
+    }
+    puzzle_bank_close(&bank);
+
+    // the text index is sorted by the characters of the hashes, the binary records by their value
+    qsort(records, n, sizeof(struct bank_record), bank_record_compare);
+
+    struct bank_binary_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BANK_BINARY_MAGIC, sizeof(header.magic));
+    header.record_size = sizeof(struct bank_record);
+    header.block_records = block_records;
+    header.records = n;
+    header.block_index_offset = (block_records > 0) ? sizeof(header) + n * sizeof(struct bank_record) : 0;
+
+    char temp_filename[FILE_SIZE + 32];
+    snprintf(temp_filename, sizeof(temp_filename), "%s.%d", output, (int)getpid());
+    FILE *fp = fopen(temp_filename, "wb");
+    if (!fp)
+    {
+        perror("Problem encountered when creating the binary puzzle file");
+        free(records);
+        return -1;
+    }
+
+    bool written = (fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(records, sizeof(struct bank_record), n, fp) == n);
+    for (size_t k = 0; block_records > 0 && k < n && written; k += block_records)
+    {
+        uint64_t key = bank_record_key(&records[k]);
+        written = (fwrite(&key, sizeof(key), 1, fp) == 1);
+    }
+    free(records);
+
+    if (fclose(fp) != 0 || !written || rename(temp_filename, output) == -1)
+    {
+        perror("Problem encountered when writing the binary puzzle file");
+        unlink(temp_filename);
+        return -1;
+    }
+    return (long)n;
+}
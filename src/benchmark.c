@@ -150,6 +150,81 @@ void sudoku_plot_cost_per_difficulty(const char *filename)
     exit(EXIT_SUCCESS);
 }
 
+/// @brief Creates histogram comparing the average execution time of the unweighted and weighted (breakout) cost functions
+///        for each sudoku difficulty using the given file
+/// @param filename the given file
+void sudoku_plot_weighting_benchmark(const char *filename)
+{
+    char command_buffer[COMMANDE_SIZE + 1];
+    char command[COMMANDE_SIZE + 1] = "plot";
+
+    FILE *gnuplot = popen("gnuplot", "w");
+    if (!gnuplot)
+    {
+        perror("popen");
+        exit(EXIT_FAILURE);
+    }
+
+    snprintf(command_buffer,
+             COMMANDE_SIZE + 1,
+             " \"%s\" using 2:xtic(1) title 'Sans poids' linecolor \"%s\", \"\" using 3 title 'Contraintes pondérées' linecolor \"%s\"",
+             filename, plot_colors[3], plot_colors[2]);
+    strcat(command, command_buffer);
+    printf("%s\n", command);
+
+    if(GET_OUTPUT) {
+        fprintf(gnuplot, "set terminal pngcairo\n");
+        fprintf(gnuplot, "set output './output/weighting_bench.png'\n");
+    }
+
+    fprintf(gnuplot, "set title \"Temps d'execution en moyenne avec et sans pondération des contraintes\" font \"%s\"\n", "Helvetica,18");
+    fprintf(gnuplot, "set xlabel \"Difficulté du sudoku\"\n");
+    fprintf(gnuplot, "set ylabel \"Temps d'execution (secondes)\"\n");
+    fprintf(gnuplot, "set style data histogram\n");
+    fprintf(gnuplot, "set style histogram cluster gap 1\n");
+    fprintf(gnuplot, "set style fill solid 0.5 border -1\n");
+    fprintf(gnuplot, "%s\n", command);
+    fflush(gnuplot);
+    fprintf(stdout, "Click Ctrl+d to quit...\n");
+    getchar();
+
+    pclose(gnuplot);
+    exit(EXIT_SUCCESS);
+}
+
+/// @brief Creates histograms comparing the moves per second and the sweeps over the non fixed cells needed by each order
+///        of the cells changed, for each sudoku difficulty using the given file
+/// @param filename the given file
+void sudoku_plot_sweep_benchmark(const char *filename)
+{
+    FILE *gnuplot = popen("gnuplot", "w");
+    if (!gnuplot)
+    {
+        perror("popen");
+        exit(EXIT_FAILURE);
+    }
+
+    if(GET_OUTPUT) {
+        fprintf(gnuplot, "set terminal pngcairo size 1280,480\n");
+        fprintf(gnuplot, "set output './output/sweep_bench.png'\n");
+    }
+
+    fprintf(gnuplot, "set style data histogram\n");
+    fprintf(gnuplot, "set style fill solid 0.5 border -1\n");
+    fprintf(gnuplot, "set xtics rotate by -30\n");
+    fprintf(gnuplot, "set multiplot layout 1,2 title \"Ordre des cases modifiées\" font \"%s\"\n", "Helvetica,18");
+    fprintf(gnuplot, "set title \"Mouvements par seconde\"\n");
+    fprintf(gnuplot, "plot \"%s\" using 2:xtic(1) notitle linecolor \"%s\"\n", filename, plot_colors[3]);
+    fprintf(gnuplot, "set title \"Balayages jusqu'à la solution\"\n");
+    fprintf(gnuplot, "plot \"%s\" using 3:xtic(1) notitle linecolor \"%s\"\n", filename, plot_colors[2]);
+    fprintf(gnuplot, "unset multiplot\n");
+    fflush(gnuplot);
+    fprintf(stdout, "Click Ctrl+d to quit...\n");
+    getchar();
+
+    pclose(gnuplot);
+    exit(EXIT_SUCCESS);
+}
 
 int main(int argc, char *argv[])
 {
@@ -174,6 +249,12 @@ int main(int argc, char *argv[])
     case 6: // diabolical sudoku
         sudoku_plot_difficulty_benchmark(argc, argv, "diabolical");
         break;
+    case 7: // unweighted against weighted cost function
+        sudoku_plot_weighting_benchmark(argv[2]);
+        break;
+    case 8: // moves per second and sweeps of each order of the cells changed
+        sudoku_plot_sweep_benchmark(argv[2]);
+        break;
     }
 
     return EXIT_SUCCESS;
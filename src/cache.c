@@ -0,0 +1,244 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "cache.h"
+#include "verifier.h"
+
+/// @brief Packs the digits of a grid two per byte (the first one in the high nibble)
+/// @param digits the digits, line by line
+/// @param packed the packed digits
+static void cache_pack(const uint8_t *digits, uint8_t *packed)
+{
+    memset(packed, 0, RECORD_DIGITS);
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        packed[i / 2] |= digits[i] << ((i % 2 == 0) ? 4 : 0);
+}
+
+/// @brief Unpacks the digits of a grid stored two per byte
+/// @param packed the packed digits
+/// @param digits the digits, line by line
+static void cache_unpack(const uint8_t *packed, uint8_t *digits)
+{
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        digits[i] = (packed[i / 2] >> ((i % 2 == 0) ? 4 : 0)) & 0xf;
+}
+
+/// @brief Hashes the packed digits of a puzzle (FNV-1a)
+/// @param packed the packed digits
+/// @return the hash
+static uint64_t cache_hash(const uint8_t *packed)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (int k = 0; k < RECORD_DIGITS; k++)
+        hash = (hash ^ packed[k]) * 1099511628211ULL;
+    return hash;
+}
+
+/// @brief Finds the slot of a puzzle in the hash table, or the empty slot it would go to
+/// @param cache the solution cache
+/// @param packed the packed digits of the puzzle
+/// @return the index of the slot
+static size_t cache_slot(struct solution_cache *cache, const uint8_t *packed)
+{
+    size_t slot = cache_hash(packed) & (cache->size - 1);
+    while (cache->slots[slot] != 0 && memcmp(cache->records[cache->slots[slot] - 1].puzzle, packed, RECORD_DIGITS) != 0)
+        slot = (slot + 1) & (cache->size - 1);
+    return slot;
+}
+
+/// @brief Adds a record to the cache in memory, the hash table is doubled once half full
+/// @param cache the solution cache
+/// @param record the record
+/// @return 1 if the record was added, 0 if the puzzle was already in the cache, -1 if the memory couldn't be allocated (the
+///         cache is left as it was)
+static int cache_insert(struct solution_cache *cache, const struct cache_record *record)
+{
+    if ((cache->n + 1) * 2 > cache->size)
+    {
+        size_t size = cache->size * 2;
+        size_t *slots = (size_t *)calloc(size, sizeof(size_t));
+        if (slots == NULL)
+            return -1;
+        free(cache->slots);
+        cache->slots = slots;
+        cache->size = size;
+        for (size_t k = 0; k < cache->n; k++)
+            cache->slots[cache_slot(cache, cache->records[k].puzzle)] = k + 1;
+    }
+
+    size_t slot = cache_slot(cache, record->puzzle);
+    if (cache->slots[slot] != 0)
+        return 0;
+
+    if (cache->n == cache->capacity)
+    {
+        size_t capacity = (cache->capacity == 0) ? CACHE_SLOTS / 2 : cache->capacity * 2;
+        struct cache_record *records = (struct cache_record *)realloc(cache->records, capacity * sizeof(struct cache_record));
+        if (records == NULL)
+            return -1;
+        cache->records = records;
+        cache->capacity = capacity;
+    }
+    cache->records[cache->n++] = *record;
+    cache->slots[slot] = cache->n;
+    return 1;
+}
+
+/// @brief Writes the whole given buffer to the file
+/// @param fd the file
+/// @param buffer the buffer
+/// @param size the size of the buffer
+/// @return false if the file couldn't be written, true otherwise
+static bool write_all(int fd, const void *buffer, size_t size)
+{
+    const char *bytes = (const char *)buffer;
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Problem encountered when writing the solution cache");
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+/// @brief Opens a solution cache file and loads its records, a truncated last record is ignored
+/// @param cache the solution cache
+/// @param filename the cache file, created if needed
+void solution_cache_open(struct solution_cache *cache, const char *filename)
+{
+    memset(cache, 0, sizeof(struct solution_cache));
+    cache->size = CACHE_SLOTS;
+    if ((cache->slots = (size_t *)calloc(cache->size, sizeof(size_t))) == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_rwlock_init(&cache->lock, NULL);
+
+    // the records are appended at once, the ones of several runs sharing the file don't mix
+    struct stat status;
+    if ((cache->fd = open(filename, O_RDWR | O_CREAT | O_APPEND, 0644)) == -1 || fstat(cache->fd, &status) == -1)
+    {
+        perror("Problem encountered when opening the solution cache");
+        exit(EXIT_FAILURE);
+    }
+
+    struct cache_header header;
+    if (status.st_size == 0)
+    {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+        header.record_size = sizeof(struct cache_record);
+        if (!write_all(cache->fd, &header, sizeof(header)))
+            exit(EXIT_FAILURE);
+        return;
+    }
+
+    if (pread(cache->fd, &header, sizeof(header), 0) != sizeof(header) || memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(struct cache_record))
+    {
+        fprintf(stderr, "ERROR: %s isn't a solution cache file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    // a record cut by a run stopped while appending it is dropped, the next ones are appended after the last whole record
+    size_t n = (status.st_size - sizeof(header)) / sizeof(struct cache_record);
+    if (sizeof(header) + n * sizeof(struct cache_record) != (size_t)status.st_size &&
+        ftruncate(cache->fd, sizeof(header) + n * sizeof(struct cache_record)) == -1)
+        perror("Problem encountered when truncating the solution cache");
+
+    struct cache_record *records = (struct cache_record *)malloc(n * sizeof(struct cache_record) + 1);
+    if (records == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (pread(cache->fd, records, n * sizeof(struct cache_record), sizeof(header)) != (ssize_t)(n * sizeof(struct cache_record)))
+    {
+        perror("Problem encountered when reading the solution cache");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t k = 0; k < n; k++)
+    {
+        if (cache_insert(cache, &records[k]) == -1)
+        {
+            fprintf(stderr, "ERROR: Out of memory!!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    free(records);
+}
+
+/// @brief Looks a puzzle up in the cache, the solution found is mapped back through the inverse symmetry of the canonical form
+///        and only given if it is a valid grid agreeing with the puzzle
+/// @param cache the solution cache
+/// @param form the canonical form of the puzzle
+/// @param solution the solution of the puzzle, allocated by the caller
+/// @return true if the puzzle was found, false otherwise
+bool solution_cache_find(struct solution_cache *cache, const struct canonical_form *form, int **solution)
+{
+    uint8_t packed[RECORD_DIGITS], digits[PUZZLE_SIZE];
+    struct cache_record record;
+    bool found;
+    cache_pack(form->digits, packed);
+
+    pthread_rwlock_rdlock(&cache->lock);
+    size_t slot = cache_slot(cache, packed);
+    if ((found = (cache->slots[slot] != 0)))
+        record = cache->records[cache->slots[slot] - 1];
+    pthread_rwlock_unlock(&cache->lock);
+
+    if (found)
+    {
+        cache_unpack(record.solution, digits);
+        found = (sudoku_verify(form->digits, digits) == VERIFY_VALID);
+        if (found)
+            canonical_form_restore(form, digits, solution);
+    }
+    __atomic_fetch_add((found) ? &cache->hits : &cache->misses, 1, __ATOMIC_RELAXED);
+    return found;
+}
+
+/// @brief Adds the solution of a puzzle to the cache and appends it to the file, unless the puzzle is already in the cache
+/// @param cache the solution cache
+/// @param form the canonical form of the puzzle
+/// @param solution the solution of the puzzle
+/// @return false if the solution couldn't be added (out of memory) or appended to the file, true otherwise
+bool solution_cache_store(struct solution_cache *cache, const struct canonical_form *form, int **solution)
+{
+    struct cache_record record;
+    uint8_t digits[PUZZLE_SIZE];
+    canonical_form_apply(form, solution, digits);
+    if (sudoku_verify(form->digits, digits) != VERIFY_VALID)
+        return true;
+    cache_pack(form->digits, record.puzzle);
+    cache_pack(digits, record.solution);
+
+    pthread_rwlock_wrlock(&cache->lock);
+    int inserted = cache_insert(cache, &record);
+    bool stored = (inserted == 0 || (inserted == 1 && write_all(cache->fd, &record, sizeof(record))));
+    pthread_rwlock_unlock(&cache->lock);
+    return stored;
+}
+
+/// @brief Closes a solution cache file and frees its records
+/// @param cache the solution cache
+void solution_cache_close(struct solution_cache *cache)
+{
+    close(cache->fd);
+    pthread_rwlock_destroy(&cache->lock);
+    free(cache->records);
+    free(cache->slots);
+    cache->records = NULL;
+    cache->slots = NULL;
+}
@@ -0,0 +1,177 @@
+#include <string.h>
+
+#include "canonical.h"
+
+/// @brief The state of the search of the canonical form for a given transposition and order of the columns
+struct canonical_search
+{
+    int grid[SUDOKU_SIZE][SUDOKU_SIZE]; // the grid, transposed or not
+    bool transposed;
+    int column[SUDOKU_SIZE];            // the order of the columns explored
+    int line[SUDOKU_SIZE];              // the order of the lines of the branch explored
+    uint8_t digits[PUZZLE_SIZE];        // the relabeled lines of the branch explored
+    struct canonical_form *best;        // the smallest grid found so far
+    bool found;                         // if a grid was found
+    long version;                       // the number of times the smallest grid changed
+};
+
+// the orders of the three elements of a band or a stack
+static const int permutations[6][SUDOKU_GRID_SIZE] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+/// @brief Places the lines of the canonical grid one after the other: a line of a band not placed yet starts each band, the
+///        two others lines of its band follow. The branches whose lines are larger than the smallest grid found are left
+/// @param search the state of the search
+/// @param depth the line of the canonical grid placed
+/// @param label the canonical digit of each digit of the grid seen so far, 0 for the digits not seen yet
+/// @param next the next canonical digit given
+/// @param used the lines already placed (bit mask)
+/// @param smaller if the lines placed are already smaller than the ones of the smallest grid found
+/// @param version the version of the smallest grid the lines placed were compared to
+static void canonical_lines(struct canonical_search *search, int depth, const int *label, int next, int used, bool smaller, long version)
+{
+    if (depth == SUDOKU_SIZE)
+    {
+        if (search->found && !(smaller && version == search->version))
+            return;
+
+        struct canonical_form *best = search->best;
+        memcpy(best->digits, search->digits, PUZZLE_SIZE);
+        memcpy(best->line, search->line, sizeof(best->line));
+        memcpy(best->column, search->column, sizeof(best->column));
+        memcpy(best->label, label, sizeof(best->label));
+        best->transposed = search->transposed;
+        // the digits missing from the grid get the labels left, in order
+        for (int digit = 1; digit <= SUDOKU_SIZE; digit++)
+        {
+            if (best->label[digit] == 0)
+                best->label[digit] = next++;
+        }
+        search->found = true;
+        search->version++;
+        return;
+    }
+
+    int first = (depth % SUDOKU_GRID_SIZE == 0) ? 0 : search->line[depth - 1] - search->line[depth - 1] % SUDOKU_GRID_SIZE;
+    int last = (depth % SUDOKU_GRID_SIZE == 0) ? SUDOKU_SIZE : first + SUDOKU_GRID_SIZE;
+    for (int candidate = first; candidate < last; candidate++)
+    {
+        // a new band starts with any line of a band with no line placed yet
+        int band = candidate - candidate % SUDOKU_GRID_SIZE;
+        if ((used & (1 << candidate)) || (depth % SUDOKU_GRID_SIZE == 0 && (used & (7 << band))))
+            continue;
+
+        // a smaller grid found by the previous branches shares the lines placed, the new line is compared to its own
+        if (version != search->version)
+        {
+            smaller = false;
+            version = search->version;
+        }
+
+        int line_label[SUDOKU_SIZE + 1];
+        int line_next = next;
+        memcpy(line_label, label, sizeof(line_label));
+
+        uint8_t *digits = search->digits + depth * SUDOKU_SIZE;
+        const uint8_t *best = search->best->digits + depth * SUDOKU_SIZE;
+        int order = (smaller || !search->found) ? -1 : 0; // the order of the line against the one of the smallest grid
+        for (int c = 0; c < SUDOKU_SIZE; c++)
+        {
+            int value = search->grid[candidate][search->column[c]];
+            if (value != 0 && line_label[value] == 0)
+                line_label[value] = line_next++;
+            digits[c] = (uint8_t)line_label[value];
+            if (order == 0 && digits[c] != best[c])
+                order = (digits[c] < best[c]) ? -1 : 1;
+            if (order > 0)
+                break;
+        }
+        if (order > 0)
+            continue;
+
+        search->line[depth] = candidate;
+        canonical_lines(search, depth + 1, line_label, line_next, used | (1 << candidate), smaller || order < 0, version);
+    }
+}
+
+/// @brief Finds the canonical form of a grid and the symmetry mapping the grid to it. The symmetries are explored line by line
+///        of the canonical grid and a branch is left as soon as its lines are larger than the smallest grid found
+/// @param grid the grid, its empty cells are 0
+/// @param form the canonical form of the grid
+void sudoku_canonicalize(int **grid, struct canonical_form *form)
+{
+    struct canonical_search search;
+    int label[SUDOKU_SIZE + 1] = {0};
+    search.best = form;
+    search.found = false;
+    search.version = 0;
+
+    for (int transposed = 0; transposed < 2; transposed++)
+    {
+        search.transposed = transposed;
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+        {
+            for (int j = 0; j < SUDOKU_SIZE; j++)
+                search.grid[i][j] = (transposed) ? grid[j][i] : grid[i][j];
+        }
+
+        // every order of the stacks and of the columns inside each stack
+        for (int stacks = 0; stacks < 6; stacks++)
+        {
+            for (int first = 0; first < 6; first++)
+            {
+                for (int second = 0; second < 6; second++)
+                {
+                    for (int third = 0; third < 6; third++)
+                    {
+                        const int *inside[SUDOKU_GRID_SIZE] = {permutations[first], permutations[second], permutations[third]};
+                        for (int c = 0; c < SUDOKU_SIZE; c++)
+                        {
+                            int stack = permutations[stacks][c / SUDOKU_GRID_SIZE];
+                            search.column[c] = stack * SUDOKU_GRID_SIZE + inside[c / SUDOKU_GRID_SIZE][c % SUDOKU_GRID_SIZE];
+                        }
+                        canonical_lines(&search, 0, label, 1, 0, false, search.version);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// @brief Maps a grid equivalent to the canonicalized one (its solution) through the same symmetry
+/// @param form the canonical form
+/// @param grid the grid
+/// @param digits the digits of the grid mapped, line by line
+void canonical_form_apply(const struct canonical_form *form, int **grid, uint8_t *digits)
+{
+    for (int r = 0; r < SUDOKU_SIZE; r++)
+    {
+        for (int c = 0; c < SUDOKU_SIZE; c++)
+        {
+            int value = (form->transposed) ? grid[form->column[c]][form->line[r]] : grid[form->line[r]][form->column[c]];
+            digits[r * SUDOKU_SIZE + c] = (uint8_t)form->label[value];
+        }
+    }
+}
+
+/// @brief Maps a grid back through the inverse of the symmetry of the canonical form
+/// @param form the canonical form
+/// @param digits the digits of a grid equivalent to the canonical grid (its solution), line by line
+/// @param grid the grid mapped back
+void canonical_form_restore(const struct canonical_form *form, const uint8_t *digits, int **grid)
+{
+    int digit[SUDOKU_SIZE + 1] = {0};
+    for (int value = 1; value <= SUDOKU_SIZE; value++)
+        digit[form->label[value]] = value;
+
+    for (int r = 0; r < SUDOKU_SIZE; r++)
+    {
+        for (int c = 0; c < SUDOKU_SIZE; c++)
+        {
+            int value = digit[digits[r * SUDOKU_SIZE + c] % (SUDOKU_SIZE + 1)];
+            if (form->transposed)
+                grid[form->column[c]][form->line[r]] = value;
+            else
+                grid[form->line[r]][form->column[c]] = value;
+        }
+    }
+}
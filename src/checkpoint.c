@@ -0,0 +1,158 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <limits.h>
+
+#include "checkpoint.h"
+
+/// @brief Fills the settings a run is resumed with
+/// @param settings the settings
+/// @param original_grid the grid of the puzzle
+/// @param options the settings of the run
+static void checkpoint_settings_init(struct checkpoint_settings *settings, int **original_grid, const struct solver_options *options)
+{
+    memset(settings, 0, sizeof(struct checkpoint_settings));
+    settings->weighting = options->weighting;
+    settings->adaptive = options->adaptive;
+    settings->tightening = options->tightening;
+    settings->strategy = options->strategy;
+    settings->cost_function = options->cost_function;
+    settings->initializer = options->initializer;
+    settings->sweep_order = options->sweep_order;
+    settings->multiple_tries = options->multiple_tries;
+    settings->perturbation = options->perturbation;
+    settings->cycle_probability = options->cycle_probability;
+    settings->chain_probability = options->chain_probability;
+    checkpoint_grid_save(settings->givens, original_grid);
+}
+
+/// @brief Starts a checkpoint of a run: the header and the settings, the state is filled by the solver
+/// @param checkpoint the checkpoint
+/// @param original_grid the grid of the puzzle
+/// @param options the settings of the run
+void solver_checkpoint_init(struct solver_checkpoint *checkpoint, int **original_grid, const struct solver_options *options)
+{
+    memset(checkpoint, 0, sizeof(struct solver_checkpoint));
+    memcpy(checkpoint->magic, CHECKPOINT_MAGIC, sizeof(checkpoint->magic));
+    checkpoint->size = sizeof(struct solver_checkpoint);
+    checkpoint_settings_init(&checkpoint->settings, original_grid, options);
+}
+
+/// @brief Copies a grid into a checkpoint
+/// @param grid the grid of the checkpoint
+/// @param lines the grid copied
+void checkpoint_grid_save(int32_t grid[SUDOKU_SIZE][SUDOKU_SIZE], int **lines)
+{
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+            grid[i][j] = lines[i][j];
+    }
+}
+
+/// @brief Copies a grid of a checkpoint back
+/// @param lines the grid, allocated by the caller
+/// @param grid the grid of the checkpoint
+void checkpoint_grid_load(int **lines, const int32_t grid[SUDOKU_SIZE][SUDOKU_SIZE])
+{
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+            lines[i][j] = grid[i][j];
+    }
+}
+
+/// @brief Writes a checkpoint atomically: to a temporary file synced to the disk then renamed over the previous checkpoint,
+///        so the file always holds a whole checkpoint, even if the process is killed while writing it
+/// @param filename the checkpoint file
+/// @param checkpoint the checkpoint
+/// @return false if the checkpoint couldn't be written (the previous one is kept), true otherwise
+bool solver_checkpoint_write(const char *filename, const struct solver_checkpoint *checkpoint)
+{
+    char temporary[PATH_MAX];
+    int fd = -1;
+    if (snprintf(temporary, sizeof(temporary), "%s.tmp", filename) >= (int)sizeof(temporary) ||
+        (fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1)
+    {
+        perror("Problem encountered when writing the checkpoint");
+        return false;
+    }
+
+    const char *bytes = (const char *)checkpoint;
+    size_t size = sizeof(struct solver_checkpoint);
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Problem encountered when writing the checkpoint");
+            close(fd);
+            unlink(temporary);
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+
+    // the data reaches the disk before the name, a crash leaves the previous checkpoint or the new one
+    if (fsync(fd) == -1 || close(fd) == -1 || rename(temporary, filename) == -1)
+    {
+        perror("Problem encountered when writing the checkpoint");
+        unlink(temporary);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Reads a checkpoint, the program stops if the file isn't a checkpoint of this build or of this puzzle and settings
+/// @param filename the checkpoint file
+/// @param checkpoint the checkpoint read
+/// @param original_grid the grid of the puzzle
+/// @param options the settings of the run
+/// @return false if there is no checkpoint file, true otherwise
+bool solver_checkpoint_read(const char *filename, struct solver_checkpoint *checkpoint, int **original_grid, const struct solver_options *options)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL)
+    {
+        if (errno == ENOENT)
+            return false;
+        perror("Problem encountered when reading the checkpoint");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t read = fread(checkpoint, 1, sizeof(struct solver_checkpoint), fp);
+    bool longer = (fgetc(fp) != EOF);
+    fclose(fp);
+    if (read != sizeof(struct solver_checkpoint) || longer || memcmp(checkpoint->magic, CHECKPOINT_MAGIC, sizeof(checkpoint->magic)) != 0 ||
+        checkpoint->size != sizeof(struct solver_checkpoint))
+    {
+        fprintf(stderr, "ERROR: %s isn't a checkpoint of this version of the solver\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    struct checkpoint_settings settings;
+    checkpoint_settings_init(&settings, original_grid, options);
+    if (memcmp(settings.givens, checkpoint->settings.givens, sizeof(settings.givens)) != 0)
+    {
+        fprintf(stderr, "ERROR: %s is the checkpoint of another puzzle\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    if (memcmp(&settings, &checkpoint->settings, sizeof(settings)) != 0)
+    {
+        fprintf(stderr, "ERROR: %s is the checkpoint of a run with other settings, resume it with the flags it was started with\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    return true;
+}
+
+/// @brief Removes the checkpoint of a finished run
+/// @param filename the checkpoint file
+void solver_checkpoint_remove(const char *filename)
+{
+    if (unlink(filename) == -1 && errno != ENOENT)
+        perror("Problem encountered when removing the checkpoint");
+}
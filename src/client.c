@@ -0,0 +1,332 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <omp.h>
+
+#include "stream.h"
+#include "protocol.h"
+#include "libsudoku.h"
+
+/// @brief A puzzle sent to the daemon and not answered yet, its slot is the id of the request
+struct client_slot
+{
+    bool used;
+    char hash[HASH_SIZE + 1];
+};
+
+/// @brief Prints how to use the client of the solver daemon
+/// @param program the name of the program
+void print_usage(char *program)
+{
+    fprintf(stderr, "Use: %s Flags socket < puzzles\n", program);
+    fprintf(stderr, " or: %s -q socket\n", program);
+    fprintf(stderr, "Where :\n");
+    fprintf(stderr, "  socket  : The UNIX socket of the solver daemon\n");
+    fprintf(stderr, "  puzzles : Lines of 81 digits ('0' or '.' for the empty cells), lines of a puzzle bank or a binary puzzle bank,\n");
+    fprintf(stderr, "            gzip or zstd compressed or not. One solution per line on the standard output, as soon as it is\n");
+    fprintf(stderr, "            received (hash or line of the puzzle, grid found, cost and time, or the error)\n");
+    fprintf(stderr, "Flags :\n");
+    fprintf(stderr, "  -w window : Number of puzzles sent and not answered yet (default %d)\n", SERVER_PIPELINE);
+    fprintf(stderr, "  -s seed   : Seed the seeds of the puzzles are made from (default the time)\n");
+    fprintf(stderr, "  -D seconds: Deadline of the solving of each puzzle, the best grid found is answered once it expires\n");
+    fprintf(stderr, "              (default the one of the daemon)\n");
+    fprintf(stderr, "  -P        : Print on the standard error each grid of lower cost found while solving the puzzles\n");
+    fprintf(stderr, "  -q        : Print the counters of the daemon instead of sending puzzles\n");
+}
+
+/// @brief Connects to the daemon
+/// @param path the path of the socket of the daemon
+/// @return the connected socket
+static int client_connect(const char *path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "ERROR: the path of the socket %s is too long\n", path);
+        exit(EXIT_FAILURE);
+    }
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || connect(fd, (struct sockaddr *)&address, sizeof(address)) == -1)
+    {
+        perror("Problem encountered when connecting to the daemon");
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+/// @brief Receives a whole frame from a blocking socket
+/// @param fd the socket
+/// @param message the message received
+/// @return false if the daemon closed the connection or sent an invalid frame, true otherwise
+static bool client_receive(int fd, struct protocol_message *message)
+{
+    uint8_t buffer[sizeof(struct protocol_message)];
+    size_t filled = 0;
+    long size;
+    while ((size = protocol_parse(buffer, filled, message)) == 0)
+    {
+        ssize_t received = recv(fd, buffer + filled, (filled < sizeof(struct protocol_header)) ? sizeof(struct protocol_header) - filled
+                                                                                              : ((struct protocol_header *)buffer)->length - filled, 0);
+        if (received == -1 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+        filled += received;
+    }
+    return size > 0;
+}
+
+/// @brief Queries the counters of the daemon and prints them
+/// @param fd the socket
+static void client_stats(int fd)
+{
+    struct protocol_message message;
+    protocol_message_init(&message, PROTOCOL_STATS, 0);
+    if (!protocol_send(fd, &message) || !client_receive(fd, &message) || message.header.type != PROTOCOL_COUNTERS)
+    {
+        fprintf(stderr, "ERROR: the daemon didn't answer the query of its counters\n");
+        exit(EXIT_FAILURE);
+    }
+
+    struct protocol_counters *counters = &message.body.counters;
+    printf(">> Uptime : %f seconds\n", counters->uptime);
+    printf(">> Workers : %u (%u puzzles being solved, %u queued)\n", counters->workers, counters->running, counters->queued);
+    printf(">> Clients connected : %u\n", counters->connections);
+    printf(">> Puzzles received : %lu\n", (unsigned long)counters->requests);
+    printf(">> Puzzles answered : %lu (%lu solved, %lu from the solution cache, %lu errors)\n", (unsigned long)counters->answered,
+           (unsigned long)counters->solved, (unsigned long)counters->cached, (unsigned long)counters->errors);
+    printf(">> Answers dropped : %lu\n", (unsigned long)counters->dropped);
+    printf(">> Time spent solving : %f seconds (%f%% of the workers)\n", counters->busy,
+           (counters->uptime > 0) ? 100 * counters->busy / (counters->uptime * counters->workers) : 0);
+}
+
+/// @brief Prints the answer of a puzzle: the hash of the puzzle, the grid found, its cost and the solving time, or the error
+/// @param hash the hash of the puzzle
+/// @param solution the answer
+static void client_print(const char *hash, const struct protocol_solution *solution)
+{
+    if (solution->status != LIBSUDOKU_OK)
+        printf("%s error %s\n", hash, libsudoku_status_name(solution->status));
+    else
+        printf("%s %.*s %d %f\n", hash, PUZZLE_SIZE, solution->grid, solution->cost, solution->time);
+    fflush(stdout);
+}
+
+/// @brief Main function of the client of the solver daemon: the puzzles of the standard input are sent without waiting for
+///        their answers (up to a window of puzzles), the answers are printed as they come, in any order
+/// @param argc number of arguments
+/// @param argv arguments
+/// @return EXIT_SUCCESS if every puzzle was answered without error, EXIT_FAILURE otherwise
+int main(int argc, char *argv[])
+{
+    int window = SERVER_PIPELINE;
+    unsigned int seed = (unsigned int)time(NULL);
+    bool stats = false, progress = false;
+    double deadline = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "w:s:qD:P")) != -1)
+    {
+        switch (option)
+        {
+        case 'w':
+            window = atoi(optarg);
+            if (window < 1)
+            {
+                fprintf(stderr, "The number of puzzles sent and not answered must be at least 1\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            seed = (unsigned int)strtoul(optarg, NULL, 10);
+            break;
+        case 'q':
+            stats = true;
+            break;
+        case 'D':
+            deadline = atof(optarg);
+            if (deadline <= 0)
+            {
+                fprintf(stderr, "The deadline of the solving must be a positive number of seconds\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'P':
+            progress = true;
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (argc - optind < 1)
+    {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int fd = client_connect(argv[optind]);
+    if (stats)
+    {
+        client_stats(fd);
+        close(fd);
+        return EXIT_SUCCESS;
+    }
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) == -1)
+    {
+        perror("Problem encountered when connecting to the daemon");
+        exit(EXIT_FAILURE);
+    }
+
+    struct client_slot *slots = calloc(window, sizeof(struct client_slot));
+    int *free_slots = malloc(window * sizeof(int));
+    if (slots == NULL || free_slots == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+    int n_free = window;
+    for (int k = 0; k < window; k++)
+        free_slots[k] = window - 1 - k;
+
+    struct sudoku_stream stream;
+    struct stream_puzzle puzzle;
+    sudoku_stream_open(&stream, stdin, stdout, NULL, false, 1, seed, NULL);
+
+    // the frames not sent yet and the bytes received and not parsed yet, the socket is never waited on while the other way is full
+    uint8_t output[SERVER_INPUT_SIZE], input[SERVER_INPUT_SIZE];
+    size_t to_send = 0, filled = 0;
+    bool end = false, shut = false;
+    long sent = 0, answered = 0, solved = 0, errors = 0;
+    struct protocol_message message;
+    double start_time = omp_get_wtime();
+
+    while (!end || to_send > 0 || n_free < window)
+    {
+        // the next puzzles are sent as long as the window and the buffer have room for them
+        while (!end && n_free > 0 && sizeof(output) - to_send >= sizeof(struct protocol_message))
+        {
+            if (!sudoku_stream_read(&stream, &puzzle))
+            {
+                end = true;
+                break;
+            }
+            int slot = free_slots[--n_free];
+            slots[slot].used = true;
+            strcpy(slots[slot].hash, puzzle.hash);
+
+            protocol_message_init(&message, PROTOCOL_SOLVE, (uint32_t)slot);
+            message.body.solve.seed = seed ^ (unsigned int)(sent * 2654435761u);
+            message.body.solve.deadline = deadline;
+            message.body.solve.flags = (progress) ? PROTOCOL_WITH_PROGRESS : 0;
+            for (int i = 0; i < PUZZLE_SIZE; i++)
+                message.body.solve.puzzle[i] = (char)('0' + puzzle.grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE]);
+            memcpy(output + to_send, &message, message.header.length);
+            to_send += message.header.length;
+            sent++;
+        }
+        // the daemon gets the end of the input once every puzzle is sent, it closes the connection after the last answer
+        if (end && to_send == 0 && !shut)
+        {
+            shutdown(fd, SHUT_WR);
+            shut = true;
+        }
+
+        struct pollfd pfd = {.fd = fd, .events = ((n_free < window) ? POLLIN : 0) | ((to_send > 0) ? POLLOUT : 0)};
+        if (pfd.events == 0)
+            continue;
+        if (poll(&pfd, 1, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Problem encountered when polling the daemon");
+            exit(EXIT_FAILURE);
+        }
+
+        if ((pfd.revents & POLLOUT) && to_send > 0)
+        {
+            ssize_t written = send(fd, output, to_send, MSG_NOSIGNAL);
+            if (written == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                perror("Problem encountered when sending the puzzles to the daemon");
+                exit(EXIT_FAILURE);
+            }
+            if (written > 0)
+            {
+                memmove(output, output + written, to_send - written);
+                to_send -= written;
+            }
+        }
+
+        if (pfd.revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            ssize_t received = recv(fd, input + filled, sizeof(input) - filled, 0);
+            if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+                continue;
+            if (received <= 0)
+            {
+                fprintf(stderr, "ERROR: the daemon closed the connection, %d puzzles not answered\n", window - n_free);
+                exit(EXIT_FAILURE);
+            }
+            filled += received;
+
+            size_t offset = 0;
+            long size;
+            while ((size = protocol_parse(input + offset, filled - offset, &message)) > 0)
+            {
+                uint32_t slot = message.header.id;
+                bool partial = (message.header.type == PROTOCOL_PROGRESS);
+                if ((message.header.type != PROTOCOL_SOLUTION && !partial) || slot >= (uint32_t)window || !slots[slot].used)
+                {
+                    size = -1;
+                    break;
+                }
+                offset += size;
+                if (partial)
+                { // the puzzle is still being solved
+                    fprintf(stderr, "%s progress %.*s %d %f\n", slots[slot].hash, PUZZLE_SIZE, message.body.progress.grid,
+                            message.body.progress.lowest_cost, message.body.progress.time);
+                    continue;
+                }
+                client_print(slots[slot].hash, &message.body.solution);
+                answered++;
+                solved += (message.body.solution.status == LIBSUDOKU_OK && message.body.solution.solved);
+                errors += (message.body.solution.status != LIBSUDOKU_OK);
+                slots[slot].used = false;
+                free_slots[n_free++] = slot;
+            }
+            if (size == -1)
+            {
+                fprintf(stderr, "ERROR: invalid answer received from the daemon\n");
+                exit(EXIT_FAILURE);
+            }
+            memmove(input, input + offset, filled - offset);
+            filled -= offset;
+        }
+    }
+    double CPU_time = omp_get_wtime() - start_time;
+
+    fprintf(stderr, ">> Puzzles solved : %ld/%ld (%ld errors, %ld invalid skipped)\n", solved, answered, errors, stream.invalid);
+    fprintf(stderr, ">> Puzzles per second : %f\n", (CPU_time > 0) ? answered / CPU_time : 0);
+    close(fd);
+    free(slots);
+    free(free_slots);
+    if (!sudoku_stream_close(&stream))
+    {
+        fprintf(stderr, "ERROR: the compressed input is corrupted or truncated\n");
+        exit(EXIT_FAILURE);
+    }
+    return (errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "bank.h"
+#include "sink.h"
+
+/// @brief Prints how to use the puzzle bank converter
+/// @param program the name of the program
+void print_usage(char *program)
+{
+    fprintf(stderr, "Use: %s input output [block_records]\n", program);
+    fprintf(stderr, "  or %s -l input\n", program);
+    fprintf(stderr, "  or %s -r results\n", program);
+    fprintf(stderr, "Where :\n");
+    fprintf(stderr, "  input         : The file containing the sudoku puzzles (text or binary format)\n");
+    fprintf(stderr, "  output        : The file of the puzzles in the binary format\n");
+    fprintf(stderr, "  block_records : The number of puzzles of a block of the block index, 0 without block index (default %d)\n", BANK_BLOCK_RECORDS);
+    fprintf(stderr, "  -l            : List the puzzles of the input file in the text format, sorted by hash\n");
+    fprintf(stderr, "  -r            : List the records of a binary result file of the solver (-F binary) as JSONL\n");
+}
+
+/// @brief Prints every puzzle of a bank (text or binary format) in the text format, so the batch scripts can read the hashes of any bank
+/// @param filename the file of the bank
+void list_bank(const char *filename)
+{
+    struct puzzle_bank bank;
+    puzzle_bank_open(&bank, filename);
+
+    for (size_t k = 0; k < bank.n; k++)
+    {
+        char hash[HASH_SIZE + 1];
+        int grid[SUDOKU_SIZE][SUDOKU_SIZE];
+        double rating = 0;
+        if (!puzzle_bank_at(&bank, k, hash, grid, &rating))
+            continue;
+
+        printf("%s ", hash);
+        for (int i = 0; i < PUZZLE_SIZE; i++)
+            putchar('0' + grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE]);
+        printf(" %4.1f\n", rating);
+    }
+
+    puzzle_bank_close(&bank);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 3 && strcmp(argv[1], "-l") == 0)
+    {
+        char input[FILE_SIZE] = SUDOKU_DIR;
+        strncat(input, argv[2], FILE_SIZE - strlen(input) - 1);
+        list_bank(input);
+        return EXIT_SUCCESS;
+    }
+
+    if (argc == 3 && strcmp(argv[1], "-r") == 0)
+    { // the result files are where the solver was told to write them
+        if (result_sink_dump(argv[2], stdout) < 0)
+        {
+            fprintf(stderr, "ERROR: %s isn't a binary result file\n", argv[2]);
+            exit(EXIT_FAILURE);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (argc < 3 || argc > 4)
+    {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    long block_records = (argc == 4) ? atol(argv[3]) : BANK_BLOCK_RECORDS;
+    if (block_records < 0)
+    {
+        fprintf(stderr, "The number of puzzles of a block must be positive\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // the files are in the directory of the sudoku puzzles, as for the solver
+    char input[FILE_SIZE] = SUDOKU_DIR, output[FILE_SIZE] = SUDOKU_DIR;
+    strncat(input, argv[1], FILE_SIZE - strlen(input) - 1);
+    strncat(output, argv[2], FILE_SIZE - strlen(output) - 1);
+
+    long n = puzzle_bank_convert(input, output, block_records);
+    if (n < 0)
+        exit(EXIT_FAILURE);
+
+    printf("%s#Converted %ld puzzles from %s to %s (%zu bytes per puzzle)%s\n", CLR_GRN, n, input, output, sizeof(struct bank_record), CLR_RESET);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,472 @@
+#include "cost.h"
+#include "utils.h"
+
+/// @brief Calculates the total amount of constraints violated in the sudoku grid by checking
+///        the occurence of a given number in the lines, columns and regions of the sudoku
+/// @param nb the given number to find the total amount of constraints violated
+/// @param start_l the starting index of the line
+/// @param start_c the starting index of the column
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of constraints violated in the given sudoku for the given cell
+int sudoku_cell_constraints(int nb, int start_l, int start_c, int **lines, int ***columns, int ***regions)
+{
+    if (nb == 0)
+        return 0;
+    int sum = 0;
+    int start_r = (start_l / 3) * 3 + (start_c / 3); // gets the specific region to check inside
+    for (int j = 0; j < SUDOKU_SIZE; j++)
+    {
+        // if (lines[start_l][j] == nb || (*columns[start_c][j]) == nb || (*regions[start_r][j]) == nb)
+        //{ // check the content of the line, column and region
+        //     sum++;
+        // }
+        if (lines[start_l][j] == nb)
+        {
+            sum++;
+        }
+        if (*columns[start_c][j] == nb)
+        {
+            sum++;
+        }
+        if (*regions[start_r][j] == nb)
+        {
+            sum++;
+        }
+    }
+
+    return sum - 3;
+}
+
+/// @brief Checks the total amount of constraints violated of every non fixed cell in the provided grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of constraints violated in the given sudoku
+int sudoku_constraints(int **original_grid, int **lines, int ***columns, int ***regions)
+{
+    int sum = 0;
+#if _DEBUG_
+    int constraints[9][9];
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            constraints[i][j] = 0;
+        }
+    }
+#endif
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            if (original_grid[i][j] == 0)
+            {
+                sum += sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
+#if _DEBUG_
+                constraints[i][j] = sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
+#endif
+            }
+        }
+    }
+#if _DEBUG_
+    printf("-------------------[\n");
+    print_sudoku_grid(constraints);
+    printf("]-------------------\n");
+#endif
+    return sum;
+    // return sum / 2;
+}
+
+/// @brief Counts the pairs of cells of the provided grid violating a constraint
+/// @param original_grid the starting grid
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of pairs of cells violating a constraint
+int sudoku_constraints_old(int **original_grid, int **lines, int ***columns, int ***regions)
+{
+    int sum = 0;
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            sum += sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
+        }
+    }
+    return sum / 2;
+}
+
+/// @brief Counts the digits missing from each line, column and region of the provided grid
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the total amount of digits missing from the units of the grid
+int sudoku_missing_digits(int **lines, int ***columns, int ***regions)
+{
+    int sum = 0;
+    for (int u = 0; u < SUDOKU_SIZE; u++)
+    {
+        bool line[SUDOKU_SIZE + 1] = {false}, column[SUDOKU_SIZE + 1] = {false}, region[SUDOKU_SIZE + 1] = {false};
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            line[lines[u][j]] = true;
+            column[*columns[u][j]] = true;
+            region[*regions[u][j]] = true;
+        }
+        for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+            sum += !line[nb] + !column[nb] + !region[nb];
+    }
+    return sum;
+}
+
+/// @brief Initializes a cost model
+/// @param model the cost model
+/// @param kind the cost function used
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param weights the weight of each unit, NULL for the unweighted cost
+void cost_model_init(struct cost_model *model, enum cost_function kind, int **original_grid, int *weights)
+{
+    model->kind = kind;
+    model->original_grid = original_grid;
+    model->weights = weights;
+}
+
+/// @brief Finds the cost function corresponding to the given name
+/// @param name the name of the cost function (pairs, free or missing)
+/// @param kind the corresponding cost function
+/// @return true if the name is a known cost function, false otherwise
+bool cost_function_parse(const char *name, enum cost_function *kind)
+{
+    for (enum cost_function k = COST_PAIRS; k < COST_FUNCTIONS; k++)
+    {
+        if (strcmp(name, cost_function_name(k)) == 0)
+        {
+            *kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Gets the name of the given cost function
+/// @param kind the cost function
+/// @return the name of the cost function
+const char *cost_function_name(enum cost_function kind)
+{
+    switch (kind)
+    {
+    case COST_FREE_CELLS:
+        return "free";
+    case COST_MISSING:
+        return "missing";
+    default:
+        return "pairs";
+    }
+}
+
+/// @brief Gets the line and column indexes of the k-th cell of the given unit
+/// @param unit the unit (see line_unit, column_unit and region_unit)
+/// @param k the index of the cell in the unit
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+void sudoku_unit_cell(int unit, int k, int *line, int *column)
+{
+    if (unit < column_unit(0))
+    {
+        *line = unit;
+        *column = k;
+    }
+    else if (unit < region_unit(0))
+    {
+        *line = k;
+        *column = unit - column_unit(0);
+    }
+    else
+    {
+        int region = unit - region_unit(0);
+        *line = (region / 3) * 3 + k / 3;
+        *column = (region % 3) * 3 + k % 3;
+    }
+}
+
+/// @brief Calculates the cost of each unit (line, column and region) of the grid for the cost function of the model,
+///        the cost of the grid is the sum of the costs of its units
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param costs the cost of each unit
+void sudoku_unit_costs(int **lines, int ***columns, int ***regions, struct cost_model *model, int costs[UNITS])
+{
+    for (int u = 0; u < UNITS; u++)
+    {
+        int values[SUDOKU_SIZE], count[SUDOKU_SIZE + 1] = {0};
+        bool fixed[SUDOKU_SIZE];
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+        {
+            int l, c;
+            sudoku_unit_cell(u, k, &l, &c);
+            values[k] = lines[l][c];
+            fixed[k] = (model->original_grid[l][c] != 0);
+            count[values[k]]++;
+        }
+
+        costs[u] = 0;
+        switch (model->kind)
+        {
+        case COST_FREE_CELLS: // each non fixed cell is in conflict with the other cells holding its digit
+            for (int k = 0; k < SUDOKU_SIZE; k++)
+            {
+                if (!fixed[k] && values[k] != 0)
+                    costs[u] += count[values[k]] - 1;
+            }
+            break;
+        case COST_MISSING:
+            for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+                costs[u] += (count[nb] == 0);
+            break;
+        default: // each pair of cells holding the same digit
+            for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+                costs[u] += count[nb] * (count[nb] - 1) / 2;
+            break;
+        }
+    }
+}
+
+/// @brief Calculates the cost of the provided grid for the cost function of the model, weighted by the weight of each unit if any
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @return the cost of the grid
+int sudoku_cost(int **lines, int ***columns, int ***regions, struct cost_model *model)
+{
+    if (model->weights != NULL)
+    {
+        int costs[UNITS];
+        int sum = 0;
+
+        sudoku_unit_costs(lines, columns, regions, model, costs);
+        for (int u = 0; u < UNITS; u++)
+            sum += model->weights[u] * costs[u];
+        return sum;
+    }
+
+    switch (model->kind)
+    {
+    case COST_FREE_CELLS:
+        return sudoku_constraints(model->original_grid, lines, columns, regions);
+    case COST_MISSING:
+        return sudoku_missing_digits(lines, columns, regions);
+    default:
+        return sudoku_constraints_old(model->original_grid, lines, columns, regions);
+    }
+}
+
+/// @brief Calculates the change of the cost of the grid if the given non fixed cell took the given number (the cell isn't modified).
+///        The occurences of the old and new numbers in the line, column and region of the cell are counted in a single pass,
+///        the change of the cost of each of the three units only depends on them
+/// @param nb the new number of the cell
+/// @param start_l the line index of the cell
+/// @param start_c the column index of the cell
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @return the change of the cost
+int sudoku_cell_delta(int nb, int start_l, int start_c, int **lines, int ***columns, int ***regions, struct cost_model *model)
+{
+    int old = lines[start_l][start_c];
+    if (nb == old)
+        return 0;
+
+    int start_r = (start_l / 3) * 3 + (start_c / 3); // gets the specific region to check inside
+    int old_count[3] = {0}, new_count[3] = {0};
+    for (int j = 0; j < SUDOKU_SIZE; j++)
+    {
+        old_count[0] += (lines[start_l][j] == old);
+        new_count[0] += (lines[start_l][j] == nb);
+        old_count[1] += (*columns[start_c][j] == old);
+        new_count[1] += (*columns[start_c][j] == nb);
+        old_count[2] += (*regions[start_r][j] == old);
+        new_count[2] += (*regions[start_r][j] == nb);
+    }
+
+    // the free cost function also depends on the non fixed cells holding the old and new numbers
+    int old_free[3] = {0}, new_free[3] = {0};
+    if (model->kind == COST_FREE_CELLS)
+    {
+        int **original_grid = model->original_grid;
+        int r_line = (start_r / 3) * 3, r_column = (start_r % 3) * 3;
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            bool free_cells[3] = {original_grid[start_l][j] == 0, original_grid[j][start_c] == 0, original_grid[r_line + j / 3][r_column + j % 3] == 0};
+            int values[3] = {lines[start_l][j], *columns[start_c][j], *regions[start_r][j]};
+            for (int u = 0; u < 3; u++)
+            {
+                old_free[u] += (free_cells[u] && values[u] == old);
+                new_free[u] += (free_cells[u] && values[u] == nb);
+            }
+        }
+    }
+
+    int units[3] = {line_unit(start_l), column_unit(start_c), region_unit(start_r)};
+    int delta = 0;
+    for (int u = 0; u < 3; u++)
+    {
+        // the cell itself holds the old number, it is neither one of the others holding it nor in conflict with itself
+        int others = old_count[u] - 1;
+        int unit_delta;
+        switch (model->kind)
+        {
+        case COST_FREE_CELLS: // the cell's own conflicts change, and so do the ones of the non fixed cells holding either number
+            unit_delta = new_count[u] + new_free[u] - others - (old_free[u] - 1);
+            break;
+        case COST_MISSING: // the old number goes missing if the cell was its only occurence, the new one is no longer missing
+            unit_delta = (others == 0) - (new_count[u] == 0);
+            break;
+        default: // the pairs with the cells holding the old number are replaced by the ones with the cells holding the new one
+            unit_delta = new_count[u] - others;
+            break;
+        }
+        delta += (model->weights != NULL) ? model->weights[units[u]] * unit_delta : unit_delta;
+    }
+
+    return delta;
+}
+
+/// @brief Calculates the change of the cost of the grid for every number the given non fixed cell could take (the cell isn't modified).
+///        The occurences of every number in the line, column and region of the cell are counted in a single pass, then the
+///        cost of the three units with the cell holding each number is evaluated for all the numbers at once
+/// @param start_l the line index of the cell
+/// @param start_c the column index of the cell
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param deltas the change of the cost for each number from 1 to SUDOKU_SIZE (0 for the current number of the cell)
+void sudoku_cell_deltas(int start_l, int start_c, int **lines, int ***columns, int ***regions, struct cost_model *model, int deltas[SUDOKU_SIZE + 1])
+{
+    int old = lines[start_l][start_c];
+    int start_r = (start_l / 3) * 3 + (start_c / 3); // gets the specific region to check inside
+    int r_line = (start_r / 3) * 3, r_column = (start_r % 3) * 3;
+    int units[3] = {line_unit(start_l), column_unit(start_c), region_unit(start_r)};
+
+    // occurences of each number in the three units without the cell itself, and among their non fixed cells for the free cost function
+    int count[3][SUDOKU_SIZE + 1] = {{0}}, free_count[3][SUDOKU_SIZE + 1] = {{0}};
+    for (int j = 0; j < SUDOKU_SIZE; j++)
+    {
+        count[0][lines[start_l][j]]++;
+        count[1][*columns[start_c][j]]++;
+        count[2][*regions[start_r][j]]++;
+    }
+    for (int u = 0; u < 3; u++)
+        count[u][old]--;
+    if (model->kind == COST_FREE_CELLS)
+    {
+        int **original_grid = model->original_grid;
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            free_count[0][lines[start_l][j]] += (original_grid[start_l][j] == 0);
+            free_count[1][*columns[start_c][j]] += (original_grid[j][start_c] == 0);
+            free_count[2][*regions[start_r][j]] += (original_grid[r_line + j / 3][r_column + j % 3] == 0);
+        }
+        for (int u = 0; u < 3; u++)
+            free_count[u][old]--;
+    }
+
+    // the part of the cost depending on the number of the cell, for every number at once (see sudoku_cell_delta)
+    int energy[SUDOKU_SIZE + 1] = {0};
+    for (int u = 0; u < 3; u++)
+    {
+        int weight = (model->weights != NULL) ? model->weights[units[u]] : 1;
+        switch (model->kind)
+        {
+        case COST_FREE_CELLS:
+            for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+                energy[nb] += weight * (count[u][nb] + free_count[u][nb]);
+            break;
+        case COST_MISSING:
+            for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+                energy[nb] -= weight * (count[u][nb] == 0);
+            break;
+        default:
+            for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+                energy[nb] += weight * count[u][nb];
+            break;
+        }
+    }
+
+    deltas[0] = 0;
+    for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+        deltas[nb] = energy[nb] - energy[old];
+}
+
+/// @brief Sets the weight of every unit to 1, the weighted cost is then the unweighted one
+/// @param weights the weight of each unit
+void sudoku_weights_init(int *weights)
+{
+    for (int u = 0; u < UNITS; u++)
+        weights[u] = 1;
+}
+
+/// @brief Raises the weight of every unit still violating a constraint by WEIGHT_INCREMENT
+/// @param model the cost model, with the weight of each unit
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @return the number of units whose weight was raised
+int sudoku_weights_bump(struct cost_model *model, int **lines, int ***columns, int ***regions)
+{
+    int costs[UNITS];
+    int bumped = 0;
+
+    sudoku_unit_costs(lines, columns, regions, model, costs);
+    for (int u = 0; u < UNITS; u++)
+    {
+        if (costs[u] > 0)
+        {
+            model->weights[u] += WEIGHT_INCREMENT;
+            bumped++;
+        }
+    }
+
+    return bumped;
+}
+
+/// @brief Decays the weight of every unit towards 1 by the WEIGHT_DECAY factor
+/// @param weights the weight of each unit
+void sudoku_weights_decay(int *weights)
+{
+    for (int u = 0; u < UNITS; u++)
+        weights[u] = 1 + (int)((weights[u] - 1) * WEIGHT_DECAY);
+}
+
+/// @brief Prints the configuration of the cost function of the sudoku solving algorithm
+/// @param model the cost model
+void print_cost_config(struct cost_model *model)
+{
+    switch (model->kind)
+    {
+    case COST_FREE_CELLS:
+        printf("  %s>[COST_FUNCTION]Cost function:%s %sconstraints violated by the non fixed cells (free)%s\n", CLR_YEL, CLR_RESET, CLR_GRN, CLR_RESET);
+        break;
+    case COST_MISSING:
+        printf("  %s>[COST_FUNCTION]Cost function:%s %sdigits missing from each line, column and region (missing)%s\n", CLR_YEL, CLR_RESET, CLR_GRN, CLR_RESET);
+        break;
+    default:
+        printf("  %s>[COST_FUNCTION]Cost function:%s %spairs of cells violating a constraint (pairs)%s\n", CLR_YEL, CLR_RESET, CLR_GRN, CLR_RESET);
+        break;
+    }
+
+    if (model->weights != NULL)
+    {
+        printf("  %s>[WEIGHTING]Weight the constraints of each line, column and region:%s %sON%s", CLR_YEL, CLR_RESET, CLR_GRN, CLR_RESET);
+        printf(" (+%d at each local minimum, decay of %.2f every %d raises)\n", WEIGHT_INCREMENT, WEIGHT_DECAY, WEIGHT_DECAY_PERIOD);
+    }
+    else
+        printf("  %s>[WEIGHTING]Weight the constraints of each line, column and region:%s %sOFF%s\n", CLR_YEL, CLR_RESET, CLR_RED, CLR_RESET);
+}
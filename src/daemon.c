@@ -0,0 +1,198 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+
+#include <omp.h>
+
+#include "solver.h"
+#include "server.h"
+
+// the daemon stopped by the signals
+static struct sudoku_server server;
+
+/// @brief Stops the daemon, the puzzles being solved are still answered
+/// @param signal the signal received
+static void stop_handler(int signal)
+{
+    (void)signal;
+    sudoku_server_stop(&server);
+}
+
+/// @brief Prints how to use the solver daemon
+/// @param program the name of the program
+void print_usage(char *program)
+{
+    fprintf(stderr, "Use: %s Flags socket\n", program);
+    fprintf(stderr, "Where :\n");
+    fprintf(stderr, "  socket      : The path of the UNIX socket the puzzles are received on (see the client program)\n");
+    fprintf(stderr, "Flags :\n");
+    fprintf(stderr, "  -t workers  : Number of puzzles solved at once (default %d)\n", omp_get_max_threads());
+    fprintf(stderr, "  -C file     : Look the puzzles up in this solution cache before solving them, and add the new solutions to it\n");
+    fprintf(stderr, "  -D seconds  : Deadline of the puzzles sent without one, the best grid found is answered once it expires\n");
+    fprintf(stderr, "  -f function : Cost function, one of pairs, free or missing (default %s)\n", COST_FUNCTION);
+    fprintf(stderr, "  -i init     : Initial grid of each try, one of random, box, greedy or presolved (default %s)\n", INITIALIZER);
+    fprintf(stderr, "  -s order    : Order of the cells changed, one of random, sequential, box or permutation (default %s)\n", SWEEP_ORDER);
+    fprintf(stderr, "  -k tries    : Number of new values proposed at once for a cell (multiple-try Metropolis, default %d)\n", MULTIPLE_TRIES);
+    fprintf(stderr, "  -d          : Tighten the candidates of each cell and promote the forced cells to fixed cells during the run,\n");
+    fprintf(stderr, "                the candidates the tries don't hold are tested by propagation and removed if refuted\n");
+    fprintf(stderr, "  -r strategy : Restart strategy, one of fixed, luby, geometric or plateau (default %s)\n", RESTART_STRATEGY);
+    fprintf(stderr, "  -p fraction : Restart from the best sudoku found with this fraction of its cells randomized (default %.2f)\n", RESTART_PERTURBATION);
+    fprintf(stderr, "  -w          : Weight the constraints of each line, column and region (breakout)\n");
+    fprintf(stderr, "  -c proba    : Probability of a move to rotate three cells of a region (default %.2f)\n", CYCLE_PROBABILITY);
+    fprintf(stderr, "  -e proba    : Probability of a move to be an ejection chain (default %.2f)\n", CHAIN_PROBABILITY);
+    fprintf(stderr, "  -a          : Adapt the probabilities of the moves during the run, starting from the ones given\n");
+    fprintf(stderr, "  -m          : Solve with the memetic engine (population of grids with crossover) instead of restarts\n");
+    fprintf(stderr, "The daemon stops on SIGTERM or SIGINT, once the puzzles being solved are answered\n");
+}
+
+/// @brief Main function of the solver daemon: a warm pool of workers solving the puzzles sent on a UNIX socket
+/// @param argc number of arguments
+/// @param argv arguments
+/// @return EXIT_SUCCESS once stopped
+int main(int argc, char *argv[])
+{
+    struct solver_options options;
+    int workers = omp_get_max_threads();
+    char *cache_file = NULL;
+    struct solution_cache cache;
+    int option;
+
+    solver_options_init(&options);
+    while ((option = getopt(argc, argv, "t:C:D:f:i:s:k:dr:p:wc:e:am")) != -1)
+    {
+        switch (option)
+        {
+        case 't':
+            workers = atoi(optarg);
+            if (workers < 1)
+            {
+                fprintf(stderr, "The number of puzzles solved at once must be at least 1\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'C':
+            cache_file = optarg;
+            break;
+        case 'D':
+            options.deadline = atof(optarg);
+            if (options.deadline <= 0)
+            {
+                fprintf(stderr, "The deadline of the solving must be a positive number of seconds\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'f':
+            if (!cost_function_parse(optarg, &options.cost_function))
+            {
+                fprintf(stderr, "Unknown cost function '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'i':
+            if (!sudoku_initializer_parse(optarg, &options.initializer))
+            {
+                fprintf(stderr, "Unknown initializer '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            if (!sweep_order_parse(optarg, &options.sweep_order))
+            {
+                fprintf(stderr, "Unknown sweep order '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'k':
+            options.multiple_tries = atoi(optarg);
+            if (options.multiple_tries < 1 || options.multiple_tries > MULTIPLE_TRIES_MAX)
+            {
+                fprintf(stderr, "The number of new values proposed for a cell must be between 1 and %d\n", MULTIPLE_TRIES_MAX);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'd':
+            options.tightening = true;
+            break;
+        case 'r':
+            if (!restart_strategy_parse(optarg, &options.strategy))
+            {
+                fprintf(stderr, "Unknown restart strategy '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'p':
+            options.perturbation = atof(optarg);
+            if (options.perturbation < 0 || options.perturbation > 1)
+            {
+                fprintf(stderr, "The restart perturbation must be between 0 and 1\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'w':
+            options.weighting = true;
+            break;
+        case 'c':
+            options.cycle_probability = atof(optarg);
+            break;
+        case 'e':
+            options.chain_probability = atof(optarg);
+            break;
+        case 'a':
+            options.adaptive = true;
+            break;
+        case 'm':
+            options.memetic = true;
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.cycle_probability < 0 || options.chain_probability < 0 || options.cycle_probability + options.chain_probability > 1)
+    {
+        fprintf(stderr, "The probabilities of the compound moves must be positive and add up to at most 1\n");
+        exit(EXIT_FAILURE);
+    }
+    if (argc - optind < 1)
+    {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (cache_file != NULL)
+    {
+        solution_cache_open(&cache, cache_file);
+        options.cache = &cache;
+    }
+    sudoku_server_open(&server, argv[optind], &options, workers);
+
+    // the signals only wake up the polling thread, the workers finish their puzzle
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop_handler;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGINT, &action, NULL);
+
+    fprintf(stderr, "#Daemon listening on %s with %d workers\n", argv[optind], workers);
+    sudoku_server_run(&server);
+
+    struct protocol_counters counters;
+    sudoku_server_counters(&server, &counters);
+    sudoku_server_close(&server);
+    if (cache_file != NULL)
+        solution_cache_close(&cache);
+
+    fprintf(stderr, ">> Puzzles answered : %lu/%lu (%lu solved, %lu from the solution cache, %lu errors, %lu answers dropped)\n",
+            (unsigned long)counters.answered, (unsigned long)counters.requests, (unsigned long)counters.solved,
+            (unsigned long)counters.cached, (unsigned long)counters.errors, (unsigned long)counters.dropped);
+    fprintf(stderr, ">> Time spent solving : %f/%f seconds\n", counters.busy, counters.uptime);
+    return EXIT_SUCCESS;
+}
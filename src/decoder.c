@@ -0,0 +1,235 @@
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <zlib.h>
+
+#include "decoder.h"
+
+/// @brief Finds the compression of an input from its first bytes
+/// @param bytes the first bytes of the input
+/// @param n the number of bytes given, an input shorter than the magic of a compression isn't compressed
+/// @return the compression of the input, COMPRESSION_NONE if it isn't compressed
+enum compression compression_detect(const unsigned char *bytes, size_t n)
+{
+    static const unsigned char gzip_magic[] = {0x1f, 0x8b};
+    static const unsigned char zstd_magic[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+    if (n >= sizeof(gzip_magic) && memcmp(bytes, gzip_magic, sizeof(gzip_magic)) == 0)
+        return COMPRESSION_GZIP;
+    if (n >= sizeof(zstd_magic) && memcmp(bytes, zstd_magic, sizeof(zstd_magic)) == 0)
+        return COMPRESSION_ZSTD;
+    return COMPRESSION_NONE;
+}
+
+/// @brief Gets the name of the given compression
+/// @param kind the compression
+/// @return the name of the compression
+const char *compression_name(enum compression kind)
+{
+    switch (kind)
+    {
+    case COMPRESSION_GZIP:
+        return "gzip";
+    case COMPRESSION_ZSTD:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+/// @brief Writes a whole buffer to a pipe
+/// @param fd the pipe
+/// @param buffer the buffer
+/// @param size the size of the buffer
+/// @return true if the buffer was written, false if the pipe was closed by its reader
+static bool write_all(int fd, const unsigned char *buffer, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, buffer, size);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        buffer += written;
+        size -= written;
+    }
+    return true;
+}
+
+/// @brief Decodes a gzip input (one or more concatenated members) to the pipe of the decoder, run by the background thread
+/// @param decoder the decoder
+static void stream_decoder_gzip(struct stream_decoder *decoder)
+{
+    unsigned char in[DECODER_CHUNK], out[DECODER_CHUNK];
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, 15 + 16) != Z_OK) // gzip header only
+    {
+        decoder->failed = true;
+        return;
+    }
+
+    // the prefix is decoded first, then the rest of the input
+    memcpy(in, decoder->prefix, decoder->prefixed);
+    z.avail_in = decoder->prefixed;
+    z.next_in = in;
+
+    int status = Z_OK;
+    bool open = true; // if the reader of the pipe still reads it
+    while (open)
+    {
+        if (z.avail_in == 0)
+        {
+            z.avail_in = fread(in, 1, sizeof(in), decoder->input);
+            z.next_in = in;
+            if (z.avail_in == 0)
+                break;
+        }
+        if (status == Z_STREAM_END)
+        { // another member follows
+            inflateReset(&z);
+        }
+
+        do
+        {
+            z.next_out = out;
+            z.avail_out = sizeof(out);
+            status = inflate(&z, Z_NO_FLUSH);
+            if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+            {
+                fprintf(stderr, "ERROR: corrupted gzip input (%s)\n", (z.msg != NULL) ? z.msg : "inflate");
+                decoder->failed = true;
+                open = false;
+                break;
+            }
+            if (!write_all(decoder->pipe, out, sizeof(out) - z.avail_out))
+                open = false;
+        } while (open && z.avail_out == 0 && status != Z_STREAM_END);
+    }
+
+    if (open && status != Z_STREAM_END)
+    {
+        fprintf(stderr, "ERROR: truncated gzip input\n");
+        decoder->failed = true;
+    }
+    inflateEnd(&z);
+}
+
+/// @brief Feeds the input to the decoding process through the given pipe, run by the background thread
+/// @param decoder the decoder
+/// @param feed the write end of the pipe read by the decoding process
+static void stream_decoder_feed(struct stream_decoder *decoder, int feed)
+{
+    unsigned char in[DECODER_CHUNK];
+    size_t size;
+    if (write_all(feed, decoder->prefix, decoder->prefixed))
+        while ((size = fread(in, 1, sizeof(in), decoder->input)) > 0 && write_all(feed, in, size))
+            ;
+    close(feed);
+}
+
+/// @brief The background thread of the decoder
+/// @param argument the decoder
+/// @return NULL
+static void *stream_decoder_run(void *argument)
+{
+    struct stream_decoder *decoder = (struct stream_decoder *)argument;
+
+    // a reader closing the pipe early stops the decoding with EPIPE instead of killing the program
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+    if (decoder->kind == COMPRESSION_GZIP)
+    {
+        stream_decoder_gzip(decoder);
+        close(decoder->pipe);
+    }
+    else
+        stream_decoder_feed(decoder, decoder->pipe);
+    return NULL;
+}
+
+/// @brief Starts decoding a compressed input on a background thread, the decoded bytes are read from the output of the decoder
+/// @param decoder the decoder
+/// @param input the compressed input, from its start or right after the given prefix
+/// @param kind the compression of the input
+/// @param prefix the first bytes of the input, already read from it (a pipe can't be rewound), NULL if none
+/// @param prefixed the number of bytes of the prefix, at most COMPRESSION_MAGIC_SIZE
+void stream_decoder_open(struct stream_decoder *decoder, FILE *input, enum compression kind, const unsigned char *prefix,
+                         size_t prefixed)
+{
+    int decoded[2];
+    decoder->kind = kind;
+    decoder->input = input;
+    decoder->prefixed = (prefix != NULL && prefixed <= COMPRESSION_MAGIC_SIZE) ? prefixed : 0;
+    if (decoder->prefixed > 0)
+        memcpy(decoder->prefix, prefix, decoder->prefixed);
+    decoder->process = -1;
+    decoder->failed = false;
+
+    if (pipe2(decoded, O_CLOEXEC) == -1 || (decoder->output = fdopen(decoded[0], "rb")) == NULL)
+    {
+        perror("Problem encountered when creating the pipe of the decoder");
+        exit(EXIT_FAILURE);
+    }
+    decoder->pipe = decoded[1];
+
+    if (kind == COMPRESSION_ZSTD)
+    { // no zstd library here: the ZSTD_COMMAND program decodes the input fed by the background thread into the pipe
+        int feed[2];
+        if (pipe2(feed, O_CLOEXEC) == -1 || (decoder->process = fork()) == -1)
+        {
+            perror("Problem encountered when starting the zstd decoder");
+            exit(EXIT_FAILURE);
+        }
+        if (decoder->process == 0)
+        {
+            dup2(feed[0], STDIN_FILENO);
+            dup2(decoded[1], STDOUT_FILENO);
+            execlp(ZSTD_COMMAND, ZSTD_COMMAND, "-dcq", (char *)NULL);
+            perror("Problem encountered when running " ZSTD_COMMAND);
+            _exit(127);
+        }
+        close(feed[0]);
+        close(decoded[1]); // only the process writes the decoded bytes
+        decoder->pipe = feed[1];
+    }
+
+    if (pthread_create(&decoder->thread, NULL, stream_decoder_run, decoder) != 0)
+    {
+        fprintf(stderr, "ERROR: unable to start the thread of the decoder\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/// @brief Stops the decoder, the output is closed (the input isn't) and the background thread joined
+/// @param decoder the decoder
+/// @return true if the part of the input read was decoded without error, false if it is corrupted or truncated
+bool stream_decoder_close(struct stream_decoder *decoder)
+{
+    // closing the read end first stops a decoding that is still running
+    fclose(decoder->output);
+    decoder->output = NULL;
+    pthread_join(decoder->thread, NULL);
+
+    if (decoder->process > 0)
+    {
+        int status;
+        while (waitpid(decoder->process, &status, 0) == -1 && errno == EINTR)
+            ;
+        // the process is killed by SIGPIPE when the output was closed before the end of the input
+        if (WIFEXITED(status) && WEXITSTATUS(status) != 0)
+            decoder->failed = true;
+        decoder->process = -1;
+    }
+    return !decoder->failed;
+}
@@ -0,0 +1,442 @@
+#include "domains.h"
+#include "cost.h"
+#include "utils.h"
+
+/// @brief Counts the candidates of a domain
+/// @param domain the domain
+/// @return the number of candidates
+static int domain_size(int domain)
+{
+    return __builtin_popcount(domain);
+}
+
+/// @brief Initializes the domains of the cells from the givens and promotes the cells forced by them
+/// @param domains the domains of the cells
+/// @param original_grid the starting grid
+/// @return false if the grid of the fixed cells couldn't be allocated, true otherwise
+bool cell_domains_init(struct cell_domains *domains, int **original_grid)
+{
+    domains->givens = original_grid;
+    if ((domains->fixed = create_sudoku_lines(original_grid)) == NULL)
+        return false;
+    domains->promoted = 0;
+    domains->rejected = 0;
+    domains->rounds = 0;
+    domains->stable = false;
+    domains->probed = 0;
+    domains->refuted = 0;
+    domains->cursor = 0;
+    memset(domains->tested, 0, sizeof(domains->tested));
+
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+            domains->domain[i][j] = (original_grid[i][j] != 0) ? 1 << original_grid[i][j] : DOMAIN_ALL;
+    }
+
+    // the givens remove their number from the domains of the other cells of their line, column and region
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            if (original_grid[i][j] == 0)
+                continue;
+            int r_line = (i / 3) * 3, r_column = (j / 3) * 3;
+            int mask = ~(1 << original_grid[i][j]);
+            for (int k = 0; k < SUDOKU_SIZE; k++)
+            {
+                if (original_grid[i][k] == 0)
+                    domains->domain[i][k] &= mask;
+                if (original_grid[k][j] == 0)
+                    domains->domain[k][j] &= mask;
+                if (original_grid[r_line + k / 3][r_column + k % 3] == 0)
+                    domains->domain[r_line + k / 3][r_column + k % 3] &= mask;
+            }
+        }
+    }
+
+    cell_domains_propagate(domains);
+    return true;
+}
+
+/// @brief Frees the grid of the fixed cells of the domains
+/// @param domains the domains of the cells
+void cell_domains_free(struct cell_domains *domains)
+{
+    sudoku_free(domains->fixed);
+    domains->fixed = NULL;
+}
+
+/// @brief Promotes the given cell to a fixed cell holding the given number, after checking that the number doesn't conflict
+///        with the givens of the original grid nor with the cells already fixed. The number is removed from the domains
+///        of the other cells of its line, column and region
+/// @param domains the domains of the cells
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param nb the number of the cell
+/// @return true if the cell was promoted, false if the promotion was rejected
+bool cell_domains_promote(struct cell_domains *domains, int line, int column, int nb)
+{
+    int r_line = (line / 3) * 3, r_column = (column / 3) * 3;
+
+    // a given is never changed and the number must not appear among the givens and fixed cells of the line, column and region
+    bool valid = (domains->givens[line][column] == 0 && domains->fixed[line][column] == 0 && nb >= 1 && nb <= SUDOKU_SIZE);
+    for (int k = 0; k < SUDOKU_SIZE && valid; k++)
+    {
+        int l = r_line + k / 3, c = r_column + k % 3;
+        if (domains->givens[line][k] == nb || domains->givens[k][column] == nb || domains->givens[l][c] == nb ||
+            domains->fixed[line][k] == nb || domains->fixed[k][column] == nb || domains->fixed[l][c] == nb)
+            valid = false;
+    }
+    if (!valid)
+    {
+        domains->rejected++;
+        return false;
+    }
+
+    domains->fixed[line][column] = nb;
+    domains->domain[line][column] = 1 << nb;
+    domains->promoted++;
+
+    int mask = ~(1 << nb);
+    for (int k = 0; k < SUDOKU_SIZE; k++)
+    {
+        if (domains->fixed[line][k] == 0)
+            domains->domain[line][k] &= mask;
+        if (domains->fixed[k][column] == 0)
+            domains->domain[k][column] &= mask;
+        if (domains->fixed[r_line + k / 3][r_column + k % 3] == 0)
+            domains->domain[r_line + k / 3][r_column + k % 3] &= mask;
+    }
+
+    return true;
+}
+
+/// @brief Promotes every cell forced by the domains: a single candidate left in the cell (naked single) or a single cell left
+///        for a number in a line, column or region (hidden single), until no cell is forced anymore
+/// @param domains the domains of the cells
+/// @return the number of cells promoted
+int cell_domains_propagate(struct cell_domains *domains)
+{
+    int promoted = 0;
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = false;
+
+        // naked singles
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+        {
+            for (int j = 0; j < SUDOKU_SIZE; j++)
+            {
+                int domain = domains->domain[i][j];
+                if (domains->fixed[i][j] == 0 && domain_size(domain) == 1 &&
+                    cell_domains_promote(domains, i, j, __builtin_ctz(domain)))
+                {
+                    promoted++;
+                    changed = true;
+                }
+            }
+        }
+
+        // hidden singles
+        for (int unit = 0; unit < UNITS; unit++)
+        {
+            for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+            {
+                int places = 0, line = -1, column = -1;
+                bool placed = false;
+                for (int k = 0; k < SUDOKU_SIZE; k++)
+                {
+                    int l, c;
+                    sudoku_unit_cell(unit, k, &l, &c);
+                    if (domains->fixed[l][c] == nb)
+                        placed = true;
+                    else if (domains->fixed[l][c] == 0 && (domains->domain[l][c] & (1 << nb)))
+                    {
+                        places++;
+                        line = l;
+                        column = c;
+                    }
+                }
+
+                if (!placed && places == 1 && cell_domains_promote(domains, line, column, nb))
+                {
+                    promoted++;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    return promoted;
+}
+
+/// @brief Removes the given candidates from the domain of a non fixed cell
+/// @param domains the domains of the cells
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param candidates the candidates to remove
+/// @return true if the domain changed, false otherwise
+static bool cell_domains_remove(struct cell_domains *domains, int line, int column, int candidates)
+{
+    int domain = domains->domain[line][column];
+    if (domains->fixed[line][column] != 0 || (domain & candidates) == 0 || (domain & ~candidates) == 0)
+        return false; // a domain is never emptied, the grid would have no solution
+    domains->domain[line][column] = domain & ~candidates;
+    return true;
+}
+
+/// @brief Tightening round: removes the candidates excluded by the locked candidates (a number of a region confined to a line or
+///        a column, or the other way round) and the naked pairs of each line, column and region, then promotes the forced cells
+/// @param domains the domains of the cells
+/// @return the number of cells promoted
+int cell_domains_tighten(struct cell_domains *domains)
+{
+    bool removed = false;
+
+    domains->rounds++;
+
+    // locked candidates: the cells of a unit holding a number all belong to a second unit, the number is removed from the rest of it
+    for (int unit = 0; unit < UNITS; unit++)
+    {
+        for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+        {
+            int lines = 0, columns = 0, regions = 0, places = 0;
+            for (int k = 0; k < SUDOKU_SIZE; k++)
+            {
+                int l, c;
+                sudoku_unit_cell(unit, k, &l, &c);
+                if (domains->fixed[l][c] == 0 && (domains->domain[l][c] & (1 << nb)))
+                {
+                    lines |= 1 << l;
+                    columns |= 1 << c;
+                    regions |= 1 << ((l / 3) * 3 + c / 3);
+                    places++;
+                }
+            }
+            if (places < 2)
+                continue;
+
+            // the second unit: the line or column of a region, or the region of a line or column
+            int other = -1;
+            if (unit >= region_unit(0) && domain_size(lines) == 1)
+                other = line_unit(__builtin_ctz(lines));
+            else if (unit >= region_unit(0) && domain_size(columns) == 1)
+                other = column_unit(__builtin_ctz(columns));
+            else if (unit < region_unit(0) && domain_size(regions) == 1)
+                other = region_unit(__builtin_ctz(regions));
+            if (other == -1)
+                continue;
+
+            for (int k = 0; k < SUDOKU_SIZE; k++)
+            {
+                int l, c;
+                sudoku_unit_cell(other, k, &l, &c);
+                bool inside = (lines & (1 << l)) && (columns & (1 << c)) && (regions & (1 << ((l / 3) * 3 + c / 3)));
+                if (!inside && cell_domains_remove(domains, l, c, 1 << nb))
+                    removed = true;
+            }
+        }
+    }
+
+    // naked pairs: two cells of a unit with the same two candidates, no other cell of the unit can hold them
+    for (int unit = 0; unit < UNITS; unit++)
+    {
+        for (int a = 0; a < SUDOKU_SIZE; a++)
+        {
+            int la, ca;
+            sudoku_unit_cell(unit, a, &la, &ca);
+            int pair = domains->domain[la][ca];
+            if (domains->fixed[la][ca] != 0 || domain_size(pair) != 2)
+                continue;
+
+            for (int b = a + 1; b < SUDOKU_SIZE; b++)
+            {
+                int lb, cb;
+                sudoku_unit_cell(unit, b, &lb, &cb);
+                if (domains->fixed[lb][cb] != 0 || domains->domain[lb][cb] != pair)
+                    continue;
+
+                for (int k = 0; k < SUDOKU_SIZE; k++)
+                {
+                    int l, c;
+                    sudoku_unit_cell(unit, k, &l, &c);
+                    if (k != a && k != b && cell_domains_remove(domains, l, c, pair))
+                        removed = true;
+                }
+            }
+        }
+    }
+
+    if (!removed)
+    {
+        domains->stable = true;
+        return 0;
+    }
+    memset(domains->tested, 0, sizeof(domains->tested)); // the candidates tested may now lead to a contradiction
+    return cell_domains_propagate(domains);
+}
+
+/// @brief Checks if the domains have no solution left: a non fixed cell without candidate, or a number with no place left in
+///        a line, column or region
+/// @param domains the domains of the cells
+/// @return true if the domains are in contradiction, false otherwise
+static bool cell_domains_contradiction(struct cell_domains *domains)
+{
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            if (domains->fixed[i][j] == 0 && domains->domain[i][j] == 0)
+                return true;
+        }
+    }
+
+    for (int unit = 0; unit < UNITS; unit++)
+    {
+        int numbers = 0; // the numbers placed or still possible in the unit
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+        {
+            int l, c;
+            sudoku_unit_cell(unit, k, &l, &c);
+            numbers |= (domains->fixed[l][c] != 0) ? 1 << domains->fixed[l][c] : domains->domain[l][c];
+        }
+        if (numbers != DOMAIN_ALL)
+            return true;
+    }
+    return false;
+}
+
+/// @brief Probing round guided by the annealing: the candidates of the non fixed cells that the grid of the try doesn't hold
+///        are the likely wrong ones, up to DOMAIN_PROBES of them not tested yet are assumed one at a time and propagated on a
+///        copy of the domains. A candidate leading to a contradiction can't be part of the solution, it is removed, then the
+///        forced cells are promoted (still verified against the givens)
+/// @param domains the domains of the cells
+/// @param sudoku_grid the grid found by the last try
+/// @return the number of cells promoted
+int cell_domains_probe(struct cell_domains *domains, int **sudoku_grid)
+{
+    int trial_cells[SUDOKU_SIZE][SUDOKU_SIZE];
+    int *trial_fixed[SUDOKU_SIZE];
+    int probes = 0, cell = domains->cursor;
+    bool removed = false;
+
+    for (int n = 0; n < PUZZLE_SIZE && probes < DOMAIN_PROBES; n++)
+    {
+        cell = (domains->cursor + n) % PUZZLE_SIZE;
+        int line = cell / SUDOKU_SIZE, column = cell % SUDOKU_SIZE;
+        if (domains->fixed[line][column] != 0 || domain_size(domains->domain[line][column]) < 2)
+            continue;
+
+        for (int nb = 1; nb <= SUDOKU_SIZE && probes < DOMAIN_PROBES; nb++)
+        {
+            if (!(domains->domain[line][column] & (1 << nb) & ~domains->tested[line][column]) || nb == sudoku_grid[line][column])
+                continue;
+
+            // the number is assumed on a copy of the domains, the givens are shared
+            struct cell_domains trial = *domains;
+            for (int i = 0; i < SUDOKU_SIZE; i++)
+            {
+                memcpy(trial_cells[i], domains->fixed[i], sizeof(trial_cells[i]));
+                trial_fixed[i] = trial_cells[i];
+            }
+            trial.fixed = trial_fixed;
+            probes++;
+
+            bool contradiction = !cell_domains_promote(&trial, line, column, nb);
+            if (!contradiction)
+            {
+                cell_domains_propagate(&trial);
+                contradiction = trial.rejected > domains->rejected || cell_domains_contradiction(&trial);
+            }
+            if (contradiction && cell_domains_remove(domains, line, column, 1 << nb))
+            {
+                domains->refuted++;
+                removed = true;
+            }
+            else
+                domains->tested[line][column] |= 1 << nb;
+        }
+        if (probes < DOMAIN_PROBES)
+            cell = (cell + 1) % PUZZLE_SIZE; // every candidate of the cell was tested
+    }
+    domains->cursor = cell;
+    domains->probed += probes;
+
+    if (!removed)
+        return 0;
+    // the candidates tested may lead to a contradiction with the smaller domains, and the tightening rules may remove more
+    memset(domains->tested, 0, sizeof(domains->tested));
+    domains->stable = false;
+    return cell_domains_propagate(domains);
+}
+
+/// @brief Copies the numbers of the fixed cells into the given grid
+/// @param domains the domains of the cells
+/// @param sudoku_grid the given sudoku grid
+void cell_domains_apply(struct cell_domains *domains, int **sudoku_grid)
+{
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            if (domains->fixed[i][j] != 0)
+                sudoku_grid[i][j] = domains->fixed[i][j];
+        }
+    }
+}
+
+/// @brief Chooses a random number of the domain of the given cell, different from its current number
+/// @param domains the domains of the cells
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param current the current number of the cell
+/// @param seed the seed used in the pseudo random number generator
+/// @return the number chosen
+int cell_domains_value(struct cell_domains *domains, int line, int column, int current, unsigned int *seed)
+{
+    int candidates = domains->domain[line][column] & ~(1 << current);
+    int n = domain_size(candidates);
+    int nb;
+
+    if (n == 0)
+    { // nothing else left in the domain, any other number
+        while ((nb = get_bound_random(seed, 1, SUDOKU_SIZE)) == current)
+            ;
+        return nb;
+    }
+
+    // the k-th candidate of the domain
+    int k = get_bound_random(seed, 0, n - 1);
+    for (nb = 1; nb <= SUDOKU_SIZE; nb++)
+    {
+        if ((candidates & (1 << nb)) && k-- == 0)
+            break;
+    }
+    return nb;
+}
+
+/// @brief Prints the state of the domains of the sudoku solving algorithm
+/// @param domains the domains of the cells
+void cell_domains_print(struct cell_domains *domains)
+{
+    int candidates = 0, free_cells = 0;
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            if (domains->fixed[i][j] == 0)
+            {
+                free_cells++;
+                candidates += domain_size(domains->domain[i][j]);
+            }
+        }
+    }
+
+    printf("  %s>[DOMAINS]Cells promoted to fixed cells:%s %s%d%s", CLR_YEL, CLR_RESET, CLR_GRN, domains->promoted, CLR_RESET);
+    printf(" (%d non fixed cells left with %.2f candidates on average, %d tightening rounds, %d/%d candidates tested refuted,"
+           " %d promotions rejected)\n", free_cells, (free_cells > 0) ? (double)candidates / free_cells : 0.0, domains->rounds,
+           domains->refuted, domains->probed, domains->rejected);
+}
@@ -0,0 +1,327 @@
+#include "initializer.h"
+#include "utils.h"
+
+/// @brief Initializes the grid initializer, the starting grid is presolved once if needed
+/// @param initializer the grid initializer
+/// @param kind the way of filling the grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @return false if the presolved grid couldn't be allocated, true otherwise
+bool grid_initializer_init(struct grid_initializer *initializer, enum sudoku_initializer kind, int **original_grid)
+{
+    initializer->kind = kind;
+    initializer->original_grid = original_grid;
+    initializer->presolved = NULL;
+    initializer->forced = 0;
+
+    if (kind == INIT_PRESOLVED)
+    {
+        if ((initializer->presolved = create_sudoku_lines(original_grid)) == NULL)
+            return false;
+        initializer->forced = sudoku_presolve(initializer->presolved);
+    }
+    return true;
+}
+
+/// @brief Frees the presolved grid of the initializer if any
+/// @param initializer the grid initializer
+void grid_initializer_free(struct grid_initializer *initializer)
+{
+    if (initializer->presolved != NULL)
+    {
+        sudoku_free(initializer->presolved);
+        initializer->presolved = NULL;
+    }
+}
+
+/// @brief Copies the cells of the starting grid fixed since the initializer was initialized into its presolved grid
+/// @param initializer the grid initializer
+void grid_initializer_refresh(struct grid_initializer *initializer)
+{
+    if (initializer->presolved == NULL)
+        return;
+
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            if (initializer->original_grid[i][j] != 0)
+                initializer->presolved[i][j] = initializer->original_grid[i][j];
+        }
+    }
+}
+
+/// @brief Finds the initializer corresponding to the given name
+/// @param name the name of the initializer (random, box, greedy or presolved)
+/// @param kind the corresponding initializer
+/// @return true if the name is a known initializer, false otherwise
+bool sudoku_initializer_parse(const char *name, enum sudoku_initializer *kind)
+{
+    for (enum sudoku_initializer k = INIT_RANDOM; k < INITIALIZERS; k++)
+    {
+        if (strcmp(name, sudoku_initializer_name(k)) == 0)
+        {
+            *kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Gets the name of the given initializer
+/// @param kind the initializer
+/// @return the name of the initializer
+const char *sudoku_initializer_name(enum sudoku_initializer kind)
+{
+    switch (kind)
+    {
+    case INIT_BOX:
+        return "box";
+    case INIT_GREEDY:
+        return "greedy";
+    case INIT_PRESOLVED:
+        return "presolved";
+    default:
+        return "random";
+    }
+}
+
+/// @brief Fills each region of the grid with a random permutation of the digits missing from its fixed cells
+/// @param sudoku_grid the given sudoku grid
+/// @param original_grid the grid whose cells different from 0 are kept
+/// @param seed the randomization seed used
+void sudoku_fill_regions(int ***sudoku_grid, int **original_grid, unsigned int *seed)
+{
+    for (int r = 0; r < SUDOKU_SIZE; r++)
+    {
+        int r_line = (r / 3) * 3, r_column = (r % 3) * 3;
+        bool present[SUDOKU_SIZE + 1] = {false};
+        int missing[SUDOKU_SIZE];
+        int n = 0;
+
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+            present[original_grid[r_line + k / 3][r_column + k % 3]] = true;
+        for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+        {
+            if (!present[nb])
+                missing[n++] = nb;
+        }
+
+        // Fisher-Yates shuffle of the missing digits, then they are placed in the free cells of the region in order
+        for (int k = n - 1; k > 0; k--)
+        {
+            int swap = get_bound_random(seed, 0, k);
+            int temp = missing[k];
+            missing[k] = missing[swap];
+            missing[swap] = temp;
+        }
+
+        int m = 0;
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+        {
+            int line = r_line + k / 3, column = r_column + k % 3;
+            if (original_grid[line][column] == 0)
+                (*sudoku_grid)[line][column] = missing[m++];
+            else
+                (*sudoku_grid)[line][column] = original_grid[line][column];
+        }
+    }
+}
+
+/// @brief Fills the non fixed cells of the grid in a random order, each one with the digit appearing the fewest times
+///        in its line, column and region among the cells already filled (ties are broken at random)
+/// @param sudoku_grid the given sudoku grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param seed the randomization seed used
+void sudoku_fill_greedy(int ***sudoku_grid, int **original_grid, unsigned int *seed)
+{
+    // occurences of each digit in each line, column and region, counting the fixed cells only at first
+    int line_count[SUDOKU_SIZE][SUDOKU_SIZE + 1] = {{0}};
+    int column_count[SUDOKU_SIZE][SUDOKU_SIZE + 1] = {{0}};
+    int region_count[SUDOKU_SIZE][SUDOKU_SIZE + 1] = {{0}};
+    int free_cells[PUZZLE_SIZE];
+    int n = 0;
+
+    for (int cell = 0; cell < PUZZLE_SIZE; cell++)
+    {
+        int line = cell / SUDOKU_SIZE, column = cell % SUDOKU_SIZE;
+        int nb = original_grid[line][column];
+        (*sudoku_grid)[line][column] = nb;
+        if (nb == 0)
+            free_cells[n++] = cell;
+        else
+        {
+            line_count[line][nb]++;
+            column_count[column][nb]++;
+            region_count[(line / 3) * 3 + column / 3][nb]++;
+        }
+    }
+
+    for (int k = n - 1; k > 0; k--)
+    {
+        int swap = get_bound_random(seed, 0, k);
+        int temp = free_cells[k];
+        free_cells[k] = free_cells[swap];
+        free_cells[swap] = temp;
+    }
+
+    for (int k = 0; k < n; k++)
+    {
+        int line = free_cells[k] / SUDOKU_SIZE, column = free_cells[k] % SUDOKU_SIZE;
+        int region = (line / 3) * 3 + column / 3;
+        int best = 0, best_conflicts = 0, ties = 0;
+
+        for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+        {
+            int conflicts = line_count[line][nb] + column_count[column][nb] + region_count[region][nb];
+            if (best == 0 || conflicts < best_conflicts)
+            {
+                best = nb;
+                best_conflicts = conflicts;
+                ties = 1;
+            }
+            else if (conflicts == best_conflicts && get_bound_random(seed, 0, ties++) == 0)
+            { // reservoir sampling keeps each of the tied digits with the same probability
+                best = nb;
+            }
+        }
+
+        (*sudoku_grid)[line][column] = best;
+        line_count[line][best]++;
+        column_count[column][best]++;
+        region_count[region][best]++;
+    }
+}
+
+/// @brief Fills the cells of the grid forced by the other ones (a single candidate left in the cell, or a single cell left
+///        for a digit in a line, column or region) until no cell is forced anymore
+/// @param sudoku_grid the given sudoku grid, its empty cells are 0
+/// @return the number of cells filled
+int sudoku_presolve(int **sudoku_grid)
+{
+    int forced = 0;
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = false;
+
+        // candidates of each empty cell as a bitmask, bit nb is set if nb can still be placed in the cell
+        int candidates[SUDOKU_SIZE][SUDOKU_SIZE];
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+        {
+            for (int j = 0; j < SUDOKU_SIZE; j++)
+            {
+                candidates[i][j] = 0;
+                if (sudoku_grid[i][j] != 0)
+                    continue;
+
+                int used = 0;
+                int r_line = (i / 3) * 3, r_column = (j / 3) * 3;
+                for (int k = 0; k < SUDOKU_SIZE; k++)
+                {
+                    used |= 1 << sudoku_grid[i][k];
+                    used |= 1 << sudoku_grid[k][j];
+                    used |= 1 << sudoku_grid[r_line + k / 3][r_column + k % 3];
+                }
+                candidates[i][j] = ~used & 0x3FE;
+                if (candidates[i][j] == 0)
+                    return forced; // contradiction, the grid has no solution from here: keep what was found
+            }
+        }
+
+        // naked singles: a single candidate left in the cell
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+        {
+            for (int j = 0; j < SUDOKU_SIZE; j++)
+            {
+                int c = candidates[i][j];
+                if (c != 0 && (c & (c - 1)) == 0)
+                {
+                    sudoku_grid[i][j] = __builtin_ctz(c);
+                    forced++;
+                    changed = true;
+                }
+            }
+        }
+        if (changed)
+            continue; // the candidates are outdated
+
+        // hidden singles: a single cell left for a digit in a line, column or region
+        for (int unit = 0; unit < 3 * SUDOKU_SIZE && !changed; unit++)
+        {
+            for (int nb = 1; nb <= SUDOKU_SIZE && !changed; nb++)
+            {
+                int places = 0, line = -1, column = -1;
+                for (int k = 0; k < SUDOKU_SIZE; k++)
+                {
+                    int i, j;
+                    if (unit < SUDOKU_SIZE)
+                    {
+                        i = unit;
+                        j = k;
+                    }
+                    else if (unit < 2 * SUDOKU_SIZE)
+                    {
+                        i = k;
+                        j = unit - SUDOKU_SIZE;
+                    }
+                    else
+                    {
+                        i = ((unit - 2 * SUDOKU_SIZE) / 3) * 3 + k / 3;
+                        j = ((unit - 2 * SUDOKU_SIZE) % 3) * 3 + k % 3;
+                    }
+
+                    if (candidates[i][j] & (1 << nb))
+                    {
+                        places++;
+                        line = i;
+                        column = j;
+                    }
+                }
+
+                if (places == 1)
+                {
+                    sudoku_grid[line][column] = nb;
+                    forced++;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    return forced;
+}
+
+/// @brief Fills the non fixed cells of the grid with the initializer
+/// @param initializer the grid initializer
+/// @param sudoku_grid the given sudoku grid
+/// @param seed the randomization seed used
+void sudoku_initialize(struct grid_initializer *initializer, int ***sudoku_grid, unsigned int *seed)
+{
+    switch (initializer->kind)
+    {
+    case INIT_BOX:
+        sudoku_fill_regions(sudoku_grid, initializer->original_grid, seed);
+        break;
+    case INIT_GREEDY:
+        sudoku_fill_greedy(sudoku_grid, initializer->original_grid, seed);
+        break;
+    case INIT_PRESOLVED: // the forced cells are only a starting point, they can still be changed by the annealing
+        sudoku_fill_regions(sudoku_grid, initializer->presolved, seed);
+        break;
+    default:
+        sudoku_randomize(sudoku_grid, initializer->original_grid, seed);
+        break;
+    }
+}
+
+/// @brief Prints the configuration of the initializer of the sudoku solving algorithm
+/// @param initializer the grid initializer
+void grid_initializer_print(struct grid_initializer *initializer)
+{
+    printf("  %s>[INITIALIZER]Initial grid of each try:%s %s%s%s", CLR_YEL, CLR_RESET, CLR_GRN, sudoku_initializer_name(initializer->kind), CLR_RESET);
+    if (initializer->kind == INIT_PRESOLVED)
+        printf(" (%d cells forced by the presolve)\n", initializer->forced);
+    else
+        printf("\n");
+}
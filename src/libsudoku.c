@@ -0,0 +1,114 @@
+#include <string.h>
+
+#include "libsudoku.h"
+#include "utils.h"
+
+/// @brief Gets the name of the given outcome
+/// @param status the outcome
+/// @return the name of the outcome
+const char *libsudoku_status_name(enum libsudoku_status status)
+{
+    switch (status)
+    {
+    case LIBSUDOKU_OK:
+        return "ok";
+    case LIBSUDOKU_ERROR_ARGUMENT:
+        return "argument";
+    case LIBSUDOKU_ERROR_PUZZLE:
+        return "puzzle";
+    case LIBSUDOKU_ERROR_OPTIONS:
+        return "options";
+    case LIBSUDOKU_ERROR_MEMORY:
+        return "memory";
+    default:
+        return "unknown";
+    }
+}
+
+/// @brief Reads a puzzle given as a string into a grid and checks that no digit is given twice in a unit
+/// @param puzzle the puzzle: 81 digits line by line, '0' or '.' for the empty cells
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @return false if the puzzle isn't valid, true otherwise
+static bool libsudoku_puzzle_read(const char *puzzle, int grid[SUDOKU_SIZE][SUDOKU_SIZE])
+{
+    int lines[SUDOKU_SIZE] = {0}, columns[SUDOKU_SIZE] = {0}, regions[SUDOKU_SIZE] = {0};
+    for (int cell = 0; cell < PUZZLE_SIZE; cell++)
+    {
+        char c = puzzle[cell];
+        if (c != '.' && (c < '0' || c > '9'))
+            return false; // the end of a shorter string too
+        int i = cell / SUDOKU_SIZE, j = cell % SUDOKU_SIZE;
+        grid[i][j] = (c >= '1' && c <= '9') ? c - '0' : 0; // '0' and '.' are empty cells
+        if (grid[i][j] == 0)
+            continue;
+
+        int bit = 1 << grid[i][j], region = (i / SUDOKU_GRID_SIZE) * SUDOKU_GRID_SIZE + j / SUDOKU_GRID_SIZE;
+        if ((lines[i] | columns[j] | regions[region]) & bit)
+            return false;
+        lines[i] |= bit;
+        columns[j] |= bit;
+        regions[region] |= bit;
+    }
+    return puzzle[PUZZLE_SIZE] == '\0';
+}
+
+/// @brief Checks the settings of a solving by the library, as the flags of the programs are checked
+/// @param options the settings
+/// @return false if a setting is out of its range or only fits the programs, true otherwise
+static bool libsudoku_options_valid(const struct solver_options *options)
+{
+    return options->strategy >= RESTART_FIXED && options->strategy <= RESTART_PLATEAU &&
+           options->cost_function >= 0 && options->cost_function < COST_FUNCTIONS &&
+           options->initializer >= 0 && options->initializer < INITIALIZERS &&
+           options->sweep_order >= 0 && options->sweep_order < SWEEP_ORDERS &&
+           options->perturbation >= 0 && options->perturbation <= 1 &&
+           options->cycle_probability >= 0 && options->chain_probability >= 0 &&
+           options->cycle_probability + options->chain_probability <= 1 &&
+           options->multiple_tries >= 1 && options->multiple_tries <= MULTIPLE_TRIES_MAX && options->deadline >= 0 &&
+           options->trace == NULL && options->checkpoint == NULL && !options->resume;
+}
+
+/// @brief Solves a puzzle. Nothing is printed nor logged and the program is never stopped, the state of the call only lives
+///        in the call and in the buffers of the caller: several threads can solve puzzles at once, with the same options
+/// @param puzzle the puzzle: 81 digits line by line, '0' or '.' for the empty cells
+/// @param options the settings of the solving (solver_options_init), the printing settings are left out. A solution cache
+///        may be shared by the calls, a solution that can't be stored in it is still returned. With a deadline, the best grid
+///        found is returned once it expires, the progress callback is called on the calling thread
+/// @param seed the seed of the pseudo random number generator, the same seed and settings make the same run
+/// @param solution the grid found and the outcome of the solving
+/// @return LIBSUDOKU_OK, or the error that stopped the call (the solution is then left as it is)
+enum libsudoku_status libsudoku_solve(const char *puzzle, const struct solver_options *options, unsigned int seed,
+                                      struct libsudoku_solution *solution)
+{
+    if (puzzle == NULL || options == NULL || solution == NULL)
+        return LIBSUDOKU_ERROR_ARGUMENT;
+
+    // the grids live on the stack of the call, the solver only allocates its own working grids
+    int original[SUDOKU_SIZE][SUDOKU_SIZE], found[SUDOKU_SIZE][SUDOKU_SIZE];
+    int *original_grid[SUDOKU_SIZE], *solution_grid[SUDOKU_SIZE];
+    if (!libsudoku_puzzle_read(puzzle, original))
+        return LIBSUDOKU_ERROR_PUZZLE;
+    if (!libsudoku_options_valid(options))
+        return LIBSUDOKU_ERROR_OPTIONS;
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        original_grid[i] = original[i];
+        solution_grid[i] = found[i];
+    }
+
+    struct solver_options settings = *options;
+    settings.verbose = false;
+    settings.quiet = true;
+    char hash[HASH_SIZE + 1] = "libsudoku";
+    struct solver_result result;
+
+    // the solver frees what it allocated when an allocation fails, instead of stopping the program
+    if (sudoku_solve(original_grid, hash, &settings, solution_grid, &seed, &result) == -1)
+        return LIBSUDOKU_ERROR_MEMORY;
+
+    for (int cell = 0; cell < PUZZLE_SIZE; cell++)
+        solution->grid[cell] = '0' + found[cell / SUDOKU_SIZE][cell % SUDOKU_SIZE];
+    solution->grid[PUZZLE_SIZE] = '\0';
+    solution->result = result;
+    return LIBSUDOKU_OK;
+}
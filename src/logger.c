@@ -0,0 +1,308 @@
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "logger.h"
+
+/// @brief The ring buffer of a thread: the thread appends its lines and the background thread of the logger consumes them,
+///        each one only moving its own counter so no lock is needed
+struct log_ring
+{
+    char data[LOGGER_RING_SIZE];
+    _Atomic size_t head;  // the number of bytes appended by the thread
+    _Atomic size_t tail;  // the number of bytes consumed by the background thread
+    _Atomic long dropped; // the number of lines dropped because the ring was full
+};
+
+/// @brief A file kept open by the logger
+struct log_file
+{
+    char name[FILE_SIZE];
+    FILE *fp;           // NULL if the file couldn't be opened, its lines are then dropped
+    unsigned long used; // the last time a line was written to the file, to close the least recently used one
+};
+
+/// @brief The header of a line in a ring, followed by the name of the file and the line
+struct log_entry
+{
+    uint16_t name_length;
+    uint16_t line_length;
+};
+
+static pthread_once_t logger_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t logger_lock = PTHREAD_MUTEX_INITIALIZER;  // guards the registration of the rings
+static pthread_mutex_t logger_drain = PTHREAD_MUTEX_INITIALIZER; // only one thread consumes the rings and writes the files
+static pthread_t logger_thread;
+static _Atomic bool logger_started = false; // if the logger was started and not stopped yet, with or without its thread
+static _Atomic bool logger_running = false; // if the background thread runs
+static _Atomic int logger_rings_count = 0;
+static struct log_ring *logger_rings[LOGGER_THREADS];
+static _Atomic long logger_unregistered = 0; // the lines of the threads left without a ring, dropped
+static struct log_file logger_files[LOGGER_FILES];
+static unsigned long logger_clock = 0;
+
+static __thread struct log_ring *thread_ring = NULL;
+static __thread bool thread_without_ring = false;
+
+/// @brief Copies bytes to a ring from the given position, wrapping around its end
+/// @param ring the ring
+/// @param position the position (number of bytes appended before)
+/// @param bytes the bytes
+/// @param size the number of bytes
+static void log_ring_put(struct log_ring *ring, size_t position, const void *bytes, size_t size)
+{
+    size_t offset = position % LOGGER_RING_SIZE;
+    size_t first = (size < LOGGER_RING_SIZE - offset) ? size : LOGGER_RING_SIZE - offset;
+    memcpy(ring->data + offset, bytes, first);
+    memcpy(ring->data, (const char *)bytes + first, size - first);
+}
+
+/// @brief Copies bytes from a ring from the given position, wrapping around its end
+/// @param ring the ring
+/// @param position the position (number of bytes consumed before)
+/// @param bytes the bytes
+/// @param size the number of bytes
+static void log_ring_get(struct log_ring *ring, size_t position, void *bytes, size_t size)
+{
+    size_t offset = position % LOGGER_RING_SIZE;
+    size_t first = (size < LOGGER_RING_SIZE - offset) ? size : LOGGER_RING_SIZE - offset;
+    memcpy(bytes, ring->data + offset, first);
+    memcpy((char *)bytes + first, ring->data, size - first);
+}
+
+/// @brief Finds the open file of the given name, opening it (and closing the least recently used one) if needed
+/// @param name the name of the file
+/// @return the file, NULL if it couldn't be opened
+static FILE *logger_file(const char *name)
+{
+    struct log_file *oldest = &logger_files[0];
+    logger_clock++;
+    for (int k = 0; k < LOGGER_FILES; k++)
+    {
+        struct log_file *file = &logger_files[k];
+        if (file->used > 0 && strcmp(file->name, name) == 0)
+        {
+            file->used = logger_clock;
+            return file->fp;
+        }
+        if (file->used < oldest->used)
+            oldest = file;
+    }
+
+    if (oldest->fp != NULL)
+        fclose(oldest->fp);
+    strncpy(oldest->name, name, FILE_SIZE - 1);
+    oldest->name[FILE_SIZE - 1] = '\0';
+    oldest->used = logger_clock;
+    if ((oldest->fp = fopen(name, "a")) == NULL)
+        fprintf(stderr, "Can't open file for statistics of sudoku [%s]\n", name);
+    else
+        setvbuf(oldest->fp, NULL, _IOFBF, LOGGER_FILE_BUFFER);
+    return oldest->fp;
+}
+
+/// @brief Writes the lines waiting in every ring to their files, the caller holds logger_drain
+/// @return the number of lines written
+static long logger_drain_rings(void)
+{
+    char name[FILE_SIZE];
+    char line[LOGGER_LINE_SIZE];
+    long lines = 0;
+
+    int rings = atomic_load_explicit(&logger_rings_count, memory_order_acquire);
+    for (int r = 0; r < rings; r++)
+    {
+        struct log_ring *ring = logger_rings[r];
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        while (tail < head)
+        {
+            struct log_entry entry;
+            log_ring_get(ring, tail, &entry, sizeof(entry));
+            log_ring_get(ring, tail + sizeof(entry), name, entry.name_length);
+            log_ring_get(ring, tail + sizeof(entry) + entry.name_length, line, entry.line_length);
+            name[entry.name_length] = '\0';
+            tail += sizeof(entry) + entry.name_length + entry.line_length;
+
+            FILE *fp = logger_file(name);
+            if (fp != NULL)
+                fwrite(line, 1, entry.line_length, fp);
+            lines++;
+        }
+        // the room of the lines written is given back to the thread
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    return lines;
+}
+
+/// @brief Flushes the open files, the caller holds logger_drain
+static void logger_flush_files(void)
+{
+    for (int k = 0; k < LOGGER_FILES; k++)
+    {
+        if (logger_files[k].fp != NULL)
+            fflush(logger_files[k].fp);
+    }
+}
+
+/// @brief The background thread of the logger: writes the lines as they come, and sleeps a while when there is none
+/// @param argument unused
+/// @return NULL
+static void *logger_run(void *argument)
+{
+    (void)argument;
+    struct timespec pause = {0, LOGGER_INTERVAL * 1000000L};
+    while (atomic_load(&logger_running))
+    {
+        pthread_mutex_lock(&logger_drain);
+        long lines = logger_drain_rings();
+        if (lines == 0) // idle, the lines written so far reach the disk
+            logger_flush_files();
+        pthread_mutex_unlock(&logger_drain);
+
+        if (lines == 0)
+            nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+/// @brief Starts the background thread of the logger, the logger is stopped when the program exits. Without the thread, the
+///        lines stay in the rings until the logger is flushed or stopped, the ones past the room of a ring are dropped
+static void logger_start(void)
+{
+    atomic_store(&logger_started, true);
+    atomic_store(&logger_running, true);
+    if (pthread_create(&logger_thread, NULL, logger_run, NULL) != 0)
+    {
+        fprintf(stderr, "WARNING: unable to start the thread of the logger, the lines are written when it stops\n");
+        atomic_store(&logger_running, false);
+    }
+    atexit(logger_stop);
+}
+
+/// @brief Gets the ring of the calling thread, allocated and registered at its first line
+/// @return the ring, NULL if every ring is taken or the ring couldn't be allocated
+static struct log_ring *logger_ring(void)
+{
+    if (thread_ring != NULL || thread_without_ring)
+        return thread_ring;
+
+    pthread_once(&logger_once, logger_start);
+    struct log_ring *ring = (struct log_ring *)calloc(1, sizeof(struct log_ring));
+    if (ring == NULL)
+    { // the lines of the thread are dropped, as when every ring is taken
+        thread_without_ring = true;
+        return NULL;
+    }
+
+    pthread_mutex_lock(&logger_lock);
+    int rings = atomic_load(&logger_rings_count);
+    if (rings < LOGGER_THREADS)
+    {
+        logger_rings[rings] = ring;
+        atomic_store_explicit(&logger_rings_count, rings + 1, memory_order_release);
+        thread_ring = ring;
+    }
+    pthread_mutex_unlock(&logger_lock);
+
+    if (thread_ring == NULL)
+    {
+        free(ring);
+        thread_without_ring = true;
+    }
+    return thread_ring;
+}
+
+/// @brief Appends a line to a file without waiting for the disk: the line is copied to the ring buffer of the calling thread
+///        and written later by the background thread of the logger, which keeps the files open. The logger is started at the
+///        first line and flushed when the program exits. When the ring is full the line is dropped (and counted), or the
+///        thread waits for room with LOGGER_BLOCK
+/// @param filename the file the line is appended to, created if needed
+/// @param format the format of the line, as for printf
+void logger_write(const char *filename, const char *format, ...)
+{
+    struct log_ring *ring = logger_ring();
+    if (ring == NULL)
+    {
+        atomic_fetch_add(&logger_unregistered, 1);
+        return;
+    }
+
+    char line[LOGGER_LINE_SIZE];
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(line, sizeof(line), format, arguments);
+    va_end(arguments);
+    if (length < 0)
+        return;
+
+    struct log_entry entry;
+    entry.name_length = (uint16_t)strnlen(filename, FILE_SIZE - 1);
+    entry.line_length = (uint16_t)((length < (int)sizeof(line)) ? length : (int)sizeof(line) - 1); // truncated lines are kept
+    size_t size = sizeof(entry) + entry.name_length + entry.line_length;
+
+    // only this thread moves the head, the background thread only moves the tail
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (head + size - atomic_load_explicit(&ring->tail, memory_order_acquire) > LOGGER_RING_SIZE)
+    {
+        if (!LOGGER_BLOCK || !atomic_load(&logger_running))
+        { // bounded loss: the line is dropped rather than slowing down the solver
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return;
+        }
+        sched_yield();
+    }
+
+    log_ring_put(ring, head, &entry, sizeof(entry));
+    log_ring_put(ring, head + sizeof(entry), filename, entry.name_length);
+    log_ring_put(ring, head + sizeof(entry) + entry.name_length, line, entry.line_length);
+    atomic_store_explicit(&ring->head, head + size, memory_order_release);
+}
+
+/// @brief Waits until every line logged so far is written to its file
+void logger_flush(void)
+{
+    pthread_mutex_lock(&logger_drain);
+    logger_drain_rings();
+    logger_flush_files();
+    pthread_mutex_unlock(&logger_drain);
+}
+
+/// @brief Gets the number of lines dropped because the ring buffer of their thread was full
+/// @return the number of lines dropped
+long logger_dropped(void)
+{
+    long dropped = atomic_load(&logger_unregistered);
+    int rings = atomic_load_explicit(&logger_rings_count, memory_order_acquire);
+    for (int r = 0; r < rings; r++)
+        dropped += atomic_load_explicit(&logger_rings[r]->dropped, memory_order_relaxed);
+    return dropped;
+}
+
+/// @brief Stops the logger: the lines logged so far are written, the files closed and the number of lines dropped reported
+void logger_stop(void)
+{
+    if (!atomic_exchange(&logger_started, false))
+        return;
+    if (atomic_exchange(&logger_running, false))
+        pthread_join(logger_thread, NULL);
+
+    pthread_mutex_lock(&logger_drain);
+    logger_drain_rings();
+    for (int k = 0; k < LOGGER_FILES; k++)
+    {
+        if (logger_files[k].fp != NULL)
+            fclose(logger_files[k].fp);
+        logger_files[k].fp = NULL;
+        logger_files[k].used = 0;
+    }
+    pthread_mutex_unlock(&logger_drain);
+
+    long dropped = logger_dropped();
+    if (dropped > 0)
+        fprintf(stderr, "WARNING: %ld lines of stats or debug output dropped, the logger couldn't keep up\n", dropped);
+}
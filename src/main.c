@@ -5,571 +5,376 @@
 #include <string.h>
 #include <time.h>
 #include <locale.h>
+#include <signal.h>
 #include <sys/stat.h>
 
 #include <math.h>
 #include <omp.h>
 
 #include "utils.h"
+#include "solver.h"
+#include "stream.h"
+#include "sink.h"
+#include "trace.h"
 
-/// @brief Returns a 2D array containing each region in order (from left to right)
-/// @param sudoku_grid
-/// @return An integer array containing every region of the sudoku grid in a 1D array for each region block
-int ***create_sudoku_region(int **sudoku_grid)
-{
-    int ***puzzle_grid;
+// set when the program is asked to stop, the run is saved and stopped at the end of its try
+static volatile sig_atomic_t interrupted = 0;
 
-    int lines = SUDOKU_SIZE, cols = SUDOKU_SIZE;
+/// @brief Asks the run to stop at the end of its try, after saving it to the checkpoint file
+/// @param signal the signal received
+static void interrupt_handler(int signal)
+{
+    (void)signal;
+    interrupted = 1;
+}
 
-    if ((puzzle_grid = (int ***)malloc(sizeof(int **) * lines)) == NULL)
-    {
-        fprintf(stderr, "ERROR: Out of memory!!\n");
-        exit(EXIT_FAILURE);
-    }
+/// @brief Prints a grid of lower cost found while solving the puzzle, the progress callback of the solver
+/// @param progress the progress of the solving
+/// @param data the hash of the puzzle
+static void print_progress(const struct solver_progress *progress, void *data)
+{
+    printf("%s#[%s] Lowest cost %d after %f seconds (try %d, generation %d, %lld moves)%s\n", CLR_GRN, (char *)data,
+           progress->lowest_cost, progress->time, progress->tries, progress->generations, progress->moves, CLR_RESET);
+    print_sudoku(progress->grid);
+}
 
-    for (int i = 0; i < lines; i++)
-    {
-        if ((puzzle_grid[i] = (int **)malloc(cols * sizeof(int *))) == NULL)
-        {
-            fprintf(stderr, "ERROR: Out of memory!!\n");
-            exit(EXIT_FAILURE);
-        }
-    }
+/// @brief Prints how to use the sudoku solving program
+/// @param program the name of the program
+void print_usage(char *program)
+{
+    fprintf(stderr, "Use: %s Flags file puzzle\n", program);
+    fprintf(stderr, " or: %s Flags -S [-o] [-t threads] < puzzles\n", program);
+    fprintf(stderr, "Where :\n");
+    fprintf(stderr, "  file    : The file containing the sudoku puzzles\n");
+    fprintf(stderr, "  puzzle  : The hash of the puzzle to solve\n");
+    fprintf(stderr, "  puzzles : Lines of 81 digits ('0' or '.' for the empty cells), lines of a puzzle bank or a binary puzzle bank,\n");
+    fprintf(stderr, "            gzip or zstd compressed or not\n");
+    fprintf(stderr, "Flags :\n");
+    fprintf(stderr, "  -v          : Program verbose output\n");
+    fprintf(stderr, "  -f function : Cost function, one of pairs, free or missing (default %s)\n", COST_FUNCTION);
+    fprintf(stderr, "  -i init     : Initial grid of each try, one of random, box, greedy or presolved (default %s)\n", INITIALIZER);
+    fprintf(stderr, "  -s order    : Order of the cells changed, one of random, sequential, box or permutation (default %s)\n", SWEEP_ORDER);
+    fprintf(stderr, "  -k tries    : Number of new values proposed at once for a cell (multiple-try Metropolis, default %d)\n", MULTIPLE_TRIES);
+    fprintf(stderr, "  -d          : Tighten the candidates of each cell and promote the forced cells to fixed cells during the run,\n");
+    fprintf(stderr, "                the candidates the tries don't hold are tested by propagation and removed if refuted\n");
+    fprintf(stderr, "  -r strategy : Restart strategy, one of fixed, luby, geometric or plateau (default %s)\n", RESTART_STRATEGY);
+    fprintf(stderr, "  -p fraction : Restart from the best sudoku found with this fraction of its cells randomized (default %.2f)\n", RESTART_PERTURBATION);
+    fprintf(stderr, "  -w          : Weight the constraints of each line, column and region (breakout)\n");
+    fprintf(stderr, "  -c proba    : Probability of a move to rotate three cells of a region (default %.2f)\n", CYCLE_PROBABILITY);
+    fprintf(stderr, "  -e proba    : Probability of a move to be an ejection chain (default %.2f)\n", CHAIN_PROBABILITY);
+    fprintf(stderr, "  -a          : Adapt the probabilities of the moves during the run, starting from the ones given\n");
+    fprintf(stderr, "  -m          : Solve with the memetic engine (population of grids with crossover) instead of restarts\n");
+    fprintf(stderr, "  -S          : Solve the puzzles read on the standard input, one solution per line on the standard output\n");
+    fprintf(stderr, "                (hash or line of the puzzle, grid found, cost and time) as soon as it is found\n");
+    fprintf(stderr, "  -o          : Write the solutions in the order of the puzzles (at most %d puzzles in flight)\n", STREAM_WINDOW);
+    fprintf(stderr, "  -t threads  : Number of puzzles solved at once with -S (default %d)\n", omp_get_max_threads());
+    fprintf(stderr, "  -R file     : Append the result of each puzzle to this file (hash, solved, costs, tries, moves, time and grid)\n");
+    fprintf(stderr, "  -F format   : Format of the result file, one of jsonl or binary (default %s)\n", RESULT_FORMAT);
+    fprintf(stderr, "  -C file     : Look the puzzles up in this solution cache before solving them, and add the new solutions to it\n");
+    fprintf(stderr, "  -T file     : Record the annealing to this trace file, to replay it with the replay program (not with -S)\n");
+    fprintf(stderr, "  -L level    : What the trace records, one of sampled, accepted or complete (default %s)\n", TRACE_LEVEL);
+    fprintf(stderr, "  -K file     : Save the state of the run to this checkpoint file every %d seconds and on SIGTERM or SIGINT\n", CHECKPOINT_INTERVAL);
+    fprintf(stderr, "                (at the end of the try, a second signal stops at once), removed at the end of the run (not with -S or -m)\n");
+    fprintf(stderr, "  -u          : Resume the run saved in the checkpoint file given with -K, with the flags it was started with\n");
+    fprintf(stderr, "  -D seconds  : Deadline of the solving of each puzzle, the best grid found is returned once it expires\n");
+    fprintf(stderr, "  -P          : Print each grid of lower cost found while solving the puzzle (not with -S)\n");
+}
 
-    int i, j, k, cursor;
-    int i_offset = 0, j_offset = 0;
-    for (k = 0; k < SUDOKU_SIZE; k++, j_offset += 3)
+int main(int argc, char *argv[])
+{
+    struct solver_options options;
+    bool streaming = false, ordered = false;
+    int threads = omp_get_max_threads();
+    char *result_file = NULL;
+    enum sink_format result_format;
+    struct result_sink sink;
+    char *trace_file = NULL;
+    enum trace_level trace_level;
+    struct trace_writer trace;
+    char *cache_file = NULL;
+    struct solution_cache cache;
+    char *checkpoint_file = NULL;
+    bool resume = false;
+    bool progress = false;
+    int option;
+
+    solver_options_init(&options);
+    sink_format_parse(RESULT_FORMAT, &result_format);
+    trace_level_parse(TRACE_LEVEL, &trace_level);
+    while ((option = getopt(argc, argv, "vf:i:s:k:dr:p:wc:e:amSot:R:F:T:L:C:K:uD:P")) != -1)
     {
-        cursor = 0;
-
-        if (k != 0 && k % 3 == 0)
+        switch (option)
         {
-            i_offset += 3;
-            j_offset = 0;
-        }
-
-        for (i = 0; i < SUDOKU_SIZE / 3; i++)
-        {
-            for (j = 0; j < SUDOKU_SIZE / 3; j++)
+        case 'v':
+            options.verbose = true;
+            break;
+        case 'f':
+            if (!cost_function_parse(optarg, &options.cost_function))
+            {
+                fprintf(stderr, "Unknown cost function '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'i':
+            if (!sudoku_initializer_parse(optarg, &options.initializer))
+            {
+                fprintf(stderr, "Unknown initializer '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 's':
+            if (!sweep_order_parse(optarg, &options.sweep_order))
+            {
+                fprintf(stderr, "Unknown sweep order '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'k':
+            options.multiple_tries = atoi(optarg);
+            if (options.multiple_tries < 1 || options.multiple_tries > MULTIPLE_TRIES_MAX)
+            {
+                fprintf(stderr, "The number of new values proposed for a cell must be between 1 and %d\n", MULTIPLE_TRIES_MAX);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'd':
+            options.tightening = true;
+            break;
+        case 'r':
+            if (!restart_strategy_parse(optarg, &options.strategy))
+            {
+                fprintf(stderr, "Unknown restart strategy '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'p':
+            options.perturbation = atof(optarg);
+            if (options.perturbation < 0 || options.perturbation > 1)
+            {
+                fprintf(stderr, "The restart perturbation must be between 0 and 1\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'w':
+            options.weighting = true;
+            break;
+        case 'c':
+            options.cycle_probability = atof(optarg);
+            break;
+        case 'e':
+            options.chain_probability = atof(optarg);
+            break;
+        case 'a':
+            options.adaptive = true;
+            break;
+        case 'm':
+            options.memetic = true;
+            break;
+        case 'S':
+            streaming = true;
+            break;
+        case 'o':
+            ordered = true;
+            break;
+        case 't':
+            threads = atoi(optarg);
+            if (threads < 1)
+            {
+                fprintf(stderr, "The number of puzzles solved at once must be at least 1\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'R':
+            result_file = optarg;
+            break;
+        case 'F':
+            if (!sink_format_parse(optarg, &result_format))
             {
-                puzzle_grid[k][cursor] = &sudoku_grid[i + i_offset][j + j_offset];
-                cursor++;
+                fprintf(stderr, "Unknown result format '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
             }
+            break;
+        case 'C':
+            cache_file = optarg;
+            break;
+        case 'K':
+            checkpoint_file = optarg;
+            break;
+        case 'u':
+            resume = true;
+            break;
+        case 'D':
+            options.deadline = atof(optarg);
+            if (options.deadline <= 0)
+            {
+                fprintf(stderr, "The deadline of the solving must be a positive number of seconds\n");
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'P':
+            progress = true;
+            break;
+        case 'T':
+            trace_file = optarg;
+            break;
+        case 'L':
+            if (!trace_level_parse(optarg, &trace_level))
+            {
+                fprintf(stderr, "Unknown trace level '%s'\n", optarg);
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
         }
     }
 
-    return puzzle_grid;
-}
-
-/// @brief Returns a 2D array containing each line of the sudoku grid in order (from top to bottom)
-/// Each value points to the values in the provided array
-/// @param sudoku_grid the provided array
-/// @return
-int **create_sudoku_lines(int **sudoku_grid)
-{
-    int **puzzle_grid;
-
-    int lines = SUDOKU_SIZE, cols = SUDOKU_SIZE;
-
-    if ((puzzle_grid = (int **)malloc(sizeof(int *) * lines)) == NULL)
+    if (options.cycle_probability < 0 || options.chain_probability < 0 || options.cycle_probability + options.chain_probability > 1)
     {
-        fprintf(stderr, "ERROR: Out of memory!!\n");
+        fprintf(stderr, "The probabilities of the compound moves must be positive and add up to at most 1\n");
         exit(EXIT_FAILURE);
     }
 
-    for (int i = 0; i < lines; i++)
+    if (streaming && trace_file != NULL)
     {
-        if ((puzzle_grid[i] = (int *)malloc(cols * sizeof(int))) == NULL)
-        {
-            fprintf(stderr, "ERROR: Out of memory!!\n");
-            exit(EXIT_FAILURE);
-        }
-    }
-
-    for (int i = 0; i < SUDOKU_SIZE; i++)
-    {
-        for (int j = 0; j < SUDOKU_SIZE; j++)
-        {
-            puzzle_grid[i][j] = sudoku_grid[i][j];
-        }
+        fprintf(stderr, "Only the solving of a single puzzle can be traced\n");
+        exit(EXIT_FAILURE);
     }
 
-    return puzzle_grid;
-}
-
-/// @brief Returns a 2D array containing each line of the sudoku grid in order (from left to right)
-/// Each value points to the values in the provided array
-/// @param sudoku_grid the provided array
-/// @return
-int ***create_sudoku_columns(int **sudoku_grid)
-{
-    int ***puzzle_grid;
-
-    int lines = SUDOKU_SIZE, cols = SUDOKU_SIZE;
-
-    if ((puzzle_grid = (int ***)malloc(sizeof(int **) * lines)) == NULL)
+    if (checkpoint_file != NULL && (streaming || options.memetic))
     {
-        fprintf(stderr, "ERROR: Out of memory!!\n");
+        fprintf(stderr, "Only the annealing of a single puzzle can be saved to a checkpoint\n");
         exit(EXIT_FAILURE);
     }
-
-    for (int i = 0; i < lines; i++)
+    if (resume && checkpoint_file == NULL)
     {
-        if ((puzzle_grid[i] = (int **)malloc(cols * sizeof(int *))) == NULL)
-        {
-            fprintf(stderr, "ERROR: Out of memory!!\n");
-            exit(EXIT_FAILURE);
-        }
+        fprintf(stderr, "The checkpoint file to resume the run from must be given with -K\n");
+        exit(EXIT_FAILURE);
     }
-
-    int i, j;
-    for (i = 0; i < SUDOKU_SIZE; i++)
+    if (streaming && progress)
     {
-        for (j = 0; j < SUDOKU_SIZE; j++)
-        {
-            puzzle_grid[i][j] = &sudoku_grid[j][i];
-        }
+        fprintf(stderr, "Only the progress of the solving of a single puzzle can be printed\n");
+        exit(EXIT_FAILURE);
     }
-
-    return puzzle_grid;
-}
-
-/**
- * @brief Frees memory from each line and the sudoku grid itself
- *
- * @param sudoku_grid
- */
-void sudoku_free(int **sudoku_grid)
-{
-    if (sudoku_grid != NULL)
+    if (resume && trace_file != NULL)
     {
-        // Free dynamically allocated memory
-        for (int i = 0; i < SUDOKU_SIZE; i++)
-        {
-            free(sudoku_grid[i]);
-        }
-        free(sudoku_grid);
-    }
-}
-
-/**
- * @brief Frees memory from each line and the sudoku grid itself
- *
- * @param sudoku_grid
- */
-void sudoku_free_pointers(int ***sudoku_grid)
-{
-    if (sudoku_grid != NULL)
-    {
-        // Free dynamically allocated memory
-        for (int i = 0; i < SUDOKU_SIZE; i++)
-        {
-            free(sudoku_grid[i]);
-        }
-        free(sudoku_grid);
+        fprintf(stderr, "A resumed run can't be traced, the trace starts with the run\n");
+        exit(EXIT_FAILURE);
     }
-}
 
-/// @brief Calculates the total amount of constraints violated in the sudoku grid by checking
-///        the occurence of a given number in the lines, columns and regions of the sudoku
-/// @param nb the given number to find the total amount of constraints violated
-/// @param start_l the starting index of the line
-/// @param start_c the starting index of the column
-/// @param lines 2D array containing each line of the sudoku grid
-/// @param columns 2D array containing each column of the sudoku grid
-/// @param regions 2D array containing each region of the sudoku grid
-/// @return the total amount of constraints violated in the given sudoku for the given cell
-int sudoku_cell_constraints(int nb, int start_l, int start_c, int **lines, int ***columns, int ***regions)
-{
-    if (nb == 0)
-        return 0;
-    int sum = 0;
-    int start_r = (start_l / 3) * 3 + (start_c / 3); // gets the specific region to check inside
-    for (int j = 0; j < SUDOKU_SIZE; j++)
+    unsigned int seed = (unsigned int)time(NULL);
+    if (result_file != NULL)
+        result_sink_open(&sink, result_file, result_format);
+    if (cache_file != NULL)
     {
-        // if (lines[start_l][j] == nb || (*columns[start_c][j]) == nb || (*regions[start_r][j]) == nb)
-        //{ // check the content of the line, column and region
-        //     sum++;
-        // }
-        if (lines[start_l][j] == nb)
-        {
-            sum++;
-        }
-        if (*columns[start_c][j] == nb)
-        {
-            sum++;
-        }
-        if (*regions[start_r][j] == nb)
-        {
-            sum++;
-        }
+        solution_cache_open(&cache, cache_file);
+        options.cache = &cache;
     }
 
-    return sum - 3;
-}
+    if (streaming)
+    { // the standard output only holds the solutions, nothing else is printed while solving
+        struct sudoku_stream stream;
+        options.quiet = true;
+        sudoku_stream_open(&stream, stdin, stdout, &options, ordered, STREAM_WINDOW, seed, (result_file != NULL) ? &sink : NULL);
 
-/// @brief Checks the total amount of constraints violated of every cell in the provided grid
-/// @param lines 2D array containing each line of the sudoku grid
-/// @param columns 2D array containing each column of the sudoku grid
-/// @param regions 2D array containing each region of the sudoku grid
-/// @return the total amount of constraints violated in the given sudoku
-int sudoku_constraints(int **original_grid, int **lines, int ***columns, int ***regions)
-{
-    int sum = 0;
-#if _DEBUG_
-    int constraints[9][9];
-    for (int i = 0; i < SUDOKU_SIZE; i++)
-    {
-        for (int j = 0; j < SUDOKU_SIZE; j++)
-        {
-            constraints[i][j] = 0;
-        }
-    }
-#endif
-    for (int i = 0; i < SUDOKU_SIZE; i++)
-    {
-        for (int j = 0; j < SUDOKU_SIZE; j++)
-        {
-            if (original_grid[i][j] == 0)
-            {
-                sum += sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
-#if _DEBUG_
-                constraints[i][j] = sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
-#endif
-            }
-        }
-    }
-#if _DEBUG_
-    printf("-------------------[\n");
-    print_sudoku_grid(constraints);
-    printf("]-------------------\n");
-#endif
-    return sum;
-    // return sum / 2;
-}
+        double start_time = omp_get_wtime();
+        sudoku_stream_solve(&stream, threads);
+        double CPU_time = omp_get_wtime() - start_time;
 
-int sudoku_constraints_old(int **original_grid, int **lines, int ***columns, int ***regions)
-{
-    int sum = 0;
-    for (int i = 0; i < SUDOKU_SIZE; i++)
-    {
-        for (int j = 0; j < SUDOKU_SIZE; j++)
+        fprintf(stderr, ">> Puzzles solved : %ld/%ld (%ld invalid skipped)\n", stream.solved, stream.written, stream.invalid);
+        if (cache_file != NULL)
         {
-            sum += sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
+            fprintf(stderr, ">> Puzzles found in the solution cache : %ld/%ld (%zu solutions cached)\n", cache.hits, cache.hits + cache.misses, cache.n);
+            solution_cache_close(&cache);
         }
-    }
-    return sum / 2;
-}
-
-/// @brief Chooses a random cell from the sudoku grid. If i or j != -1 then the random cell chosen needs to be different
-///        from the previous cell chosen by the function. This is done to avoid repeated randomly chosen cells
-/// @param sudoku_grid the provided sudoku grid
-/// @param i the line index
-/// @param j the column index
-void sudoku_get_random_cell(int **sudoku_grid, int *i, int *j, unsigned int *seed)
-{
-    int line = get_bound_random(seed, 0, 8);
-    int col = get_bound_random(seed, 0, 8);
-
-    bool different = (*i != -1 && *j != -1);
-    while (sudoku_grid[line][col] != 0 || different)
-    {
-        line = get_bound_random(seed, 0, 8);
-        col = get_bound_random(seed, 0, 8);
-        if (different && (line != *i || col != *j))
+        if (result_file != NULL)
+            result_sink_close(&sink);
+        fprintf(stderr, ">> Puzzles per second : %f\n", (CPU_time > 0) ? stream.written / CPU_time : 0);
+        if (!sudoku_stream_close(&stream))
         {
-            different = false;
+            fprintf(stderr, "ERROR: the compressed input is corrupted or truncated\n");
+            exit(EXIT_FAILURE);
         }
+        return EXIT_SUCCESS;
     }
 
-    *i = line;
-    *j = col;
-}
-
-int main(int argc, char *argv[])
-{
-    if (argc < 2)
+    if (argc - optind < 2)
     {
-        fprintf(stderr, "Use: %s Flags file puzzle\n", argv[0]);
-        fprintf(stderr, "Where :\n");
-        fprintf(stderr, "  file   : The file containing the sudoku puzzles\n");
-        fprintf(stderr, "  puzzle : The hash of the puzzle to solve\n");
-        fprintf(stderr, "Flags :\n");
-        fprintf(stderr, "  -v : Program verbose output\n");
+        print_usage(argv[0]);
         exit(EXIT_FAILURE);
     }
 
     // retrieve the starting grid from the sudoku file
-    bool verbose = (argc == 4) ? true : false;
-    char *puzzle_hash = (argc == 3) ? argv[2] : argv[3];
-    char *file = (argc == 3) ? argv[1] : argv[2];
+    char *file = argv[optind];
+    char *puzzle_hash = argv[optind + 1];
     char filename[FILE_SIZE] = SUDOKU_DIR;
     strcat(filename, file);
 
     printf("%s#File currently being solved [%s]%s\n", CLR_GRN, puzzle_hash, CLR_RESET);
     printf("%s#Maximum tries : %s[%d]\n", CLR_GRN, CLR_RESET, MAX_TRIES);
 
-    // print the current solving configuration
-    if (PRINT_CONFIG)
-        print_config();
-
     int **original_grid = read_sudoku_file(filename, SUDOKU_SIZE, puzzle_hash);
-    // seperate the region, lines and columns of the grid into 3 variables
-
-    // make a deep copy of the original grid with lines and have the regions and columns point to it
-    int **lines = create_sudoku_lines(original_grid);
-
-    // create a 2D array of pointers where each array is a region of the grid(from left to right)
-    int ***regions = create_sudoku_region(lines);
-    // print_sudoku_pointers(regions);
-    int ***columns = create_sudoku_columns(lines);
-    // print_sudoku_pointers(columns);
-
-    int cost = 0;
-    if(OLD) cost = sudoku_constraints_old(original_grid, lines, columns, regions);
-    else cost = sudoku_constraints(original_grid, lines, columns, regions);
-
-    if(verbose)
-        printf(">> Current cost : %d\n", cost);
-
-#if _SHOW_
-    // create and open data visualization pipe
-    if (mkfifo(DATA_PIPE, S_IRUSR | S_IWUSR) == -1)
+    int **solution = create_sudoku_lines(original_grid);
+    if (solution == NULL)
     {
-        fprintf(stderr, "Error creating named pipe '%s'", PIPE_NAME);
-        perror("");
+        fprintf(stderr, "ERROR: Out of memory!!\n");
         exit(EXIT_FAILURE);
     }
 
-    if ((fd = open(PIPE_NAME, O_WRONLY)) == -1)
+    if (trace_file != NULL)
     {
-        perror("Error opening pipe");
-        exit(EXIT_FAILURE);
+        if (!trace_open(&trace, trace_file, trace_level))
+            exit(EXIT_FAILURE);
+        options.trace = &trace;
     }
-#endif
-
-    //  randomly all of the cells of the grid with values from 1 to 9, except the ones already placed
-    unsigned int seed = (unsigned int)time(NULL);
 
-    if (!RANDOMIZE_SUDOKU)
-    { // randomize the sudoku only once at the start
-        // Step 1: Fill the grid's non fixed cells with random values and calculate the cost of the grid
-        sudoku_randomize(&lines, original_grid, &seed);
-        // calculate cost of the random grid
-        if (OLD)
-            cost = sudoku_constraints_old(original_grid, lines, columns, regions);
-        else
-            cost = sudoku_constraints(original_grid, lines, columns, regions);
+    if (checkpoint_file != NULL)
+    { // the run is saved before the program stops, a second signal stops it at once (the last checkpoint is kept)
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = interrupt_handler;
+        action.sa_flags = SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGTERM, &action, NULL);
+        sigaction(SIGINT, &action, NULL);
+        options.checkpoint = checkpoint_file;
+        options.resume = resume;
+        options.interrupted = &interrupted;
     }
 
-    // Setup main loop and current timestamp
-    int tries;
-    char date_buffer[FILE_SIZE];
-#if _DEBUG_
-    char debug_buffer[DEBUG_SIZE];
-#endif
-    time_t timestamp = time(NULL);
-    strftime(date_buffer, FILE_SIZE, "%d-%m-%Y-(%H-%M-%S)", localtime(&timestamp));
-    //
-
-    // define recuit algorithm variables
-    bool solved = false;
-    int k, cost_one, cost_two, cost_comp, temp, new;
-    int lowest_cost_found = (int)INFINITY;
-    double start_time, end_time, CPU_time;
-    double u;
-    int **best_solution = NULL;
-    //
-    start_time = omp_get_wtime();
-    tries = 0;
-
-    while (solved != true)
+    if (progress)
     {
-        if (KEEP_START)
-        {
-            sudoku_copy_content(&lines, original_grid);
-        }
-
-        if (verbose)
-        {
-            printf("\n===========================\n");
-            print_sudoku(lines);
-            printf(">> Current cost : %d\n", cost);
-        }
-
-        if (RANDOMIZE_SUDOKU)
-        { // randomize only on the first try
-            // Step 1: Fill the grid's non fixed cells with random values and calculate the cost of the grid
-            sudoku_randomize(&lines, original_grid, &seed);
-            if (OLD)
-                cost = sudoku_constraints_old(original_grid, lines, columns, regions);
-            else
-                cost = sudoku_constraints(original_grid, lines, columns, regions);
-            //print_sudoku(lines);
-            //printf("Cost after randomization : %d\n", cost);
-        }
-
-        if (verbose)
-        {
-            printf("\n===========================\n");
-            print_sudoku(lines);
-            printf(">> Current cost : %d\n", cost);
-        }
-
-        // log the stats of the recuit solver
-        if (GET_STATS)
-            sudoku_write_stats(puzzle_hash, cost, tries, date_buffer);
-
-        // Step 2: Setup the contants
-        int i = -1, j = -1;
-        float sigma = 0.1;
-        double ep = START_TEMPERATURE;
-        double e = exp(1);
-        double temperature = ep;
-
-        // diminution/augmentation de la temperature de départ à chaque quart d'essaie
-        if (tries != 0 && tries % (MAX_TRIES / TEMP_STEP) == 0)
-            temperature *= 2;
-
-        // Step 3: Start the recuit simulation algorithm
-        while (temperature >= TEMPERATURE_CEILING && solved != true)
-        {
-            for (k = 0; k < PRESUMED_PUZZLE_SIZE; k++)
-            {
-                // Step 4: choose random cell from the grid which isn't fixed
-                sudoku_get_random_cell(original_grid, &i, &j, &seed); // use the original grid to find a non fixed random cell
-
-                // Step 5: store the value in a temp variable and evaluate the cost of the random cell
-                temp = lines[i][j];
-                cost_one = sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
-
-                // Step 6: choose a new different value for the random cell
-                while ((new = get_bound_random(&seed, 1, 9)) == temp)
-                    ;
-                lines[i][j] = new;
-
-                // Step 7: evaluate the cost of the random cell with changed value
-                cost_two = sudoku_cell_constraints(lines[i][j], i, j, lines, columns, regions);
-
-                // Step 8: compare the cost between the two random cell values
-                cost_comp = cost - cost_one + cost_two;
-
-                // Step 9: choose random value in [0, 1]
-                u = get_random(&seed);
-#if _DEBUG_
-                snprintf(debug_buffer, DEBUG_SIZE, "{cost: %d, cost_one: %d, cost_two: %d, cost_comp: %d, temperature: %f}", cost, cost_one, cost_two, cost_comp, temperature);
-                sudoku_debug_output(puzzle_hash, debug_buffer, date_buffer);
-#endif
-                // Step 10: probability acceptance
-                if (cost_comp < cost)
-                {
-                    cost = cost_comp;
-                }
-                //else if (u <= MIN(1, e - ((cost_comp - cost) / temperature)))
-                else if (u <= exp(-((cost_comp - cost) / temperature)))
-                { // acceptation
-                    cost = cost_comp;
-                }
-                else
-                { // rejet
-                    lines[i][j] = temp;
-                }
-
-// send current sudoku to visualization program
-#if _SHOW_
-                for (int s = 0; s < SUDOKU_SIZE; s++)
-                {
-                    if (write(fd, &lines[s], sizeof(int) * SUDOKU_SIZE) == -1)
-                    {
-                        perror("Error writing integers in pipe");
-                        exit(EXIT_FAILURE);
-                    }
-                }
-#endif
-                // Stop the algorithm if the cost of the grid is SOLUTION_COST
-                if (cost <= SOLUTION_COST)
-                {
-                    printf("\n>>> [NULL 0 cost solution found]\n");
-                    print_sudoku(lines);
-                    solved = true;
-                    // log the stats of the recuit solver
-                    if (GET_STATS)
-                        sudoku_write_stats(puzzle_hash, cost, tries, date_buffer);
-                    break;
-                }
-#if _DEBUG_
-                snprintf(debug_buffer, DEBUG_SIZE, "{cost: %d, cost_one: %d, cost_two: %d, cost_comp: %d, temperature: %f}", cost, cost_one, cost_two, cost_comp, temperature);
-                sudoku_debug_output(puzzle_hash, debug_buffer, date_buffer);
-#endif
-            }
-
-            // Step k: reduce the temperature
-            temperature = temperature / (1 + (log(1 + sigma) / ep + 1) * temperature);
-        }
-
-        // find lowest cost and manage the best current solution
-        if (cost < lowest_cost_found)
-        { // if we find the current best solution, keep the cost and the grid
-            lowest_cost_found = cost;
-            if (KEEP_BEST)
-            {
-                if (best_solution != NULL)
-                {
-                    sudoku_free(best_solution);
-                    best_solution = NULL;
-                }
-                best_solution = create_sudoku_lines(lines);
-            }
-        }
-        else if (KEEP_BEST)
-        { // if the cost found is inferior, go back to best solution
-            sudoku_copy_content(&lines, best_solution);
-        }
-
-        // increment the number of tries
-        tries++;
-        if (tries > MAX_TRIES && !KEEP_TRYING)
-            break;
+        options.progress = print_progress;
+        options.progress_data = puzzle_hash;
     }
 
-#if _SHOW_
-    if (close(fd) == -1)
+    struct solver_result result;
+    int cost = sudoku_solve(original_grid, puzzle_hash, &options, solution, &seed, &result);
+    if (cost == -1)
     {
-        perror("Error closing pipe");
+        fprintf(stderr, "ERROR: Out of memory!!\n");
         exit(EXIT_FAILURE);
     }
-
-    if (unlink(PIPE_NAME) == -1)
+    if (trace_file != NULL)
+        trace_close(&trace, cost);
+    if (cache_file != NULL)
+        solution_cache_close(&cache);
+    if (result_file != NULL)
     {
-        perror("Error deleting pipe");
-        exit(EXIT_FAILURE);
+        result_sink_write(&sink, -1, puzzle_hash, &result, solution);
+        result_sink_close(&sink);
     }
-#endif
-
-    end_time = omp_get_wtime();
-
-    // calculate the CPU execution time of the sudoku solving algorithm
-    CPU_time = end_time - start_time;
 
     /////////////////////////////////////////////////////////////////////////////////////
     /////////////////////////////////////////////////////////////////////////////////////
-    if (verbose)
-    {
-        printf("\n===========================\n");
-        printf("\nResults of the simulation: \n");
-        printf("\n===========================\n");
-
-        printf("\n---------------------------------------------------------------------------------\n");
-        printf(">>> Last output cost by the annealing algorithm: %d\n", cost);
-    }
-
-    // calculate cost of grid
-    if (OLD)
-        cost = sudoku_constraints_old(original_grid, lines, columns, regions);
-    else
-        cost = sudoku_constraints(original_grid, lines, columns, regions);
-
-    if (verbose)
+    if (options.verbose)
     {
         printf("\n===========================\n");
         printf("From: ");
@@ -577,29 +382,48 @@ int main(int argc, char *argv[])
         print_sudoku(original_grid);
     }
 
-    if (verbose)
+    if (options.verbose)
     {
         printf("\n===========================\n");
         printf("To: ");
         printf("\n===========================\n");
-        print_sudoku(lines);
+        print_sudoku(solution);
     }
 
+    if (result.expired)
+        printf(">> Deadline of %f seconds expired, the best grid found is returned\n", options.deadline);
+    if (result.interrupted)
+        printf(">> Run interrupted at try %d, saved to %s (resume it with -u)\n", result.tries, checkpoint_file);
     printf(">> Current cost at the end of the simulation : %d\n", cost);
-    printf(">> Best solution (lowest cost) found during the execution of the simulation : %d\n", lowest_cost_found);
-    printf(">> Numbers of tries taken : %d\n", tries - 1);
-    printf(">> CPU Execution time of the sudoku solving simulation : %f\n", CPU_time);
+    printf(">> Best solution (lowest cost) found during the execution of the simulation : %d\n", result.lowest_cost);
+    if (result.cached)
+        printf(">> Solution found in the solution cache\n");
+    else if (options.memetic)
+    {
+        printf(">> Numbers of generations taken : %d\n", result.generations);
+        printf(">> Generations per second of the memetic engine : %f\n", result.generations / result.time);
+    }
+    else
+    {
+        printf(">> Numbers of tries taken : %d\n", result.tries - 1);
+        printf(">> Numbers of sweeps taken : %f\n", result.sweeps);
+        printf(">> Moves per second of the annealing : %f\n", result.moves / result.time);
+    }
+    if (result.adaptive)
+    {
+        printf(">> Probabilities of the moves learned :");
+        for (int op = 0; op < OPERATORS; op++)
+            printf(" %s %f", operator_name(op), result.probability[op]);
+        printf("\n");
+    }
+    printf(">> CPU Execution time of the sudoku solving simulation : %f\n", result.time);
 
     /////////////////////////////////////////////////////////////////////////////////////
     /////////////////////////////////////////////////////////////////////////////////////
 
     // Free allocated memory of the various grids used
-    sudoku_free_pointers(regions);
-    sudoku_free_pointers(columns);
-    sudoku_free(lines);
+    sudoku_free(solution);
     sudoku_free(original_grid);
-    if (best_solution != NULL)
-        sudoku_free(best_solution);
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,239 @@
+#include <math.h>
+#include <omp.h>
+
+#include "memetic.h"
+#include "cost.h"
+#include "moves.h"
+#include "utils.h"
+
+/// @brief Allocates an individual with the content of the given grid
+/// @param sudoku_grid the given grid
+/// @param individual the individual to allocate
+/// @return false if the grids couldn't be allocated (nothing is left allocated), true otherwise
+bool sudoku_individual_create(int **sudoku_grid, struct sudoku_individual *individual)
+{
+    individual->columns = individual->regions = NULL;
+    individual->cost = 0;
+    if ((individual->lines = create_sudoku_lines(sudoku_grid)) == NULL ||
+        (individual->columns = create_sudoku_columns(individual->lines)) == NULL ||
+        (individual->regions = create_sudoku_region(individual->lines)) == NULL)
+    {
+        sudoku_individual_free(individual);
+        return false;
+    }
+    return true;
+}
+
+/// @brief Frees the grids of an individual
+/// @param individual the individual
+void sudoku_individual_free(struct sudoku_individual *individual)
+{
+    sudoku_free_pointers(individual->regions);
+    sudoku_free_pointers(individual->columns);
+    sudoku_free(individual->lines);
+}
+
+/// @brief Creates a child from two parents: each region (or each line) of the child is copied from one of the parents
+///        at random. The fixed cells are the same in both parents, so they stay intact in the child
+/// @param child the created child
+/// @param first the first parent
+/// @param second the second parent
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_crossover(struct sudoku_individual *child, struct sudoku_individual *first, struct sudoku_individual *second, unsigned int *seed)
+{
+    bool by_region = get_random(seed) < MEMETIC_REGION_CROSSOVER;
+
+    for (int u = 0; u < SUDOKU_SIZE; u++)
+    {
+        struct sudoku_individual *parent = (get_bound_random(seed, 0, 1) == 0) ? first : second;
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+        {
+            if (by_region)
+                *child->regions[u][k] = *parent->regions[u][k];
+            else
+                child->lines[u][k] = parent->lines[u][k];
+        }
+    }
+}
+
+/// @brief Short simulated annealing of an individual with single cell changes, from the given temperature down to
+///        the stop temperature in MEMETIC_POLISH_STEPS temperature steps
+/// @param individual the individual to polish, its cost is updated
+/// @param model the cost model, with the starting grid used to find the non fixed cells
+/// @param start_temperature the temperature at the start of the polish
+/// @param stop_temperature the temperature at the end of the polish
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_polish(struct sudoku_individual *individual, struct cost_model *model, double start_temperature, double stop_temperature, unsigned int *seed)
+{
+    int **original_grid = model->original_grid;
+    int i = -1, j = -1, new, delta;
+    int cost = sudoku_cost(individual->lines, individual->columns, individual->regions, model);
+    double temperature = start_temperature;
+    double beta = (1 / stop_temperature - 1 / start_temperature) / MEMETIC_POLISH_STEPS;
+
+    for (int step = 0; step < MEMETIC_POLISH_STEPS && cost > SOLUTION_COST; step++)
+    {
+        for (int k = 0; k < PRESUMED_PUZZLE_SIZE && cost > SOLUTION_COST; k++)
+        {
+            sudoku_get_random_cell(original_grid, &i, &j, seed);
+            while ((new = get_bound_random(seed, 1, 9)) == individual->lines[i][j])
+                ;
+
+            delta = sudoku_cell_delta(new, i, j, individual->lines, individual->columns, individual->regions, model);
+            if (delta <= 0 || get_random(seed) <= exp(-delta / temperature))
+            {
+                individual->lines[i][j] = new;
+                cost += delta;
+            }
+        }
+        temperature = temperature / (1 + beta * temperature);
+    }
+
+    // the single cell evaluation is exact for every cost function, no need to evaluate the whole grid again
+    individual->cost = cost;
+}
+
+/// @brief Compares two individuals by cost, to sort a population from the best to the worst
+/// @param a the first individual
+/// @param b the second individual
+/// @return a negative value if the first individual is better, positive if worse, 0 if they have the same cost
+int sudoku_individual_compare(const void *a, const void *b)
+{
+    return ((struct sudoku_individual *)a)->cost - ((struct sudoku_individual *)b)->cost;
+}
+
+/// @brief Checks if two individuals have the same grid
+/// @param a the first individual
+/// @param b the second individual
+/// @return true if the grids are the same
+bool sudoku_individual_equals(struct sudoku_individual *a, struct sudoku_individual *b)
+{
+    if (a->cost != b->cost)
+        return false;
+    for (int l = 0; l < SUDOKU_SIZE; l++)
+    {
+        if (memcmp(a->lines[l], b->lines[l], sizeof(int) * SUDOKU_SIZE) != 0)
+            return false;
+    }
+    return true;
+}
+
+/// @brief Chooses a parent by tournament: the best of MEMETIC_TOURNAMENT random individuals of the population
+/// @param seed the seed used in the pseudo random number generator
+/// @return the index of the chosen parent in the (sorted) population
+int sudoku_tournament(unsigned int *seed)
+{
+    int best = POPULATION_SIZE - 1;
+    for (int k = 0; k < MEMETIC_TOURNAMENT; k++)
+    {
+        int candidate = get_bound_random(seed, 0, POPULATION_SIZE - 1);
+        if (candidate < best) // the population is sorted from the best to the worst
+            best = candidate;
+    }
+    return best;
+}
+
+/// @brief Solves the sudoku with a population of grids: at each generation, children are created by crossover of parents
+///        chosen by tournament and polished by a short annealing in parallel, then the best distinct grids are kept
+/// @param model the cost model (unweighted), with the starting grid
+/// @param solution the best grid found
+/// @param seed the seed used in the pseudo random number generator
+/// @param start_temperature the calibrated start temperature of the annealing
+/// @param stop_temperature the calibrated stop temperature of the annealing
+/// @param verbose if the progress of the engine is printed
+/// @param watch the deadline of the run and its progress callback, looked at after each generation
+/// @param stats the statistics of the run
+/// @return the cost of the best grid found, -1 if the population couldn't be allocated
+int sudoku_memetic(struct cost_model *model, int **solution, unsigned int *seed, double start_temperature, double stop_temperature, bool verbose,
+                   struct anytime_watch *watch, struct memetic_stats *stats)
+{
+    int **original_grid = model->original_grid;
+    // the parents come first, then the children of the generation
+    struct sudoku_individual individuals[POPULATION_SIZE + MEMETIC_CHILDREN];
+    struct sudoku_individual selected[POPULATION_SIZE + MEMETIC_CHILDREN];
+    unsigned int seeds[POPULATION_SIZE + MEMETIC_CHILDREN];
+    int parents[MEMETIC_CHILDREN][2];
+    int n = POPULATION_SIZE + MEMETIC_CHILDREN;
+    double polish_temperature = start_temperature * MEMETIC_POLISH_TEMPERATURE;
+    double start_time = omp_get_wtime();
+
+    // the random numbers of each individual come from its own seed, so the run doesn't depend on the number of threads
+    for (int k = 0; k < n; k++)
+    {
+        if (!sudoku_individual_create(original_grid, &individuals[k]))
+        {
+            while (k-- > 0)
+                sudoku_individual_free(&individuals[k]);
+            return -1;
+        }
+        seeds[k] = (unsigned int)rand_r(seed);
+    }
+
+    // random starting population, polished from the start temperature
+#pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < POPULATION_SIZE; k++)
+    {
+        sudoku_randomize(&individuals[k].lines, original_grid, &seeds[k]);
+        sudoku_polish(&individuals[k], model, start_temperature, stop_temperature, &seeds[k]);
+    }
+    qsort(individuals, POPULATION_SIZE, sizeof(struct sudoku_individual), sudoku_individual_compare);
+    anytime_watch_improved(watch, individuals[0].cost, individuals[0].lines, 0, 0, 0);
+
+    // the best grid is always the first one of the population, it is the one returned when the deadline expires
+    int generations = 0;
+    while (individuals[0].cost > SOLUTION_COST && (generations < MEMETIC_GENERATIONS || KEEP_TRYING) && !anytime_watch_expired(watch))
+    {
+        for (int c = 0; c < MEMETIC_CHILDREN; c++)
+        {
+            parents[c][0] = sudoku_tournament(seed);
+            parents[c][1] = sudoku_tournament(seed);
+        }
+
+        // create and polish the children in parallel
+#pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < MEMETIC_CHILDREN; c++)
+        {
+            struct sudoku_individual *child = &individuals[POPULATION_SIZE + c];
+            sudoku_crossover(child, &individuals[parents[c][0]], &individuals[parents[c][1]], &seeds[POPULATION_SIZE + c]);
+            sudoku_polish(child, model, polish_temperature, stop_temperature, &seeds[POPULATION_SIZE + c]);
+        }
+
+        // keep the best distinct grids of the parents and the children, the duplicates go last
+        qsort(individuals, n, sizeof(struct sudoku_individual), sudoku_individual_compare);
+        int kept = 0, duplicates = n;
+        for (int k = 0; k < n; k++)
+        {
+            bool duplicate = false;
+            for (int d = 0; d < kept && !duplicate; d++)
+                duplicate = sudoku_individual_equals(&individuals[k], &selected[d]);
+            if (duplicate)
+                selected[--duplicates] = individuals[k];
+            else
+                selected[kept++] = individuals[k];
+        }
+        for (int k = 0; k < n; k++)
+        {
+            individuals[k] = selected[k];
+            seeds[k] = (k < POPULATION_SIZE) ? seeds[k] : (unsigned int)rand_r(seed);
+        }
+        // the duplicates were put in reverse order, sort the survivors again (the children slots are overwritten anyway)
+        qsort(individuals, POPULATION_SIZE, sizeof(struct sudoku_individual), sudoku_individual_compare);
+
+        generations++;
+        anytime_watch_improved(watch, individuals[0].cost, individuals[0].lines, 0, generations, 0);
+        if (verbose)
+            printf(">> Generation %d : best cost %d, worst kept cost %d\n", generations, individuals[0].cost, individuals[POPULATION_SIZE - 1].cost);
+    }
+
+    sudoku_copy_content(&solution, individuals[0].lines);
+    int best_cost = individuals[0].cost;
+
+    for (int k = 0; k < n; k++)
+        sudoku_individual_free(&individuals[k]);
+
+    stats->generations = generations;
+    stats->time = omp_get_wtime() - start_time;
+    stats->best_cost = best_cost;
+
+    return best_cost;
+}
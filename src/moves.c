@@ -0,0 +1,424 @@
+#include <math.h>
+
+#include "moves.h"
+#include "cost.h"
+#include "utils.h"
+#include "domains.h"
+
+/// @brief Chooses a random cell from the sudoku grid. If i or j != -1 then the random cell chosen needs to be different
+///        from the previous cell chosen by the function. This is done to avoid repeated randomly chosen cells
+/// @param sudoku_grid the provided sudoku grid
+/// @param i the line index
+/// @param j the column index
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_get_random_cell(int **sudoku_grid, int *i, int *j, unsigned int *seed)
+{
+    int line = get_bound_random(seed, 0, 8);
+    int col = get_bound_random(seed, 0, 8);
+
+    bool different = (*i != -1 && *j != -1);
+    while (sudoku_grid[line][col] != 0 || different)
+    {
+        line = get_bound_random(seed, 0, 8);
+        col = get_bound_random(seed, 0, 8);
+        if (different && (line != *i || col != *j))
+        {
+            different = false;
+        }
+    }
+
+    *i = line;
+    *j = col;
+}
+
+/// @brief Shuffles the cells of the sweep (Fisher-Yates)
+/// @param sweep the sweep
+/// @param seed the seed used in the pseudo random number generator
+static void cell_sweep_shuffle(struct cell_sweep *sweep, unsigned int *seed)
+{
+    for (int k = sweep->n - 1; k > 0; k--)
+    {
+        int swap = get_bound_random(seed, 0, k);
+        int temp = sweep->cells[k];
+        sweep->cells[k] = sweep->cells[swap];
+        sweep->cells[swap] = temp;
+    }
+}
+
+/// @brief Initializes the sweep over the non fixed cells of the grid
+/// @param sweep the sweep
+/// @param order the order in which the cells are visited
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param seed the seed used in the pseudo random number generator
+void cell_sweep_init(struct cell_sweep *sweep, enum sweep_order order, int **original_grid, unsigned int *seed)
+{
+    sweep->order = order;
+    sweep->n = 0;
+    sweep->position = 0;
+    sweep->sweeps = 0;
+
+    for (int k = 0; k < PUZZLE_SIZE; k++)
+    {
+        int line, column;
+        if (order == SWEEP_BOX)
+        { // region by region, each region line by line
+            int region = k / SUDOKU_SIZE, cell = k % SUDOKU_SIZE;
+            line = (region / 3) * 3 + cell / 3;
+            column = (region % 3) * 3 + cell % 3;
+        }
+        else
+        {
+            line = k / SUDOKU_SIZE;
+            column = k % SUDOKU_SIZE;
+        }
+
+        if (original_grid[line][column] == 0)
+            sweep->cells[sweep->n++] = line * SUDOKU_SIZE + column;
+    }
+
+    if (order == SWEEP_PERMUTATION)
+        cell_sweep_shuffle(sweep, seed);
+}
+
+/// @brief Rebuilds the sweep after cells were promoted to fixed cells, the number of sweeps done is kept
+/// @param sweep the sweep
+/// @param original_grid the grid of the fixed cells, used to find the non fixed cells
+/// @param seed the seed used in the pseudo random number generator
+void cell_sweep_update(struct cell_sweep *sweep, int **original_grid, unsigned int *seed)
+{
+    int sweeps = sweep->sweeps;
+    cell_sweep_init(sweep, sweep->order, original_grid, seed);
+    sweep->sweeps = sweeps;
+}
+
+/// @brief Finds the sweep order corresponding to the given name
+/// @param name the name of the order (random, sequential, box or permutation)
+/// @param order the corresponding order
+/// @return true if the name is a known order, false otherwise
+bool sweep_order_parse(const char *name, enum sweep_order *order)
+{
+    for (enum sweep_order o = SWEEP_RANDOM; o < SWEEP_ORDERS; o++)
+    {
+        if (strcmp(name, sweep_order_name(o)) == 0)
+        {
+            *order = o;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Gets the name of the given sweep order
+/// @param order the sweep order
+/// @return the name of the order
+const char *sweep_order_name(enum sweep_order order)
+{
+    switch (order)
+    {
+    case SWEEP_SEQUENTIAL:
+        return "sequential";
+    case SWEEP_BOX:
+        return "box";
+    case SWEEP_PERMUTATION:
+        return "permutation";
+    default:
+        return "random";
+    }
+}
+
+/// @brief Chooses the next non fixed cell to change: a random one for the random order, the next cell of the sweep otherwise.
+///        Each change of a sweep is still a Metropolis update of a single cell with a symmetric proposal (a uniform new value),
+///        it leaves the Boltzmann distribution of the grids invariant whatever the order the cells are visited in
+/// @param sweep the sweep
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param i the line index, the previous one on input (see sudoku_get_random_cell)
+/// @param j the column index, the previous one on input (see sudoku_get_random_cell)
+/// @param seed the seed used in the pseudo random number generator
+void sudoku_sweep_cell(struct cell_sweep *sweep, int **original_grid, int *i, int *j, unsigned int *seed)
+{
+    if (sweep->order == SWEEP_RANDOM)
+        sudoku_get_random_cell(original_grid, i, j, seed);
+    else
+    {
+        int cell = sweep->cells[sweep->position];
+        *i = cell / SUDOKU_SIZE;
+        *j = cell % SUDOKU_SIZE;
+    }
+
+    if (++sweep->position == sweep->n)
+    { // every non fixed cell was visited once, start the next sweep
+        sweep->position = 0;
+        sweep->sweeps++;
+        if (sweep->order == SWEEP_PERMUTATION)
+            cell_sweep_shuffle(sweep, seed);
+    }
+}
+
+/// @brief Prints the configuration of the sweep of the sudoku solving algorithm
+/// @param sweep the sweep
+void cell_sweep_print(struct cell_sweep *sweep)
+{
+    printf("  %s>[SWEEP_ORDER]Order of the non fixed cells changed:%s %s%s%s (%d non fixed cells)\n", CLR_YEL, CLR_RESET, CLR_GRN, sweep_order_name(sweep->order), CLR_RESET, sweep->n);
+}
+
+/// @brief Changes the value of a cell as part of the given move and evaluates the change of the cost.
+///        The cells of a move are changed one after the other, so the sum of the changes is the change of the whole move
+/// @param move the move the cell belongs to
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param nb the new value of the cell
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @return the change of the cost of the grid
+int sudoku_move_set(struct sudoku_move *move, int line, int column, int nb, int **lines, int ***columns, int ***regions, struct cost_model *model)
+{
+    int delta = sudoku_cell_delta(nb, line, column, lines, columns, regions, model);
+
+    move->line[move->size] = line;
+    move->column[move->size] = column;
+    move->previous[move->size] = lines[line][column];
+    move->size++;
+
+    lines[line][column] = nb;
+    return delta;
+}
+
+/// @brief Rotates the values of three random non fixed cells of a random region of the grid (a -> b -> c -> a).
+///        The values of the region stay the same, only the lines and columns of the cells are affected
+/// @param move the move made, to undo it if needed
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param seed the seed used in the pseudo random number generator
+/// @return the change of the cost of the grid made by the move
+int sudoku_move_cycle(struct sudoku_move *move, int **original_grid, int **lines, int ***columns, int ***regions, struct cost_model *model, unsigned int *seed)
+{
+    int cells[SUDOKU_SIZE];
+    int n = 0, region = 0;
+
+    move->size = 0;
+
+    // find a region with at least three non fixed cells, starting from a random one
+    int start = get_bound_random(seed, 0, SUDOKU_SIZE - 1);
+    for (int r = 0; r < SUDOKU_SIZE && n < 3; r++)
+    {
+        region = (start + r) % SUDOKU_SIZE;
+        n = 0;
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+        {
+            if (original_grid[(region / 3) * 3 + k / 3][(region % 3) * 3 + k % 3] == 0)
+                cells[n++] = k;
+        }
+    }
+    if (n < 3)
+        return 0;
+
+    // choose three different cells of the region
+    for (int k = 0; k < 3; k++)
+    {
+        int pick = get_bound_random(seed, k, n - 1);
+        int cell = cells[pick];
+        cells[pick] = cells[k];
+        cells[k] = cell;
+    }
+
+    int line[3], column[3], value[3];
+    for (int k = 0; k < 3; k++)
+    {
+        line[k] = (region / 3) * 3 + cells[k] / 3;
+        column[k] = (region % 3) * 3 + cells[k] % 3;
+        value[k] = lines[line[k]][column[k]];
+    }
+
+    int delta = 0;
+    for (int k = 0; k < 3; k++)
+        delta += sudoku_move_set(move, line[(k + 1) % 3], column[(k + 1) % 3], value[k], lines, columns, regions, model);
+
+    return delta;
+}
+
+/// @brief Checks if the given cell is already changed by the given move
+/// @param move the move
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @return true if the cell is part of the move, false otherwise
+bool sudoku_move_contains(struct sudoku_move *move, int line, int column)
+{
+    for (int k = 0; k < move->size; k++)
+    {
+        if (move->line[k] == line && move->column[k] == column)
+            return true;
+    }
+    return false;
+}
+
+/// @brief Changes a random non fixed cell to a new random value, then repeatedly ejects a non fixed cell of the same line,
+///        column or region holding the value just placed and gives it its least conflicting value (up to CHAIN_LENGTH cells)
+/// @param move the move made, to undo it if needed
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param seed the seed used in the pseudo random number generator
+/// @return the change of the cost of the grid made by the move
+int sudoku_move_chain(struct sudoku_move *move, int **original_grid, int **lines, int ***columns, int ***regions, struct cost_model *model, unsigned int *seed)
+{
+    int i = -1, j = -1, nb;
+    int delta = 0;
+
+    move->size = 0;
+
+    // the head of the chain gets a new random value
+    sudoku_get_random_cell(original_grid, &i, &j, seed);
+    while ((nb = get_bound_random(seed, 1, 9)) == lines[i][j])
+        ;
+    delta += sudoku_move_set(move, i, j, nb, lines, columns, regions, model);
+
+    while (move->size < CHAIN_LENGTH && move->size < MOVE_MAX_CELLS)
+    {
+        // find the non fixed cells now conflicting with the last changed cell
+        int conflicts[3 * SUDOKU_SIZE][2];
+        int n = 0;
+        int r_line = (i / 3) * 3, r_column = (j / 3) * 3;
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+        {
+            int unit_cells[3][2] = {{i, k}, {k, j}, {r_line + k / 3, r_column + k % 3}};
+            for (int u = 0; u < 3; u++)
+            {
+                int l = unit_cells[u][0], c = unit_cells[u][1];
+                if (lines[l][c] == nb && original_grid[l][c] == 0 && !sudoku_move_contains(move, l, c))
+                {
+                    conflicts[n][0] = l;
+                    conflicts[n][1] = c;
+                    n++;
+                }
+            }
+        }
+        if (n == 0)
+            break;
+
+        // eject one of them and give it its least conflicting value
+        int pick = get_bound_random(seed, 0, n - 1);
+        i = conflicts[pick][0];
+        j = conflicts[pick][1];
+
+        int best = 0, best_delta = 0, offset = get_bound_random(seed, 0, SUDOKU_SIZE - 1);
+        for (int k = 0; k < SUDOKU_SIZE; k++)
+        {
+            int candidate = (offset + k) % SUDOKU_SIZE + 1; // random starting value to break the ties
+            if (candidate == lines[i][j])
+                continue;
+            int candidate_delta = sudoku_cell_delta(candidate, i, j, lines, columns, regions, model);
+            if (best == 0 || candidate_delta < best_delta)
+            {
+                best = candidate;
+                best_delta = candidate_delta;
+            }
+        }
+
+        nb = best;
+        delta += sudoku_move_set(move, i, j, nb, lines, columns, regions, model);
+    }
+
+    return delta;
+}
+
+/// @brief Draws a value among the given candidates, different from the excluded one (any value different from it if no
+///        candidate is left)
+/// @param candidates the candidates, as the bits 1 to SUDOKU_SIZE
+/// @param excluded the value left out
+/// @param seed the seed used in the pseudo random number generator
+/// @return the value drawn
+static int multiple_try_draw(int candidates, int excluded, unsigned int *seed)
+{
+    int others = candidates & ~(1 << excluded);
+    if (others == 0)
+        others = DOMAIN_ALL & ~(1 << excluded);
+
+    // the k-th value of the candidates
+    int k = get_bound_random(seed, 0, __builtin_popcount(others) - 1);
+    int value = 1;
+    for (; value <= SUDOKU_SIZE; value++)
+    {
+        if ((others & (1 << value)) && k-- == 0)
+            break;
+    }
+    return value;
+}
+
+/// @brief Multiple-try Metropolis change of the given non fixed cell: the given number of new values are proposed (uniformly among
+///        the candidates of the cell different from the current value) and scored at once, one of them is chosen in proportion to its Boltzmann weight,
+///        then as many reference values are drawn from the chosen one (the current value being one of them) and the change is
+///        accepted with the ratio of the sums of the weights of the proposed and reference values
+/// @param line the line index of the cell
+/// @param column the column index of the cell
+/// @param candidates the values the cell may hold, as the bits 1 to SUDOKU_SIZE (DOMAIN_ALL without tightening the domains)
+/// @param tries the number of new values proposed, at most MULTIPLE_TRIES_MAX
+/// @param temperature the current temperature of the annealing
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param model the cost model
+/// @param seed the seed used in the pseudo random number generator
+/// @param nb the new value chosen for the cell (the cell isn't modified)
+/// @param delta the change of the cost of the grid made by the new value
+/// @return true if the change is accepted, false otherwise
+bool sudoku_multiple_try(int line, int column, int candidates, int tries, double temperature, int **lines, int ***columns,
+                         int ***regions, struct cost_model *model, unsigned int *seed, int *nb, int *delta)
+{
+    int deltas[SUDOKU_SIZE + 1];
+    double weights[SUDOKU_SIZE + 1];
+    int old = lines[line][column];
+    int lowest = 0;
+
+    // the Boltzmann weight of every value at once, relative to the lowest cost to avoid overflows
+    sudoku_cell_deltas(line, column, lines, columns, regions, model, deltas);
+    for (int k = 1; k <= SUDOKU_SIZE; k++)
+        lowest = (deltas[k] < lowest) ? deltas[k] : lowest;
+    for (int k = 1; k <= SUDOKU_SIZE; k++)
+        weights[k] = exp(-(deltas[k] - lowest) / temperature);
+
+    // proposed values, each one different from the current value
+    int proposed[MULTIPLE_TRIES_MAX];
+    double proposed_sum = 0;
+    for (int k = 0; k < tries; k++)
+    {
+        proposed[k] = multiple_try_draw(candidates, old, seed);
+        proposed_sum += weights[proposed[k]];
+    }
+
+    // choose one of them in proportion to its weight
+    double r = get_random(seed) * proposed_sum;
+    int chosen = old;
+    for (int k = 0; k < tries; k++)
+    {
+        chosen = proposed[k];
+        r -= weights[chosen];
+        if (r <= 0)
+            break;
+    }
+
+    // reference values drawn from the chosen one, the current value completes them
+    double reference_sum = weights[old];
+    for (int k = 0; k < tries - 1; k++)
+        reference_sum += weights[multiple_try_draw(candidates, chosen, seed)];
+
+    *nb = chosen;
+    *delta = deltas[chosen];
+    return get_random(seed) * reference_sum <= proposed_sum;
+}
+
+/// @brief Undoes the given move, restoring the previous value of each changed cell
+/// @param move the move to undo
+/// @param lines 2D array containing each line of the sudoku grid
+void sudoku_move_undo(struct sudoku_move *move, int **lines)
+{
+    for (int k = move->size - 1; k >= 0; k--)
+        lines[move->line[k]][move->column[k]] = move->previous[k];
+    move->size = 0;
+}
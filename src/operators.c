@@ -0,0 +1,144 @@
+#include "operators.h"
+#include "utils.h"
+
+/// @brief Initializes the operator selector with the given starting probabilities
+/// @param selector the operator selector
+/// @param cycle_probability the probability of a move to rotate three cells of a region
+/// @param chain_probability the probability of a move to be an ejection chain
+/// @param adaptive if the probabilities are adapted during the run
+void operator_selector_init(struct operator_selector *selector, double cycle_probability, double chain_probability, bool adaptive)
+{
+    selector->adaptive = adaptive;
+    selector->probability[OPERATOR_CHANGE] = 1 - cycle_probability - chain_probability;
+    selector->probability[OPERATOR_CYCLE] = cycle_probability;
+    selector->probability[OPERATOR_CHAIN] = chain_probability;
+
+    double sum = 0;
+    for (int op = 0; op < OPERATORS; op++)
+    {
+        // every operator must be tried to learn anything about it
+        if (adaptive && selector->probability[op] < ADAPTIVE_MIN_PROBABILITY)
+            selector->probability[op] = ADAPTIVE_MIN_PROBABILITY;
+        sum += selector->probability[op];
+
+        selector->quality[op] = 0;
+        selector->uses[op] = 0;
+        selector->gain[op] = 0;
+        selector->timed[op] = 0;
+        selector->time[op] = 0;
+        selector->total[op] = 0;
+    }
+
+    for (int op = 0; op < OPERATORS; op++)
+        selector->probability[op] /= sum;
+}
+
+/// @brief Chooses the operator of the next move
+/// @param selector the operator selector
+/// @param seed the seed used in the pseudo random number generator
+/// @return the chosen operator
+enum sudoku_operator operator_select(struct operator_selector *selector, unsigned int *seed)
+{
+    // single cell changes only, don't waste a random number
+    if (selector->probability[OPERATOR_CHANGE] >= 1)
+        return OPERATOR_CHANGE;
+
+    double u = get_random(seed);
+    for (int op = OPERATORS - 1; op > 0; op--)
+    {
+        if (u < selector->probability[op])
+            return op;
+        u -= selector->probability[op];
+    }
+    return OPERATOR_CHANGE;
+}
+
+/// @brief Tells if the next use of the given operator must be timed, only one use every ADAPTIVE_TIMING_PERIOD is timed
+/// @param selector the operator selector
+/// @param operator the operator
+/// @return true if the use must be timed
+bool operator_timed(struct operator_selector *selector, enum sudoku_operator operator)
+{
+    return selector->adaptive && selector->total[operator] % ADAPTIVE_TIMING_PERIOD == 0;
+}
+
+/// @brief Records the CPU time taken by a timed use of the given operator
+/// @param selector the operator selector
+/// @param operator the operator
+/// @param time the CPU time taken to propose and evaluate the move
+void operator_time(struct operator_selector *selector, enum sudoku_operator operator, double time)
+{
+    selector->timed[operator]++;
+    selector->time[operator] += time;
+}
+
+/// @brief Credits the given operator with the cost improvement made by its move (0 when the move was rejected)
+/// @param selector the operator selector
+/// @param operator the operator
+/// @param gain the decrease of the cost of the grid
+void operator_credit(struct operator_selector *selector, enum sudoku_operator operator, int gain)
+{
+    selector->uses[operator]++;
+    selector->total[operator]++;
+    if (gain > 0) // accepted uphill moves are part of the annealing, they aren't held against the operator
+        selector->gain[operator] += gain;
+}
+
+/// @brief Updates the probabilities of the operators from the credits since the last update (adaptive selection only)
+/// @param selector the operator selector
+void operator_selector_update(struct operator_selector *selector)
+{
+    if (!selector->adaptive)
+        return;
+
+    double sum = 0;
+    for (int op = 0; op < OPERATORS; op++)
+    {
+        if (selector->uses[op] > 0 && selector->timed[op] > 0)
+        {
+            // improvement per second of CPU time, the time of the uses is estimated from the timed ones
+            double time = selector->uses[op] * (selector->time[op] / selector->timed[op]);
+            double reward = (time > 0) ? selector->gain[op] / time : 0;
+            selector->quality[op] += ADAPTIVE_LEARNING_RATE * (reward - selector->quality[op]);
+        }
+        sum += selector->quality[op];
+
+        selector->uses[op] = 0;
+        selector->gain[op] = 0;
+    }
+
+    if (sum <= 0)
+        return;
+
+    // probability matching: the probabilities follow the qualities above the floor
+    for (int op = 0; op < OPERATORS; op++)
+        selector->probability[op] = ADAPTIVE_MIN_PROBABILITY + (1 - OPERATORS * ADAPTIVE_MIN_PROBABILITY) * selector->quality[op] / sum;
+}
+
+/// @brief Gets the name of the given operator
+/// @param operator the operator
+/// @return the name of the operator
+const char *operator_name(enum sudoku_operator operator)
+{
+    switch (operator)
+    {
+    case OPERATOR_CYCLE:
+        return "region 3-cycles";
+    case OPERATOR_CHAIN:
+        return "ejection chains";
+    default:
+        return "single cell changes";
+    }
+}
+
+/// @brief Prints the configuration of the operator selection of the sudoku solving algorithm
+/// @param selector the operator selector
+void operator_selector_print(struct operator_selector *selector)
+{
+    printf("  %s>[MOVES]Probability of each kind of move:%s", CLR_YEL, CLR_RESET);
+    for (int op = 0; op < OPERATORS; op++)
+        printf(" %s %s%.0f%%%s%s", operator_name(op), CLR_GRN, selector->probability[op] * 100, CLR_RESET, (op < OPERATORS - 1) ? "," : "\n");
+
+    if (selector->adaptive) printf("  %s>[ADAPTIVE_OPERATORS]Adapt the probabilities of the moves to their improvement per second:%s %sON%s\n", CLR_YEL, CLR_RESET, CLR_GRN, CLR_RESET);
+    else printf("  %s>[ADAPTIVE_OPERATORS]Adapt the probabilities of the moves to their improvement per second:%s %sOFF%s\n", CLR_YEL, CLR_RESET, CLR_RED, CLR_RESET);
+}
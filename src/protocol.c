@@ -0,0 +1,89 @@
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "protocol.h"
+
+_Static_assert(sizeof(struct protocol_solve) == 104 && sizeof(struct protocol_solution) == 120 &&
+                   sizeof(struct protocol_counters) == 80 && sizeof(struct protocol_progress) == 112,
+               "the bodies of the frames have a fixed layout");
+
+/// @brief Gets the size of the frames of the given type
+/// @param type the type of the message
+/// @return the size of the frame, 0 for an unknown type
+static size_t protocol_frame_size(uint32_t type)
+{
+    switch (type)
+    {
+    case PROTOCOL_SOLVE:
+        return sizeof(struct protocol_header) + sizeof(struct protocol_solve);
+    case PROTOCOL_STATS:
+        return sizeof(struct protocol_header);
+    case PROTOCOL_SOLUTION:
+        return sizeof(struct protocol_header) + sizeof(struct protocol_solution);
+    case PROTOCOL_COUNTERS:
+        return sizeof(struct protocol_header) + sizeof(struct protocol_counters);
+    case PROTOCOL_PROGRESS:
+        return sizeof(struct protocol_header) + sizeof(struct protocol_progress);
+    default:
+        return 0;
+    }
+}
+
+/// @brief Starts a message of the given type, its header filled and its body zeroed
+/// @param message the message
+/// @param type the type of the message
+/// @param id the id of the message
+void protocol_message_init(struct protocol_message *message, enum protocol_type type, uint32_t id)
+{
+    memset(message, 0, sizeof(struct protocol_message));
+    message->header.length = (uint32_t)protocol_frame_size(type);
+    message->header.type = type;
+    message->header.id = id;
+}
+
+/// @brief Parses the frame at the start of a buffer
+/// @param buffer the bytes received
+/// @param n the number of bytes received
+/// @param message the message parsed
+/// @return the size of the frame, 0 if the frame isn't complete yet, -1 if it isn't a valid frame
+long protocol_parse(const uint8_t *buffer, size_t n, struct protocol_message *message)
+{
+    struct protocol_header header;
+    if (n < sizeof(header))
+        return 0;
+    memcpy(&header, buffer, sizeof(header));
+
+    // every type has a single size, a frame of another size is garbage and the stream can't be resynchronized
+    size_t size = protocol_frame_size(header.type);
+    if (size == 0 || header.length != size)
+        return -1;
+    if (n < size)
+        return 0;
+    memset(message, 0, sizeof(struct protocol_message));
+    memcpy(message, buffer, size);
+    return (long)size;
+}
+
+/// @brief Sends the frame of a message on a blocking socket, a broken connection doesn't raise SIGPIPE
+/// @param fd the socket
+/// @param message the message
+/// @return false if the frame couldn't be sent whole (connection closed, send timeout), true otherwise
+bool protocol_send(int fd, const struct protocol_message *message)
+{
+    const char *bytes = (const char *)message;
+    size_t size = message->header.length;
+    while (size > 0)
+    {
+        ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        bytes += sent;
+        size -= sent;
+    }
+    return true;
+}
@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "utils.h"
+#include "cost.h"
+#include "trace.h"
+
+/// @brief Prints how to use the trace replay program
+/// @param program the name of the program
+void print_usage(char *program)
+{
+    fprintf(stderr, "Use: %s [-c] [-v] trace [move]\n", program);
+    fprintf(stderr, "Where :\n");
+    fprintf(stderr, "  trace : The trace file recorded by the solver (main -T trace)\n");
+    fprintf(stderr, "  move  : The number of moves after which the grid and its cost are rebuilt (default the end of the run)\n");
+    fprintf(stderr, "Flags :\n");
+    fprintf(stderr, "  -c    : Print the cost at each temperature step instead (moves, try, temperature and cost per line)\n");
+    fprintf(stderr, "  -v    : Check the cost recorded against the cost of the grid rebuilt after each event\n");
+}
+
+int main(int argc, char *argv[])
+{
+    bool curve = false, verify = false;
+    int option;
+    while ((option = getopt(argc, argv, "cv")) != -1)
+    {
+        switch (option)
+        {
+        case 'c':
+            curve = true;
+            break;
+        case 'v':
+            verify = true;
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (argc - optind < 1)
+    {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    long long target = (argc - optind > 1) ? atoll(argv[optind + 1]) : -1;
+
+    struct trace_reader reader;
+    if (!trace_reader_open(&reader, argv[optind]))
+    {
+        fprintf(stderr, "ERROR: %s isn't a trace file\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+    struct trace_header *header = &reader.header;
+
+    // the grid of the puzzle, then the grid of the run rebuilt from it
+    int givens[SUDOKU_SIZE][SUDOKU_SIZE];
+    int *original_grid[SUDOKU_SIZE];
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        givens[i / SUDOKU_SIZE][i % SUDOKU_SIZE] = (header->givens[i / 2] >> ((i % 2 == 0) ? 4 : 0)) & 0xf;
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+        original_grid[i] = givens[i];
+    int **lines = create_sudoku_lines(original_grid);
+    int ***regions = (lines != NULL) ? create_sudoku_region(lines) : NULL;
+    int ***columns = (lines != NULL) ? create_sudoku_columns(lines) : NULL;
+    if (regions == NULL || columns == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    struct cost_model model;
+    cost_model_init(&model, (enum cost_function)header->cost_function, original_grid, NULL);
+    // the weights and the promoted cells make the recorded costs differ from the unweighted cost of the grid
+    bool exact = (header->flags & (TRACE_WEIGHTED | TRACE_TIGHTENED)) == 0;
+    if (verify && !exact)
+        fprintf(stderr, "WARNING: the run weighted the constraints or promoted cells, its costs can't be checked\n");
+
+    struct trace_record record;
+    long long moves = 0, accepted = 0, rejected = 0, snapshots = 0, steps = 0, mismatches = 0;
+    int cost = 0, try = -1, final_cost = -1;
+    double temperature = 0;
+    bool ended = false;
+
+    while (trace_read(&reader, &record))
+    {
+        if (target >= 0 && record.moves > target)
+            break;
+        moves = record.moves;
+
+        switch (record.event)
+        {
+        case TRACE_TRY:
+            try = record.try;
+            /* fall through */
+        case TRACE_GRID:
+            for (int i = 0; i < SUDOKU_SIZE; i++)
+                memcpy(lines[i], record.grid[i], sizeof(int) * SUDOKU_SIZE);
+            cost = record.cost;
+            snapshots++;
+            break;
+        case TRACE_MOVE:
+            if (!record.accepted)
+            {
+                rejected++;
+                continue;
+            }
+            for (int k = 0; k < record.n; k++)
+                lines[record.line[k]][record.column[k]] = record.value[k];
+            cost += record.delta;
+            accepted++;
+            break;
+        case TRACE_TEMPERATURE:
+            temperature = record.temperature;
+            steps++;
+            if (curve)
+                printf("%lld %d %f %d\n", moves, try, temperature, cost);
+            continue;
+        case TRACE_COST:
+            cost = record.cost;
+            break;
+        case TRACE_END:
+            final_cost = record.cost;
+            ended = true;
+            break;
+        }
+
+        if (verify && exact && record.event != TRACE_END && sudoku_cost(lines, columns, regions, &model) != cost)
+        {
+            if (mismatches++ == 0)
+                fprintf(stderr, "ERROR: cost %d recorded after %lld moves, the grid rebuilt costs %d\n", cost, moves,
+                        sudoku_cost(lines, columns, regions, &model));
+        }
+        if (ended)
+            break;
+    }
+
+    if (!ended && target < 0)
+        fprintf(stderr, "WARNING: the trace is truncated, the run is rebuilt up to its last event\n");
+
+    if (!curve)
+    {
+        printf("%s#Trace of the run of seed [%u]%s\n", CLR_GRN, header->seed, CLR_RESET);
+        printf("  %s>Level:%s %s%s%s\n", CLR_YEL, CLR_RESET, CLR_GRN, trace_level_name(header->level), CLR_RESET);
+        printf("  %s>Cost function:%s %s%s%s\n", CLR_YEL, CLR_RESET, CLR_GRN, cost_function_name(header->cost_function), CLR_RESET);
+        if (header->level == TRACE_SAMPLED)
+            printf("  %s>Snapshot every:%s %s%u moves%s\n", CLR_YEL, CLR_RESET, CLR_GRN, header->sample_period, CLR_RESET);
+        printf(">> Moves : %lld (%lld accepted", moves, accepted);
+        if (header->level == TRACE_COMPLETE)
+            printf(", %lld rejected", rejected);
+        printf(")\n>> Try : %d\n>> Temperature steps : %lld\n>> Temperature : %f\n>> Grids recorded : %lld\n", try, steps, temperature, snapshots);
+        printf(">> Cost recorded : %d\n", cost);
+        printf(">> Unweighted cost of the grid : %d\n", sudoku_cost(lines, columns, regions, &model));
+        if (ended)
+            printf(">> Final cost of the run : %d\n", final_cost);
+        print_sudoku(lines);
+    }
+    if (verify && exact)
+        fprintf(stderr, ">> Cost mismatches : %lld\n", mismatches);
+
+    sudoku_free_pointers(regions);
+    sudoku_free_pointers(columns);
+    sudoku_free(lines);
+    trace_reader_close(&reader);
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,155 @@
+#include "restart.h"
+
+/// @brief Initializes the restart policy with the default settings from the configuration
+/// @param policy the restart policy
+/// @param strategy the restart strategy used
+/// @param perturbation fraction of the free cells of the best grid randomized at each restart
+void restart_policy_init(struct restart_policy *policy, enum restart_strategy strategy, double perturbation)
+{
+    policy->strategy = strategy;
+    policy->base = RESTART_BASE;
+    policy->factor = RESTART_FACTOR;
+    policy->plateau = RESTART_PLATEAU_STEPS;
+    policy->perturbation = perturbation;
+
+    policy->tries = 0;
+    policy->budget = COOLING_STEPS;
+    policy->steps = 0;
+    policy->best_cost = INT_MAX;
+    policy->stale = 0;
+}
+
+/// @brief Finds the restart strategy corresponding to the given name
+/// @param name the name of the strategy (fixed, luby, geometric or plateau)
+/// @param strategy the corresponding strategy
+/// @return true if the name is a known strategy, false otherwise
+bool restart_strategy_parse(const char *name, enum restart_strategy *strategy)
+{
+    for (enum restart_strategy s = RESTART_FIXED; s <= RESTART_PLATEAU; s++)
+    {
+        if (strcmp(name, restart_strategy_name(s)) == 0)
+        {
+            *strategy = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Gets the name of the given restart strategy
+/// @param strategy the restart strategy
+/// @return the name of the strategy
+const char *restart_strategy_name(enum restart_strategy strategy)
+{
+    switch (strategy)
+    {
+    case RESTART_LUBY:
+        return "luby";
+    case RESTART_GEOMETRIC:
+        return "geometric";
+    case RESTART_PLATEAU:
+        return "plateau";
+    default:
+        return "fixed";
+    }
+}
+
+/// @brief Gets the i-th term of the Luby sequence (1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...)
+/// @param i the index of the term, starting at 1
+/// @return the i-th term of the sequence
+int luby(int i)
+{
+    int k = 1;
+    while ((1 << k) - 1 < i) // find the subsequence 2^k - 1 the term belongs to
+        k++;
+
+    if (i == (1 << k) - 1)
+        return 1 << (k - 1);
+    return luby(i - (1 << (k - 1)) + 1);
+}
+
+/// @brief Starts a new try and computes its length
+/// @param policy the restart policy
+/// @param cost the cost of the grid at the start of the try
+/// @return the number of temperature steps of the try
+int restart_policy_start_try(struct restart_policy *policy, int cost)
+{
+    double budget;
+
+    switch (policy->strategy)
+    {
+    case RESTART_LUBY:
+        budget = (double)policy->base * luby(policy->tries + 1);
+        break;
+    case RESTART_GEOMETRIC:
+        budget = policy->base * pow(policy->factor, policy->tries);
+        break;
+    default: // fixed and plateau tries go down the whole temperature schedule
+        budget = COOLING_STEPS;
+        break;
+    }
+
+    policy->tries++;
+    policy->budget = (budget > INT_MAX / 2) ? INT_MAX / 2 : (int)budget;
+    policy->steps = 0;
+    policy->best_cost = cost;
+    policy->stale = 0;
+
+    return policy->budget;
+}
+
+/// @brief Records a temperature step of the current try and decides if the try must be restarted
+/// @param policy the restart policy
+/// @param cost the cost of the grid at the end of the temperature step
+/// @return true if the current try must be stopped, false otherwise
+bool restart_policy_step(struct restart_policy *policy, int cost)
+{
+    policy->steps++;
+    if (cost < policy->best_cost)
+    {
+        policy->best_cost = cost;
+        policy->stale = 0;
+    }
+    else
+    {
+        policy->stale++;
+    }
+
+    switch (policy->strategy)
+    {
+    case RESTART_LUBY:
+    case RESTART_GEOMETRIC:
+        return policy->steps >= policy->budget;
+    case RESTART_PLATEAU:
+        return policy->stale >= policy->plateau;
+    default: // the try stops once the stop temperature is reached
+        return false;
+    }
+}
+
+/// @brief Prints the restart policy along with the configuration of the sudoku solving algorithm
+/// @param policy the restart policy
+void restart_policy_print(struct restart_policy *policy)
+{
+    printf("  %s>[RESTART_STRATEGY]Restart strategy:%s %s%s%s", CLR_YEL, CLR_RESET, CLR_GRN, restart_strategy_name(policy->strategy), CLR_RESET);
+    switch (policy->strategy)
+    {
+    case RESTART_LUBY:
+        printf(" (base of %d temperature steps)\n", policy->base);
+        break;
+    case RESTART_GEOMETRIC:
+        printf(" (base of %d temperature steps, factor of %f)\n", policy->base, policy->factor);
+        break;
+    case RESTART_PLATEAU:
+        printf(" (after %d temperature steps without improvement)\n", policy->plateau);
+        break;
+    default:
+        printf("\n");
+        break;
+    }
+
+    if (policy->perturbation > 0)
+        printf("  %s>[RESTART_PERTURBATION]Restart from the best sudoku found with randomized cells:%s %s%.0f%%%s\n", CLR_YEL, CLR_RESET, CLR_GRN, policy->perturbation * 100, CLR_RESET);
+    else
+        printf("  %s>[RESTART_PERTURBATION]Restart from the best sudoku found with randomized cells:%s %sOFF%s\n", CLR_YEL, CLR_RESET, CLR_RED, CLR_RESET);
+}
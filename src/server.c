@@ -0,0 +1,499 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <omp.h>
+
+#include "server.h"
+#include "libsudoku.h"
+
+/// @brief Makes a file descriptor non blocking and closed on exec
+/// @param fd the file descriptor
+static void server_fd_setup(int fd)
+{
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) == -1 || fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
+    {
+        perror("Problem encountered when setting up the socket of the daemon");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/// @brief Wakes up the polling thread, async-signal-safe
+/// @param server the daemon
+static void server_wake(struct sudoku_server *server)
+{
+    char byte = 0;
+    int saved = errno;
+    // a full pipe means the polling thread is woken up already
+    (void)!write(server->wake[1], &byte, 1);
+    errno = saved;
+}
+
+/// @brief Opens the daemon: the UNIX socket is created at the given path (a socket left by a daemon that isn't running
+///        anymore is replaced), the program stops if it can't be
+/// @param server the daemon
+/// @param path the path of the socket
+/// @param options the settings of the solving algorithm, shared by the workers, their deadline is the one of the puzzles
+///        sent without one
+/// @param workers the number of workers
+void sudoku_server_open(struct sudoku_server *server, const char *path, struct solver_options *options, int workers)
+{
+    memset(server, 0, sizeof(struct sudoku_server));
+    server->path = path;
+    server->options = options;
+    server->workers = (workers > 0) ? workers : 1;
+    server->counters.workers = server->workers;
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "ERROR: the path of the socket %s is too long\n", path);
+        exit(EXIT_FAILURE);
+    }
+    strcpy(address.sun_path, path);
+
+    if ((server->listener = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+    {
+        perror("Problem encountered when creating the socket of the daemon");
+        exit(EXIT_FAILURE);
+    }
+
+    // a socket nobody listens to anymore is left by a daemon that was killed, one still answering belongs to a running daemon
+    if (connect(server->listener, (struct sockaddr *)&address, sizeof(address)) == 0)
+    {
+        fprintf(stderr, "ERROR: a daemon is already running on %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (errno == ECONNREFUSED)
+        unlink(path);
+    close(server->listener);
+
+    if ((server->listener = socket(AF_UNIX, SOCK_STREAM, 0)) == -1 ||
+        bind(server->listener, (struct sockaddr *)&address, sizeof(address)) == -1 || listen(server->listener, SOMAXCONN) == -1)
+    {
+        perror("Problem encountered when creating the socket of the daemon");
+        exit(EXIT_FAILURE);
+    }
+    server_fd_setup(server->listener);
+
+    if (pipe(server->wake) == -1)
+    {
+        perror("Problem encountered when creating the socket of the daemon");
+        exit(EXIT_FAILURE);
+    }
+    server_fd_setup(server->wake[0]);
+    server_fd_setup(server->wake[1]);
+
+    if ((server->connections = calloc(SERVER_CONNECTIONS, sizeof(struct server_connection))) == NULL ||
+        (server->queue = calloc(SERVER_QUEUE, sizeof(struct server_job))) == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < SERVER_CONNECTIONS; k++)
+    {
+        server->connections[k].fd = -1;
+        pthread_mutex_init(&server->connections[k].write_lock, NULL);
+    }
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_cond_init(&server->work, NULL);
+    server->start_time = omp_get_wtime();
+}
+
+/// @brief Stops the daemon, can be called from a signal handler
+/// @param server the daemon
+void sudoku_server_stop(struct sudoku_server *server)
+{
+    server->stop = 1;
+    server_wake(server);
+}
+
+/// @brief Gets the counters of the daemon
+/// @param server the daemon
+/// @param counters the counters
+void sudoku_server_counters(struct sudoku_server *server, struct protocol_counters *counters)
+{
+    pthread_mutex_lock(&server->lock);
+    *counters = server->counters;
+    counters->uptime = omp_get_wtime() - server->start_time;
+    counters->connections = server->connected;
+    counters->queued = server->queued;
+    counters->running = server->running;
+    pthread_mutex_unlock(&server->lock);
+}
+
+/// @brief Sends a message to a client, one message at a time on its socket. Nothing is sent anymore once a message couldn't
+///        be, so the workers waiting for the socket of a client not reading don't wait for the timeout one after the other
+/// @param server the daemon
+/// @param connection the client
+/// @param message the message
+/// @return false if the message wasn't sent whole, the connection is then broken
+static bool server_send(struct sudoku_server *server, struct server_connection *connection, const struct protocol_message *message)
+{
+    pthread_mutex_lock(&connection->write_lock);
+    pthread_mutex_lock(&server->lock);
+    bool broken = connection->broken;
+    pthread_mutex_unlock(&server->lock);
+
+    bool sent = !broken && protocol_send(connection->fd, message);
+    if (!broken && !sent)
+    {
+        pthread_mutex_lock(&server->lock);
+        connection->broken = true;
+        pthread_mutex_unlock(&server->lock);
+    }
+    pthread_mutex_unlock(&connection->write_lock);
+    return sent;
+}
+
+/// @brief Accepts the clients waiting on the socket, as long as there is a free slot for them
+/// @param server the daemon
+static void server_accept(struct sudoku_server *server)
+{
+    // the answers are sent by blocking writes, bounded by a timeout in case the client doesn't read them anymore
+    struct timeval timeout = {.tv_sec = SERVER_SEND_TIMEOUT, .tv_usec = 0};
+    int slot = 0;
+    while (server->connected < SERVER_CONNECTIONS)
+    {
+        int fd = accept(server->listener, NULL, NULL);
+        if (fd == -1)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                perror("Problem encountered when accepting a client of the daemon");
+            return;
+        }
+        if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1 || setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == -1)
+        {
+            perror("Problem encountered when accepting a client of the daemon");
+            close(fd);
+            continue;
+        }
+
+        while (server->connections[slot].fd != -1)
+            slot++;
+        struct server_connection *connection = &server->connections[slot];
+        pthread_mutex_lock(&server->lock);
+        connection->fd = fd;
+        connection->reading = true;
+        connection->broken = false;
+        connection->pending = 0;
+        connection->filled = 0;
+        server->connected++;
+        pthread_mutex_unlock(&server->lock);
+    }
+}
+
+/// @brief Parses the frames received from a client: a puzzle or a stats query is queued for the workers as long as there
+///        is room for it (the frames left wait for room in the buffer), the frames of a client whose answers are lost are dropped
+/// @param server the daemon
+/// @param connection the client
+static void server_dispatch(struct sudoku_server *server, struct server_connection *connection)
+{
+    struct protocol_message message;
+    size_t offset = 0;
+    while (connection->reading)
+    {
+        long size = protocol_parse(connection->input + offset, connection->filled - offset, &message);
+        if (size == 0)
+            break;
+        if (size == -1 || (message.header.type != PROTOCOL_SOLVE && message.header.type != PROTOCOL_STATS))
+        { // the stream can't be resynchronized, the answers of the requests already received are still sent
+            fprintf(stderr, "WARNING: invalid frame received from a client of the daemon, the client is not read anymore\n");
+            connection->reading = false;
+            offset = connection->filled;
+            break;
+        }
+
+        pthread_mutex_lock(&server->lock);
+        if (connection->broken)
+        { // no answer can reach the client anymore, it is disconnected once its requests in flight are done
+            pthread_mutex_unlock(&server->lock);
+            connection->reading = false;
+            offset = connection->filled;
+            break;
+        }
+        if (server->queued >= SERVER_QUEUE || connection->pending >= SERVER_PIPELINE)
+        { // backpressure: the request waits in the buffer, and the next ones in the socket
+            pthread_mutex_unlock(&server->lock);
+            break;
+        }
+        struct server_job *job = &server->queue[(server->head + server->queued) % SERVER_QUEUE];
+        job->connection = connection;
+        job->id = message.header.id;
+        job->stats = (message.header.type == PROTOCOL_STATS);
+        if (!job->stats)
+        {
+            job->seed = message.body.solve.seed;
+            job->deadline = (message.body.solve.deadline > 0) ? message.body.solve.deadline : server->options->deadline;
+            job->progress = (message.body.solve.flags & PROTOCOL_WITH_PROGRESS) != 0;
+            memcpy(job->puzzle, message.body.solve.puzzle, PUZZLE_SIZE);
+            job->puzzle[PUZZLE_SIZE] = '\0';
+            server->counters.requests++;
+        }
+        server->queued++;
+        connection->pending++;
+        pthread_cond_signal(&server->work);
+        pthread_mutex_unlock(&server->lock);
+        offset += size;
+    }
+
+    memmove(connection->input, connection->input + offset, connection->filled - offset);
+    connection->filled -= offset;
+}
+
+/// @brief Receives the bytes sent by a client and parses them
+/// @param server the daemon
+/// @param connection the client
+static void server_receive(struct sudoku_server *server, struct server_connection *connection)
+{
+    ssize_t received = recv(connection->fd, connection->input + connection->filled, SERVER_INPUT_SIZE - connection->filled,
+                            MSG_DONTWAIT);
+    if (received == 0)
+        connection->reading = false; // the client closed its side, it still reads the answers
+    else if (received == -1)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return;
+        connection->reading = false;
+        pthread_mutex_lock(&server->lock);
+        connection->broken = true;
+        pthread_mutex_unlock(&server->lock);
+    }
+    else
+        connection->filled += received;
+    server_dispatch(server, connection);
+}
+
+/// @brief Polls the socket and the clients until the daemon is stopped, run by the first thread
+/// @param server the daemon
+static void server_poll(struct sudoku_server *server)
+{
+    struct pollfd fds[SERVER_CONNECTIONS + 2];
+    struct server_connection *polled[SERVER_CONNECTIONS + 2];
+
+    while (!server->stop)
+    {
+        int n = 0;
+        fds[n++] = (struct pollfd){.fd = server->wake[0], .events = POLLIN};
+        if (server->connected < SERVER_CONNECTIONS)
+            fds[n++] = (struct pollfd){.fd = server->listener, .events = POLLIN};
+        int first = n;
+
+        for (int k = 0; k < SERVER_CONNECTIONS; k++)
+        {
+            struct server_connection *connection = &server->connections[k];
+            if (connection->fd == -1)
+                continue;
+            // the frames left in the buffer by the backpressure are queued as soon as there is room for them
+            if (connection->reading && connection->filled > 0)
+                server_dispatch(server, connection);
+
+            pthread_mutex_lock(&server->lock);
+            bool done = (!connection->reading || connection->broken) && connection->pending == 0;
+            bool room = server->queued < SERVER_QUEUE && connection->pending < SERVER_PIPELINE;
+            if (done)
+            { // every answer is sent (or lost), the client is disconnected
+                close(connection->fd);
+                connection->fd = -1;
+                server->connected--;
+            }
+            pthread_mutex_unlock(&server->lock);
+
+            if (!done && connection->reading && !connection->broken && room && connection->filled < SERVER_INPUT_SIZE)
+            {
+                polled[n] = connection;
+                fds[n++] = (struct pollfd){.fd = connection->fd, .events = POLLIN};
+            }
+        }
+
+        if (poll(fds, n, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Problem encountered when polling the clients of the daemon");
+            exit(EXIT_FAILURE);
+        }
+
+        char bytes[64];
+        if (fds[0].revents & POLLIN)
+            while (read(server->wake[0], bytes, sizeof(bytes)) > 0)
+                ;
+        if (first == 2 && (fds[1].revents & POLLIN))
+            server_accept(server);
+        for (int k = first; k < n; k++)
+        {
+            if (fds[k].revents != 0)
+                server_receive(server, polled[k]);
+        }
+    }
+
+    // the puzzles being solved are finished and answered, the queued ones are dropped
+    pthread_mutex_lock(&server->lock);
+    for (int k = 0; k < server->queued; k++)
+    {
+        struct server_job *job = &server->queue[(server->head + k) % SERVER_QUEUE];
+        job->connection->pending--;
+        server->counters.dropped += !job->stats;
+    }
+    server->queued = 0;
+    server->stopping = true;
+    pthread_cond_broadcast(&server->work);
+    pthread_mutex_unlock(&server->lock);
+}
+
+/// @brief A puzzle being solved by a worker, given to the progress callback
+struct server_task
+{
+    struct sudoku_server *server;
+    struct server_job *job;
+};
+
+/// @brief Sends a grid of lower cost found while solving a puzzle to its client, the progress callback of the workers
+/// @param progress the progress of the solving
+/// @param data the puzzle being solved
+static void server_progress(const struct solver_progress *progress, void *data)
+{
+    struct server_task *task = data;
+    struct protocol_message message;
+    protocol_message_init(&message, PROTOCOL_PROGRESS, task->job->id);
+    message.body.progress.moves = progress->moves;
+    message.body.progress.time = progress->time;
+    message.body.progress.lowest_cost = progress->lowest_cost;
+    message.body.progress.tries = progress->tries;
+    message.body.progress.generations = progress->generations;
+    for (int cell = 0; cell < PUZZLE_SIZE; cell++)
+        message.body.progress.grid[cell] = (char)('0' + progress->grid[cell / SUDOKU_SIZE][cell % SUDOKU_SIZE]);
+    server_send(task->server, task->job->connection, &message);
+}
+
+/// @brief Solves the queued puzzles one after the other and sends their answers until the daemon is stopped, run by each worker
+/// @param server the daemon
+static void server_work(struct sudoku_server *server)
+{
+    struct protocol_message answer;
+    struct libsudoku_solution solution;
+    struct solver_options options = *server->options;
+    struct server_job job;
+    struct server_task task = {.server = server, .job = &job};
+
+    pthread_mutex_lock(&server->lock);
+    while (true)
+    {
+        while (server->queued == 0 && !server->stopping)
+            pthread_cond_wait(&server->work, &server->lock);
+        if (server->queued == 0)
+            break;
+        job = server->queue[server->head];
+        server->head = (server->head + 1) % SERVER_QUEUE;
+        server->queued--;
+        server->running += !job.stats;
+        pthread_mutex_unlock(&server->lock);
+
+        if (job.stats)
+        { // the send may block up to SERVER_SEND_TIMEOUT, here it only holds up this worker
+            protocol_message_init(&answer, PROTOCOL_COUNTERS, job.id);
+            sudoku_server_counters(server, &answer.body.counters);
+            server_send(server, job.connection, &answer);
+
+            pthread_mutex_lock(&server->lock);
+            job.connection->pending--;
+            server_wake(server);
+            continue;
+        }
+
+        // the deadline and the progress are the ones asked for by the client
+        options.deadline = job.deadline;
+        options.progress = (job.progress) ? server_progress : NULL;
+        options.progress_data = &task;
+        double start_time = omp_get_wtime();
+        enum libsudoku_status status = libsudoku_solve(job.puzzle, &options, job.seed, &solution);
+        double busy = omp_get_wtime() - start_time;
+
+        protocol_message_init(&answer, PROTOCOL_SOLUTION, job.id);
+        answer.body.solution.status = status;
+        if (status == LIBSUDOKU_OK)
+        {
+            answer.body.solution.moves = solution.result.moves;
+            answer.body.solution.time = solution.result.time;
+            answer.body.solution.cost = solution.result.cost;
+            answer.body.solution.lowest_cost = solution.result.lowest_cost;
+            answer.body.solution.tries = solution.result.tries;
+            answer.body.solution.generations = solution.result.generations;
+            answer.body.solution.solved = solution.result.solved;
+            answer.body.solution.cached = solution.result.cached;
+            answer.body.solution.expired = solution.result.expired;
+            memcpy(answer.body.solution.grid, solution.grid, PUZZLE_SIZE);
+        }
+
+        // the connection stays open until its last answer, a client gone only loses its answers
+        bool sent = server_send(server, job.connection, &answer);
+
+        pthread_mutex_lock(&server->lock);
+        server->running--;
+        job.connection->pending--;
+        if (!sent)
+            server->counters.dropped++;
+        else
+            server->counters.answered++;
+        server->counters.busy += busy;
+        if (status != LIBSUDOKU_OK)
+            server->counters.errors++;
+        else if (solution.result.solved)
+        {
+            server->counters.solved++;
+            server->counters.cached += solution.result.cached;
+        }
+        server_wake(server);
+    }
+    pthread_mutex_unlock(&server->lock);
+}
+
+/// @brief Serves the clients until the daemon is stopped, the puzzles being solved are then answered and the queued ones dropped
+/// @param server the daemon
+void sudoku_server_run(struct sudoku_server *server)
+{
+    #pragma omp parallel num_threads(server->workers + 1)
+    {
+        if (omp_get_thread_num() == 0)
+        {
+            if (omp_get_num_threads() < 2)
+            {
+                fprintf(stderr, "ERROR: no thread left for the workers of the daemon\n");
+                exit(EXIT_FAILURE);
+            }
+            server_poll(server);
+        }
+        else
+            server_work(server);
+    }
+}
+
+/// @brief Closes the daemon: the clients are disconnected and the socket removed
+/// @param server the daemon
+void sudoku_server_close(struct sudoku_server *server)
+{
+    for (int k = 0; k < SERVER_CONNECTIONS; k++)
+    {
+        if (server->connections[k].fd != -1)
+            close(server->connections[k].fd);
+        pthread_mutex_destroy(&server->connections[k].write_lock);
+    }
+    close(server->listener);
+    close(server->wake[0]);
+    close(server->wake[1]);
+    unlink(server->path);
+    pthread_mutex_destroy(&server->lock);
+    pthread_cond_destroy(&server->work);
+    free(server->connections);
+    free(server->queue);
+}
@@ -0,0 +1,279 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sink.h"
+
+/// @brief Finds the result format corresponding to the given name
+/// @param name the name of the format (jsonl or binary)
+/// @param format the corresponding format
+/// @return true if the name is a known format, false otherwise
+bool sink_format_parse(const char *name, enum sink_format *format)
+{
+    for (int kind = 0; kind < SINK_FORMATS; kind++)
+    {
+        if (strcmp(name, sink_format_name(kind)) == 0)
+        {
+            *format = kind;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Gets the name of the given result format
+/// @param format the result format
+/// @return the name of the format
+const char *sink_format_name(enum sink_format format)
+{
+    switch (format)
+    {
+    case SINK_JSONL:
+        return "jsonl";
+    case SINK_BINARY:
+        return "binary";
+    default:
+        return "unknown";
+    }
+}
+
+/// @brief Maps the given number of records of a binary result file, the file is extended to hold them
+/// @param sink the result sink
+/// @param capacity the number of records
+static void result_sink_map(struct result_sink *sink, size_t capacity)
+{
+    size_t size = sizeof(struct sink_header) + capacity * sizeof(struct sink_record);
+    if (sink->map != NULL)
+        munmap(sink->map, sizeof(struct sink_header) + sink->capacity * sizeof(struct sink_record));
+
+    // the records added by the extension of the file read as zeros, they are not written yet
+    if (ftruncate(sink->fd, size) == -1 || (sink->map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, sink->fd, 0)) == MAP_FAILED)
+    {
+        perror("Problem encountered when mapping the result file");
+        exit(EXIT_FAILURE);
+    }
+    sink->capacity = capacity;
+}
+
+/// @brief Opens a result file, the results are appended to the ones it already holds
+/// @param sink the result sink
+/// @param filename the result file, created if needed
+/// @param format the format of the file
+void result_sink_open(struct result_sink *sink, const char *filename, enum sink_format format)
+{
+    memset(sink, 0, sizeof(struct result_sink));
+    sink->format = format;
+
+    if (format == SINK_JSONL)
+    { // every batch is appended at once, the lines of concurrent runs don't mix
+        if ((sink->fd = open(filename, O_WRONLY | O_CREAT | O_APPEND, 0644)) == -1 || (sink->buffer = malloc(SINK_BUFFER_SIZE)) == NULL)
+        {
+            perror("Problem encountered when opening the result file");
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
+
+    struct stat status;
+    if ((sink->fd = open(filename, O_RDWR | O_CREAT, 0644)) == -1 || fstat(sink->fd, &status) == -1)
+    {
+        perror("Problem encountered when opening the result file");
+        exit(EXIT_FAILURE);
+    }
+
+    if (status.st_size == 0)
+    {
+        result_sink_map(sink, SINK_BLOCK_RECORDS);
+        struct sink_header *header = (struct sink_header *)sink->map;
+        memcpy(header->magic, SINK_BINARY_MAGIC, sizeof(header->magic));
+        header->record_size = sizeof(struct sink_record);
+        header->records = 0;
+        return;
+    }
+
+    struct sink_header header;
+    if (pread(sink->fd, &header, sizeof(header), 0) != sizeof(header) || memcmp(header.magic, SINK_BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(struct sink_record))
+    {
+        fprintf(stderr, "ERROR: %s isn't a binary result file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    sink->base = sink->next = (long)header.records;
+    result_sink_map(sink, header.records + SINK_BLOCK_RECORDS);
+}
+
+/// @brief Writes the whole given buffer to the file
+/// @param fd the file
+/// @param buffer the buffer
+/// @param size the size of the buffer
+static void write_all(int fd, const char *buffer, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, buffer, size);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Problem encountered when writing the result file");
+            exit(EXIT_FAILURE);
+        }
+        buffer += written;
+        size -= written;
+    }
+}
+
+/// @brief Writes the results batched so far to the file
+/// @param sink the result sink
+void result_sink_flush(struct result_sink *sink)
+{
+    if (sink->format == SINK_JSONL)
+    {
+        write_all(sink->fd, sink->buffer, sink->used);
+        sink->used = 0;
+    }
+    else
+        ((struct sink_header *)sink->map)->records = (uint64_t)sink->next;
+}
+
+/// @brief Formats the result of a puzzle as a JSON line, the quotes and backslashes of the hash are escaped
+/// @param line the line
+/// @param size the size of the line
+/// @param index the index of the puzzle, left out if negative
+/// @param hash the hash of the puzzle
+/// @param record the result of the puzzle, its hash isn't used
+/// @param digits the digits of the grid found
+/// @return the length of the line
+static int sink_json_line(char *line, size_t size, long index, const char *hash, struct sink_record *record, const char *digits)
+{
+    char name[HASH_SIZE * 2 + 1];
+    size_t length = 0;
+    for (const char *c = hash; *c != '\0' && length < sizeof(name) - 2; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            name[length++] = '\\';
+        name[length++] = (*c >= ' ' && *c <= '~') ? *c : '?';
+    }
+    name[length] = '\0';
+
+    char position[32] = "";
+    if (index >= 0)
+        snprintf(position, sizeof(position), "\"index\":%ld,", index);
+
+    return snprintf(line, size,
+                    "{%s\"hash\":\"%s\",\"solved\":%s,\"cost\":%d,\"best_cost\":%d,\"tries\":%d,\"generations\":%d,"
+                    "\"moves\":%lld,\"time\":%f,\"solution\":\"%s\"}\n",
+                    position, name, (record->solved) ? "true" : "false", record->cost, record->best_cost, record->tries,
+                    record->generations, (long long)record->moves, record->time, digits);
+}
+
+/// @brief Writes the result of a puzzle: appended to the JSONL lines, or at the offset of its index in a binary file
+/// @param sink the result sink
+/// @param index the index of the puzzle (its position in the input, written after the records the file held when opened),
+///        -1 to append it after the results already written
+/// @param hash the hash of the puzzle
+/// @param result the outcome of the solving
+/// @param solution the grid found
+void result_sink_write(struct result_sink *sink, long index, const char *hash, struct solver_result *result, int **solution)
+{
+    struct sink_record record;
+    memset(&record, 0, sizeof(struct sink_record));
+    memcpy(record.hash, hash, strnlen(hash, HASH_SIZE));
+    record.written = 1;
+    record.solved = result->solved;
+    record.cost = result->cost;
+    record.best_cost = result->lowest_cost;
+    record.tries = result->tries;
+    record.generations = result->generations;
+    record.moves = result->moves;
+    record.time = result->time;
+
+    if (sink->format == SINK_BINARY)
+    {
+        // the results of this run follow the ones of the previous runs
+        index = (index < 0) ? sink->next : sink->base + index;
+        if ((size_t)index >= sink->capacity)
+            result_sink_map(sink, (index + 1 > 2 * (long)sink->capacity) ? index + 1 : 2 * sink->capacity);
+
+        for (int i = 0; i < PUZZLE_SIZE; i++)
+            record.solution[i / 2] |= solution[i / SUDOKU_SIZE][i % SUDOKU_SIZE] << ((i % 2 == 0) ? 4 : 0);
+        memcpy((struct sink_record *)(sink->map + sizeof(struct sink_header)) + index, &record, sizeof(struct sink_record));
+        if (index >= sink->next)
+            sink->next = index + 1;
+        return;
+    }
+
+    char line[LINE_SIZE * 4];
+    char digits[PUZZLE_SIZE + 1];
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        digits[i] = (char)('0' + solution[i / SUDOKU_SIZE][i % SUDOKU_SIZE]);
+    digits[PUZZLE_SIZE] = '\0';
+
+    int size = sink_json_line(line, sizeof(line), index, hash, &record, digits);
+    if (sink->used + size > SINK_BUFFER_SIZE)
+        result_sink_flush(sink);
+    memcpy(sink->buffer + sink->used, line, size);
+    sink->used += size;
+}
+
+/// @brief Flushes and closes a result file
+/// @param sink the result sink
+void result_sink_close(struct result_sink *sink)
+{
+    result_sink_flush(sink);
+    if (sink->format == SINK_BINARY)
+    { // the records mapped past the last one written are cut off
+        munmap(sink->map, sizeof(struct sink_header) + sink->capacity * sizeof(struct sink_record));
+        if (ftruncate(sink->fd, sizeof(struct sink_header) + sink->next * sizeof(struct sink_record)) == -1)
+            perror("Problem encountered when truncating the result file");
+        sink->map = NULL;
+    }
+    free(sink->buffer);
+    sink->buffer = NULL;
+    close(sink->fd);
+}
+
+/// @brief Prints the records of a binary result file as JSONL
+/// @param filename the result file
+/// @param output the output the lines are written to
+/// @return the number of records printed, -1 if the file isn't a binary result file
+long result_sink_dump(const char *filename, FILE *output)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp)
+        return -1;
+
+    struct sink_header header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, SINK_BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(struct sink_record))
+    {
+        fclose(fp);
+        return -1;
+    }
+
+    struct sink_record record;
+    long printed = 0;
+    for (uint64_t index = 0; index < header.records && fread(&record, sizeof(record), 1, fp) == 1; index++)
+    {
+        if (!record.written)
+            continue;
+
+        char hash[HASH_SIZE + 1];
+        char digits[PUZZLE_SIZE + 1];
+        memcpy(hash, record.hash, HASH_SIZE);
+        hash[HASH_SIZE] = '\0';
+        for (int i = 0; i < PUZZLE_SIZE; i++)
+            digits[i] = (char)('0' + ((record.solution[i / 2] >> ((i % 2 == 0) ? 4 : 0)) & 0xf));
+        digits[PUZZLE_SIZE] = '\0';
+
+        char line[LINE_SIZE * 4];
+        sink_json_line(line, sizeof(line), (long)index, hash, &record, digits);
+        fputs(line, output);
+        printed++;
+    }
+    fclose(fp);
+    return printed;
+}
@@ -0,0 +1,175 @@
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <omp.h>
+
+#include "snapshot.h"
+
+/// @brief Writes the state of the run to the segment: the sequence is odd while the state is written
+/// @param channel the channel
+/// @param lines the current grid
+/// @param cost the cost of the grid
+/// @param lowest_cost the lowest unweighted cost found
+/// @param tries the number of the current try
+/// @param temperature the current temperature
+/// @param moves the number of moves made
+/// @param now the current time (omp_get_wtime)
+/// @param finished if the run is over
+/// @param solved if a solution was found
+static void snapshot_write(struct snapshot_channel *channel, int **lines, int cost, int lowest_cost, int tries, double temperature,
+                           long long moves, double now, bool finished, bool solved)
+{
+    struct sudoku_snapshot *snapshot = channel->snapshot;
+    uint32_t sequence = atomic_load_explicit(&snapshot->sequence, memory_order_relaxed);
+    atomic_store_explicit(&snapshot->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        snapshot->grid[i] = (uint8_t)lines[i / SUDOKU_SIZE][i % SUDOKU_SIZE];
+    snapshot->cost = cost;
+    snapshot->lowest_cost = lowest_cost;
+    snapshot->tries = tries;
+    snapshot->temperature = temperature;
+    snapshot->moves = moves;
+    snapshot->time = now - channel->start;
+    snapshot->finished = finished;
+    snapshot->solved = solved;
+    snapshot->published++;
+
+    atomic_store_explicit(&snapshot->sequence, sequence + 2, memory_order_release);
+    channel->last = now;
+}
+
+/// @brief Creates the shared memory segment of the run, replacing the one of a previous run
+/// @param channel the channel
+/// @param original_grid the grid of the puzzle
+/// @return true if the segment was created, the run isn't shown otherwise
+bool snapshot_channel_open(struct snapshot_channel *channel, int **original_grid)
+{
+    int fd;
+    channel->snapshot = NULL;
+    channel->start = channel->last = omp_get_wtime();
+
+    // the viewers still attached to the segment of a previous run keep it until they find this one
+    shm_unlink(SNAPSHOT_NAME);
+    if ((fd = shm_open(SNAPSHOT_NAME, O_RDWR | O_CREAT | O_EXCL, 0644)) == -1)
+    {
+        perror("Problem encountered when creating the shared memory of the visualization");
+        return false;
+    }
+    if (ftruncate(fd, sizeof(struct sudoku_snapshot)) == -1 ||
+        (channel->snapshot = mmap(NULL, sizeof(struct sudoku_snapshot), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+    {
+        perror("Problem encountered when mapping the shared memory of the visualization");
+        channel->snapshot = NULL;
+        close(fd);
+        shm_unlink(SNAPSHOT_NAME);
+        return false;
+    }
+    close(fd);
+
+    // the new segment is all zeros, the puzzle is written like any state so the viewers never see half of it
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    struct sudoku_snapshot *snapshot = channel->snapshot;
+    atomic_store_explicit(&snapshot->sequence, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    snapshot->pid = (int32_t)getpid();
+    snapshot->started = now.tv_sec + now.tv_nsec / 1e9;
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        snapshot->givens[i] = snapshot->grid[i] = (uint8_t)original_grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE];
+    atomic_store_explicit(&snapshot->sequence, 2, memory_order_release);
+    return true;
+}
+
+/// @brief Publishes the state of the run, at most SNAPSHOT_RATE times per second unless forced. The solver only calls it
+///        every SNAPSHOT_CHECK_PERIOD moves, so it pays nothing between two states
+/// @param channel the channel
+/// @param lines the current grid
+/// @param cost the cost of the grid
+/// @param lowest_cost the lowest unweighted cost found
+/// @param tries the number of the current try
+/// @param temperature the current temperature
+/// @param moves the number of moves made
+/// @param force if the state is published whatever the time of the last one
+void snapshot_publish(struct snapshot_channel *channel, int **lines, int cost, int lowest_cost, int tries, double temperature,
+                      long long moves, bool force)
+{
+    if (channel->snapshot == NULL)
+        return;
+
+    double now = omp_get_wtime();
+    if (force || now - channel->last >= 1.0 / SNAPSHOT_RATE)
+        snapshot_write(channel, lines, cost, lowest_cost, tries, temperature, moves, now, false, false);
+}
+
+/// @brief Publishes the final state of the run and removes the segment, the viewers attached keep the last state
+/// @param channel the channel
+/// @param lines the final grid
+/// @param cost the unweighted cost of the grid
+/// @param lowest_cost the lowest unweighted cost found
+/// @param solved if a solution was found
+/// @param moves the number of moves made
+void snapshot_channel_close(struct snapshot_channel *channel, int **lines, int cost, int lowest_cost, bool solved, long long moves)
+{
+    struct sudoku_snapshot *snapshot = channel->snapshot;
+    if (snapshot == NULL)
+        return;
+
+    snapshot_write(channel, lines, cost, lowest_cost, snapshot->tries, snapshot->temperature, moves, omp_get_wtime(), true, solved);
+
+    munmap(snapshot, sizeof(struct sudoku_snapshot));
+    shm_unlink(SNAPSHOT_NAME);
+    channel->snapshot = NULL;
+}
+
+/// @brief Attaches to the shared memory segment of the current run
+/// @return the mapping of the segment (read only), NULL if no run is shown
+const struct sudoku_snapshot *snapshot_attach(void)
+{
+    int fd;
+    if ((fd = shm_open(SNAPSHOT_NAME, O_RDONLY, 0)) == -1)
+        return NULL;
+
+    // a segment still being created by the solver is too small to be mapped, it is found again at the next attempt
+    struct stat status;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && status.st_size >= (off_t)sizeof(struct sudoku_snapshot))
+        map = mmap(NULL, sizeof(struct sudoku_snapshot), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return (map == MAP_FAILED) ? NULL : (const struct sudoku_snapshot *)map;
+}
+
+/// @brief Detaches from the shared memory segment of a run
+/// @param snapshot the mapping of the segment
+void snapshot_detach(const struct sudoku_snapshot *snapshot)
+{
+    if (snapshot != NULL)
+        munmap((void *)snapshot, sizeof(struct sudoku_snapshot));
+}
+
+/// @brief Copies a consistent state of the run, retrying while the solver writes it
+/// @param snapshot the mapping of the segment
+/// @param copy the state copied
+void snapshot_read(const struct sudoku_snapshot *snapshot, struct sudoku_snapshot *copy)
+{
+    struct sudoku_snapshot *shared = (struct sudoku_snapshot *)snapshot;
+    while (true)
+    {
+        uint32_t before = atomic_load_explicit(&shared->sequence, memory_order_acquire);
+        if (before % 2 == 1)
+        { // the solver is writing the state, it is done in a few hundred nanoseconds
+            sched_yield();
+            continue;
+        }
+        memcpy(copy, snapshot, sizeof(struct sudoku_snapshot));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&shared->sequence, memory_order_relaxed) == before)
+            return;
+    }
+}
@@ -0,0 +1,770 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include <math.h>
+#include <omp.h>
+
+#include "solver.h"
+#include "utils.h"
+#include "memetic.h"
+#include "domains.h"
+#include "snapshot.h"
+#include "checkpoint.h"
+
+/// @brief Initializes the options with the default settings from the configuration
+/// @param options the options
+void solver_options_init(struct solver_options *options)
+{
+    options->verbose = false;
+    options->quiet = false;
+    options->weighting = false;
+    options->adaptive = ADAPTIVE_OPERATORS;
+    options->memetic = false;
+    options->tightening = DOMAIN_TIGHTENING;
+    restart_strategy_parse(RESTART_STRATEGY, &options->strategy);
+    cost_function_parse(COST_FUNCTION, &options->cost_function);
+    sudoku_initializer_parse(INITIALIZER, &options->initializer);
+    sweep_order_parse(SWEEP_ORDER, &options->sweep_order);
+    options->perturbation = RESTART_PERTURBATION;
+    options->cycle_probability = CYCLE_PROBABILITY;
+    options->chain_probability = CHAIN_PROBABILITY;
+    options->multiple_tries = MULTIPLE_TRIES;
+    options->trace = NULL;
+    options->cache = NULL;
+    options->checkpoint = NULL;
+    options->resume = false;
+    options->interrupted = NULL;
+    options->deadline = 0;
+    options->progress = NULL;
+    options->progress_data = NULL;
+}
+
+/// @brief Calibrates the start and stop temperatures of the annealing from the given (randomized) grid.
+///        Random cell changes are sampled without being applied and the uphill cost deltas are kept, the start temperature
+///        is then refined until the uphill moves are accepted with a START_ACCEPTANCE rate on average and the stop temperature
+///        is the one where the smallest uphill move is only accepted with a STOP_ACCEPTANCE rate
+/// @param model the cost model, with the starting grid used to find the non fixed cells
+/// @param lines 2D array containing each line of the sudoku grid
+/// @param columns 2D array containing each column of the sudoku grid
+/// @param regions 2D array containing each region of the sudoku grid
+/// @param seed the seed used in the pseudo random number generator
+/// @param start_temperature the calibrated start temperature
+/// @param stop_temperature the calibrated stop temperature
+void sudoku_calibrate_temperature(struct cost_model *model, int **lines, int ***columns, int ***regions, unsigned int *seed,
+                                  double *start_temperature, double *stop_temperature)
+{
+    int deltas[CALIBRATION_SAMPLES];
+    int i = -1, j = -1, new, delta;
+    int uphill = 0, min_delta = 0, free_cells = 0;
+    double mean = 0;
+
+    for (int cell = 0; cell < PUZZLE_SIZE; cell++)
+        free_cells += (model->original_grid[cell / SUDOKU_SIZE][cell % SUDOKU_SIZE] == 0);
+
+    for (int k = 0; k < CALIBRATION_SAMPLES && free_cells > 1; k++)
+    {
+        sudoku_get_random_cell(model->original_grid, &i, &j, seed);
+
+        while ((new = get_bound_random(seed, 1, 9)) == lines[i][j])
+            ;
+        delta = sudoku_cell_delta(new, i, j, lines, columns, regions, model); // the sampled move is never applied
+
+        if (delta > 0)
+        {
+            deltas[uphill++] = delta;
+            mean += delta;
+            if (min_delta == 0 || delta < min_delta)
+                min_delta = delta;
+        }
+    }
+
+    if (uphill == 0)
+    { // nothing to calibrate from, keep the static configuration
+        *start_temperature = START_TEMPERATURE;
+        *stop_temperature = TEMPERATURE_CEILING;
+        return;
+    }
+    mean /= uphill;
+
+    // first guess: the mean uphill move is accepted with the wanted rate, then refine the guess until
+    // the acceptance rate averaged over every sampled uphill move is the wanted one
+    double temperature = -mean / log(START_ACCEPTANCE);
+    for (int round = 0; round < CALIBRATION_ROUNDS; round++)
+    {
+        double acceptance = 0;
+        for (int k = 0; k < uphill; k++)
+            acceptance += exp(-deltas[k] / temperature);
+        acceptance /= uphill;
+
+        if (fabs(acceptance - START_ACCEPTANCE) < 0.001)
+            break;
+        temperature *= log(acceptance) / log(START_ACCEPTANCE);
+    }
+
+    *start_temperature = temperature;
+    *stop_temperature = -min_delta / log(STOP_ACCEPTANCE);
+}
+
+/// @brief Solves a puzzle with the simulated annealing (or the memetic engine). Only the given grids and seed are used,
+///        so several puzzles can be solved at once by different threads. With a solution cache, a puzzle equivalent to one
+///        already solved is answered from it without annealing, and the new solutions found are added to it.
+///        With a checkpoint file, the state of the annealing is saved every CHECKPOINT_INTERVAL seconds between two tries,
+///        and when the run is interrupted, so that a resumed run makes the very same moves as the uninterrupted one would have
+/// @param original_grid the grid of the puzzle, its empty cells are 0
+/// @param puzzle_hash the hash of the puzzle, used to name the stats files
+/// @param options the settings of the solving algorithm
+/// @param solution the grid found at the end of the run, allocated by the caller
+/// @param seed the seed used in the pseudo random number generator
+/// @param result the outcome of the solving
+/// @return the unweighted cost of the grid found, -1 if the grids of the run couldn't be allocated (the memory allocated by the
+///         call is freed and the solution is left as it is)
+int sudoku_solve(int **original_grid, char *puzzle_hash, struct solver_options *options, int **solution, unsigned int *seed,
+                 struct solver_result *result)
+{
+    bool verbose = options->verbose && !options->quiet;
+    bool logged = GET_STATS && !options->quiet;
+    struct trace_writer *trace = options->trace;
+
+    // the deadline and the progress of the anytime solving count from the start of the call
+    struct anytime_watch watch;
+    anytime_watch_init(&watch, options->deadline, options->progress, options->progress_data);
+
+    // the seed is recorded before anything is drawn, so the run can be made again
+    if (trace != NULL)
+        trace_begin(trace, original_grid, *seed, options->cost_function,
+                    ((options->weighting) ? TRACE_WEIGHTED : 0) | ((options->tightening) ? TRACE_TIGHTENED : 0));
+
+    // the puzzles equivalent under the symmetries of the sudoku share their canonical form, and their solution
+    struct canonical_form form;
+    if (options->cache != NULL)
+    {
+        double lookup_time = omp_get_wtime();
+        sudoku_canonicalize(original_grid, &form);
+        if (solution_cache_find(options->cache, &form, solution))
+        {
+            memset(result, 0, sizeof(struct solver_result));
+            result->solved = true;
+            result->cached = true;
+            result->cost = result->lowest_cost = SOLUTION_COST;
+            result->time = omp_get_wtime() - lookup_time;
+            anytime_watch_improved(&watch, SOLUTION_COST, solution, 0, 0, 0);
+            if (!options->quiet)
+            {
+                printf("\n>>> [Solution found in the cache]\n");
+                print_sudoku(solution);
+            }
+            return SOLUTION_COST;
+        }
+    }
+
+    // every grid of the run is allocated here, so that an allocation failure stops the call before anything else is done
+    // make a deep copy of the original grid with lines and have the regions and columns point to it
+    int **lines = create_sudoku_lines(original_grid);
+
+    // create a 2D array of pointers where each array is a region of the grid(from left to right)
+    int ***regions = (lines != NULL) ? create_sudoku_region(lines) : NULL;
+    int ***columns = (lines != NULL) ? create_sudoku_columns(lines) : NULL;
+
+    // the best grid found, kept when going back to it, and the best grid seen between two temperature steps, returned if
+    // the deadline expires
+    int **best_grid = create_sudoku_lines(original_grid);
+    int **anytime_best = (watch.active) ? create_sudoku_lines(original_grid) : NULL;
+    bool allocated = (regions != NULL && columns != NULL && best_grid != NULL && (anytime_best != NULL || !watch.active));
+
+    // the cells the solver never changes: the givens, and the cells promoted by the domains when tightening them
+    struct cell_domains domains;
+    domains.fixed = NULL;
+    int **fixed_grid = original_grid;
+    if (allocated && options->tightening && (allocated = cell_domains_init(&domains, original_grid)))
+    {
+        fixed_grid = domains.fixed;
+        cell_domains_apply(&domains, lines);
+    }
+
+    // the way the non fixed cells are filled at the start of each try
+    struct grid_initializer initializer;
+    allocated = allocated && grid_initializer_init(&initializer, options->initializer, fixed_grid);
+
+    if (!allocated)
+    {
+        sudoku_free_pointers(regions);
+        sudoku_free_pointers(columns);
+        sudoku_free(lines);
+        sudoku_free(best_grid);
+        sudoku_free(anytime_best);
+        cell_domains_free(&domains);
+        return -1;
+    }
+
+    // the cost model used by the annealing (weighted when weighting the constraints) and the unweighted one,
+    // used to compare the grids found
+    int weights[UNITS];
+    struct cost_model model, unweighted;
+    cost_model_init(&unweighted, options->cost_function, fixed_grid, NULL);
+    model = unweighted;
+    if (options->weighting)
+    {
+        sudoku_weights_init(weights);
+        model.weights = weights;
+    }
+
+    int cost = sudoku_cost(lines, columns, regions, &unweighted);
+
+    if (verbose)
+        printf(">> Current cost : %d\n", cost);
+
+#if _SHOW_
+    // publish the run to the viewers (visualization program), never waiting for them
+    struct snapshot_channel channel = {0};
+    if (!options->quiet)
+        snapshot_channel_open(&channel, original_grid);
+#endif
+
+    if (!RANDOMIZE_SUDOKU)
+    { // randomize the sudoku only once at the start
+        // Step 1: Fill the grid's non fixed cells with the initializer and calculate the cost of the grid
+        sudoku_initialize(&initializer, &lines, seed);
+        // calculate cost of the initial grid
+        cost = sudoku_cost(lines, columns, regions, &model);
+    }
+
+    // calibrate the start and stop temperatures on a grid filled as the tries start (it is filled again at the first try if
+    // needed), a structured initial grid calls for a cooler start than a random one
+    double start_temperature = START_TEMPERATURE, stop_temperature = TEMPERATURE_CEILING;
+    if (AUTO_TEMPERATURE)
+    {
+        if (RANDOMIZE_SUDOKU)
+            sudoku_initialize(&initializer, &lines, seed);
+        sudoku_calibrate_temperature(&model, lines, columns, regions, seed, &start_temperature, &stop_temperature);
+    }
+
+    struct restart_policy policy;
+    restart_policy_init(&policy, options->strategy, options->perturbation);
+
+    struct cell_sweep sweep;
+    cell_sweep_init(&sweep, options->sweep_order, fixed_grid, seed);
+
+    struct operator_selector selector;
+    operator_selector_init(&selector, options->cycle_probability, options->chain_probability, options->adaptive);
+
+    // a resumed run takes back the state saved between two tries over the one just set up, the seed last since setting up
+    // draws from it
+    struct solver_checkpoint checkpoint;
+    bool resumed = options->resume && options->checkpoint != NULL &&
+                   solver_checkpoint_read(options->checkpoint, &checkpoint, original_grid, options);
+    if (resumed)
+    {
+        start_temperature = checkpoint.start_temperature;
+        stop_temperature = checkpoint.stop_temperature;
+        policy = checkpoint.policy;
+        sweep = checkpoint.sweep;
+        selector = checkpoint.selector;
+        if (options->tightening)
+        {
+            checkpoint_grid_load(domains.fixed, checkpoint.fixed);
+            memcpy(domains.domain, checkpoint.domain, sizeof(domains.domain));
+            domains.promoted = checkpoint.promoted;
+            domains.rejected = checkpoint.rejected;
+            domains.rounds = checkpoint.rounds;
+            domains.stable = checkpoint.stable;
+            domains.probed = checkpoint.probed;
+            domains.refuted = checkpoint.refuted;
+            domains.cursor = checkpoint.cursor;
+            memcpy(domains.tested, checkpoint.tested, sizeof(domains.tested));
+            grid_initializer_refresh(&initializer);
+        }
+        if (options->weighting)
+            memcpy(weights, checkpoint.weights, sizeof(weights));
+        checkpoint_grid_load(lines, checkpoint.lines);
+        cost = sudoku_cost(lines, columns, regions, &model);
+        *seed = checkpoint.seed;
+        if (!options->quiet)
+            printf("%s#Run resumed from %s at try %d (%lld moves, lowest cost %d)%s\n", CLR_GRN, options->checkpoint, checkpoint.tries,
+                   (long long)checkpoint.moves, checkpoint.lowest_cost, CLR_RESET);
+    }
+
+    // print the current solving configuration
+    if (PRINT_CONFIG && !options->quiet)
+    {
+        print_config(start_temperature, stop_temperature);
+        print_cost_config(&model);
+        grid_initializer_print(&initializer);
+        cell_sweep_print(&sweep);
+        if (options->tightening)
+            cell_domains_print(&domains);
+        else
+            printf("  %s>[DOMAINS]Cells promoted to fixed cells:%s %sOFF%s\n", CLR_YEL, CLR_RESET, CLR_RED, CLR_RESET);
+        if (options->multiple_tries > 1)
+            printf("  %s>[MULTIPLE_TRIES]New values proposed at once for a cell:%s %s%d%s\n", CLR_YEL, CLR_RESET, CLR_GRN, options->multiple_tries, CLR_RESET);
+        else
+            printf("  %s>[MULTIPLE_TRIES]New values proposed at once for a cell:%s %sOFF%s\n", CLR_YEL, CLR_RESET, CLR_RED, CLR_RESET);
+        operator_selector_print(&selector);
+        restart_policy_print(&policy);
+    }
+
+    // Setup main loop and current timestamp
+    int tries;
+    char date_buffer[FILE_SIZE];
+#if _DEBUG_
+    char debug_buffer[DEBUG_SIZE];
+#endif
+    time_t timestamp = time(NULL);
+    struct tm local_time;
+    strftime(date_buffer, FILE_SIZE, "%d-%m-%Y-(%H-%M-%S)", localtime_r(&timestamp, &local_time));
+    if (resumed) // the stats go on in the files of the run
+        memcpy(date_buffer, checkpoint.date, FILE_SIZE);
+    else if (logged)
+        sudoku_write_calibration(puzzle_hash, start_temperature, stop_temperature, date_buffer);
+    //
+
+    // define recuit algorithm variables
+    bool solved = false;
+    int k, cost_one, cost_two, cost_comp, temp = 0, new;
+    int try_cost, weight_raises = 0;
+    bool improved, timed, accepted, multiple_accepted = false;
+    struct sudoku_move move;
+    enum sudoku_operator op;
+    double op_time = 0;
+    long long moves = 0;
+    int lowest_cost_found = (int)INFINITY;
+    double start_time;
+    double u;
+    int **best_solution = NULL;
+    //
+    struct memetic_stats memetic_stats = {0};
+    start_time = omp_get_wtime();
+    tries = 0;
+    bool interrupted = false;
+    double elapsed = 0, checkpoint_time = start_time;
+
+    if (resumed)
+    {
+        tries = checkpoint.tries;
+        moves = checkpoint.moves;
+        weight_raises = checkpoint.weight_raises;
+        lowest_cost_found = checkpoint.lowest_cost;
+        elapsed = checkpoint.elapsed;
+        if (checkpoint.has_best)
+        {
+            best_solution = best_grid;
+            checkpoint_grid_load(best_solution, checkpoint.best);
+        }
+    }
+
+    if (watch.active)
+    {
+        sudoku_copy_content(&anytime_best, lines);
+        if (best_solution != NULL && anytime_watch_improved(&watch, lowest_cost_found, best_solution, tries, 0, moves))
+            sudoku_copy_content(&anytime_best, best_solution);
+    }
+
+    if (options->memetic)
+    { // the population replaces the restarts of the annealing
+        lowest_cost_found = sudoku_memetic(&unweighted, lines, seed, start_temperature, stop_temperature, verbose, &watch, &memetic_stats);
+        if (lowest_cost_found == -1)
+        { // the population couldn't be allocated, the run stops without a grid
+            allocated = false;
+            lowest_cost_found = (int)INFINITY;
+        }
+        else
+            cost = lowest_cost_found;
+        solved = allocated && (cost <= SOLUTION_COST);
+        if (solved && !options->quiet)
+        {
+            printf("\n>>> [NULL 0 cost solution found]\n");
+            print_sudoku(lines);
+        }
+    }
+
+    while (solved != true && !options->memetic)
+    {
+        if (KEEP_START)
+        {
+            sudoku_copy_content(&lines, fixed_grid);
+        }
+
+        if (verbose)
+        {
+            printf("\n===========================\n");
+            print_sudoku(lines);
+            printf(">> Current cost : %d\n", cost);
+        }
+
+        if (RANDOMIZE_SUDOKU)
+        { // randomize only on the first try
+            // Step 1: Fill the grid's non fixed cells with the initializer and calculate the cost of the grid
+            if (policy.perturbation > 0 && best_solution != NULL)
+            { // restart from the best grid found with only a fraction of its cells randomized again
+                sudoku_copy_content(&lines, best_solution);
+                sudoku_perturb(&lines, fixed_grid, policy.perturbation, seed);
+            }
+            else
+                sudoku_initialize(&initializer, &lines, seed);
+            if (options->tightening) // the best grid may predate the last promotions
+                cell_domains_apply(&domains, lines);
+            cost = sudoku_cost(lines, columns, regions, &model);
+        }
+
+        if (verbose)
+        {
+            printf("\n===========================\n");
+            print_sudoku(lines);
+            printf(">> Current cost : %d\n", cost);
+        }
+
+        if (trace != NULL)
+            trace_try(trace, tries, lines, cost);
+
+        // log the stats of the recuit solver, the starting cost of the try is always the unweighted one
+        if (logged)
+            sudoku_write_stats(puzzle_hash, (options->weighting) ? sudoku_cost(lines, columns, regions, &unweighted) : cost, tries, date_buffer);
+
+        // the initial grid may already be a solution (every cell forced by the domains or the presolve), there may even
+        // be no non fixed cell left to change
+        if (cost <= SOLUTION_COST)
+        {
+            if (!options->quiet)
+            {
+                printf("\n>>> [NULL 0 cost solution found]\n");
+                print_sudoku(lines);
+            }
+            solved = true;
+        }
+
+        // Step 2: Setup the contants
+        int i = -1, j = -1;
+        float sigma = 0.1;
+        double ep = start_temperature;
+        double temperature = ep;
+        // the restart policy decides of the number of temperature steps of the try,
+        // the calibrated schedule spreads them between the start and stop temperatures
+        int steps = restart_policy_start_try(&policy, cost);
+        double beta = (AUTO_TEMPERATURE) ? (1 / stop_temperature - 1 / ep) / steps : log(1 + sigma) / ep + 1;
+
+        // diminution/augmentation de la temperature de départ à chaque quart d'essaie
+        if (tries != 0 && tries % (MAX_TRIES / TEMP_STEP) == 0)
+            temperature *= 2;
+        if (trace != NULL)
+            trace_temperature(trace, temperature);
+
+        // Step 3: Start the recuit simulation algorithm
+        while (temperature >= stop_temperature && solved != true)
+        {
+            improved = false;
+            for (k = 0; k < PRESUMED_PUZZLE_SIZE; k++)
+            {
+                // choose the kind of move first, the compound moves are mixed with the single cell changes by probability
+                op = operator_select(&selector, seed);
+                if ((timed = operator_timed(&selector, op)))
+                    op_time = omp_get_wtime();
+
+                if (op != OPERATOR_CHANGE)
+                { // Steps 4 to 7 at once: change several cells and evaluate the cost of each change one after the other
+                    cost_one = 0;
+                    if (op == OPERATOR_CYCLE)
+                        cost_two = sudoku_move_cycle(&move, fixed_grid, lines, columns, regions, &model, seed);
+                    else
+                        cost_two = sudoku_move_chain(&move, fixed_grid, lines, columns, regions, &model, seed);
+                }
+                else
+                {
+                    // Step 4: choose a cell from the grid which isn't fixed, at random or the next one of the sweep
+                    sudoku_sweep_cell(&sweep, fixed_grid, &i, &j, seed);
+
+                    // Step 5: store the value in a temp variable
+                    temp = lines[i][j];
+
+                    cost_one = 0;
+                    if (options->multiple_tries > 1)
+                    { // Steps 6 and 7 at once: several new values are proposed and scored together, one of them is chosen
+                        // and the multiple-try acceptance replaces the one of step 10
+                        int candidates = (options->tightening) ? domains.domain[i][j] : DOMAIN_ALL;
+                        multiple_accepted = sudoku_multiple_try(i, j, candidates, options->multiple_tries, temperature, lines, columns, regions, &model, seed, &new, &cost_two);
+                    }
+                    else
+                    {
+                        // Step 6: choose a new different value for the random cell, among its candidates when tightening the domains
+                        if (options->tightening)
+                            new = cell_domains_value(&domains, i, j, temp, seed);
+                        else
+                        {
+                            while ((new = get_bound_random(seed, 1, 9)) == temp)
+                                ;
+                        }
+
+                        // Step 7: evaluate the change of the cost in a single pass before changing the cell
+                        cost_two = sudoku_cell_delta(new, i, j, lines, columns, regions, &model);
+                    }
+                    lines[i][j] = new;
+                }
+
+                if (timed)
+                    operator_time(&selector, op, omp_get_wtime() - op_time);
+
+                moves++;
+
+                // Step 8: compare the cost between the two random cell values
+                cost_comp = cost - cost_one + cost_two;
+
+                // Step 9: choose random value in [0, 1]
+                u = get_random(seed);
+#if _DEBUG_
+                snprintf(debug_buffer, DEBUG_SIZE, "{cost: %d, cost_one: %d, cost_two: %d, cost_comp: %d, temperature: %f}", cost, cost_one, cost_two, cost_comp, temperature);
+                sudoku_debug_output(puzzle_hash, debug_buffer, date_buffer);
+#endif
+                // Step 10: probability acceptance
+                if (op == OPERATOR_CHANGE && options->multiple_tries > 1)
+                { // already decided by the multiple-try acceptance
+                    accepted = multiple_accepted;
+                }
+                else
+                {
+                    accepted = (cost_comp < cost || u <= exp(-((cost_comp - cost) / temperature)));
+                }
+
+                // the cells still hold their new values, the rejected moves are undone below
+                if (trace != NULL)
+                {
+                    if (op != OPERATOR_CHANGE)
+                        trace_move(trace, lines, move.size, move.line, move.column, accepted, cost_comp - cost, (accepted) ? cost_comp : cost);
+                    else
+                        trace_move(trace, lines, 1, &i, &j, accepted, cost_comp - cost, (accepted) ? cost_comp : cost);
+                }
+
+                if (accepted)
+                { // acceptation
+                    if (cost_comp < cost)
+                        improved = true;
+                    cost = cost_comp;
+                }
+                else
+                { // rejet
+                    if (op != OPERATOR_CHANGE)
+                        sudoku_move_undo(&move, lines);
+                    else
+                        lines[i][j] = temp;
+                }
+                operator_credit(&selector, op, (cost == cost_comp) ? cost_one - cost_two : 0); // rejected moves made no improvement
+
+#if _SHOW_
+                // the clock is only looked at every SNAPSHOT_CHECK_PERIOD moves, the state at most SNAPSHOT_RATE times per second
+                if ((moves & (SNAPSHOT_CHECK_PERIOD - 1)) == 0)
+                    snapshot_publish(&channel, lines, cost, (lowest_cost_found == (int)INFINITY) ? -1 : lowest_cost_found, tries, temperature, moves, false);
+#endif
+                // Stop the algorithm if the cost of the grid is SOLUTION_COST
+                if (cost <= SOLUTION_COST)
+                {
+                    if (!options->quiet)
+                    {
+                        printf("\n>>> [NULL 0 cost solution found]\n");
+                        print_sudoku(lines);
+                    }
+                    solved = true;
+                    // log the stats of the recuit solver
+                    if (logged)
+                        sudoku_write_stats(puzzle_hash, cost, tries, date_buffer);
+                    break;
+                }
+#if _DEBUG_
+                snprintf(debug_buffer, DEBUG_SIZE, "{cost: %d, cost_one: %d, cost_two: %d, cost_comp: %d, temperature: %f}", cost, cost_one, cost_two, cost_comp, temperature);
+                sudoku_debug_output(puzzle_hash, debug_buffer, date_buffer);
+#endif
+            }
+
+            // the anytime solving looks at the grid between two temperature steps: the best one is kept and reported,
+            // and the run stops once its deadline expired
+            if (watch.active)
+            {
+                try_cost = (options->weighting) ? sudoku_cost(lines, columns, regions, &unweighted) : cost;
+                if (anytime_watch_improved(&watch, try_cost, lines, tries + 1, 0, moves))
+                    sudoku_copy_content(&anytime_best, lines);
+                if (anytime_watch_expired(&watch))
+                    break;
+            }
+
+            // Step k: reduce the temperature
+            temperature = temperature / (1 + beta * temperature);
+            operator_selector_update(&selector);
+            if (trace != NULL)
+                trace_temperature(trace, temperature);
+
+            // no improvement during the whole temperature step: the search is in a local minimum of the weighted cost,
+            // raise the weights of the units still violated (and decay every weight once in a while) to get out of it
+            if (options->weighting && !improved && !solved)
+            {
+                sudoku_weights_bump(&model, lines, columns, regions);
+                if (++weight_raises % WEIGHT_DECAY_PERIOD == 0)
+                    sudoku_weights_decay(weights);
+                cost = sudoku_cost(lines, columns, regions, &model);
+                if (trace != NULL)
+                    trace_cost(trace, cost);
+            }
+
+            // Step l: restart early if the restart policy says so
+            if (restart_policy_step(&policy, cost))
+                break;
+        }
+
+        if (watch.expired)
+        { // the try is cut short, the best grid seen is returned below
+            tries++;
+            break;
+        }
+
+        // find lowest cost and manage the best current solution, always compared without the weights
+        try_cost = (options->weighting) ? sudoku_cost(lines, columns, regions, &unweighted) : cost;
+        if (try_cost < lowest_cost_found)
+        { // if we find the current best solution, keep the cost and the grid
+            lowest_cost_found = try_cost;
+            if (KEEP_BEST || policy.perturbation > 0)
+            {
+                best_solution = best_grid;
+                sudoku_copy_content(&best_solution, lines);
+            }
+        }
+        else if (KEEP_BEST)
+        { // if the cost found is inferior, go back to best solution
+            sudoku_copy_content(&lines, best_solution);
+        }
+
+        // log the probabilities of the moves learned during the try
+        if (selector.adaptive && logged)
+            sudoku_write_operators(puzzle_hash, tries, selector.probability, OPERATORS, date_buffer);
+
+        // tighten the domains between the tries, then refute by propagation the candidates the grid of the try doesn't hold,
+        // the cells promoted are removed from the non fixed cells of the next tries
+        int promoted = 0;
+        if (options->tightening)
+        {
+            promoted = (!domains.stable) ? cell_domains_tighten(&domains) : 0;
+            promoted += cell_domains_probe(&domains, lines);
+        }
+        if (promoted > 0)
+        {
+            cell_sweep_update(&sweep, fixed_grid, seed);
+            grid_initializer_refresh(&initializer);
+            cell_domains_apply(&domains, lines);
+            if (verbose)
+                cell_domains_print(&domains);
+        }
+
+        // the grid may be back to the best one found, or have cells promoted
+        if (trace != NULL)
+            trace_grid(trace, lines, sudoku_cost(lines, columns, regions, &model));
+
+        // increment the number of tries
+        tries++;
+        if (tries > MAX_TRIES && !KEEP_TRYING)
+            break;
+
+        // save the run between two tries, once in a while and before stopping it when interrupted
+        interrupted = !solved && options->interrupted != NULL && *options->interrupted;
+        if (options->checkpoint != NULL && !solved && (interrupted || omp_get_wtime() - checkpoint_time >= CHECKPOINT_INTERVAL))
+        {
+            solver_checkpoint_init(&checkpoint, original_grid, options);
+            checkpoint.seed = *seed;
+            checkpoint.tries = tries;
+            checkpoint.weight_raises = weight_raises;
+            checkpoint.lowest_cost = lowest_cost_found;
+            checkpoint.moves = moves;
+            checkpoint.elapsed = elapsed + omp_get_wtime() - start_time;
+            checkpoint.start_temperature = start_temperature;
+            checkpoint.stop_temperature = stop_temperature;
+            memcpy(checkpoint.date, date_buffer, FILE_SIZE);
+            checkpoint_grid_save(checkpoint.lines, lines);
+            if ((checkpoint.has_best = (best_solution != NULL)))
+                checkpoint_grid_save(checkpoint.best, best_solution);
+            if (options->weighting)
+                memcpy(checkpoint.weights, weights, sizeof(weights));
+            checkpoint.policy = policy;
+            checkpoint.sweep = sweep;
+            checkpoint.selector = selector;
+            if (options->tightening)
+            {
+                checkpoint_grid_save(checkpoint.fixed, domains.fixed);
+                memcpy(checkpoint.domain, domains.domain, sizeof(domains.domain));
+                checkpoint.promoted = domains.promoted;
+                checkpoint.rejected = domains.rejected;
+                checkpoint.rounds = domains.rounds;
+                checkpoint.stable = domains.stable;
+                checkpoint.probed = domains.probed;
+                checkpoint.refuted = domains.refuted;
+                checkpoint.cursor = domains.cursor;
+                memcpy(checkpoint.tested, domains.tested, sizeof(domains.tested));
+            }
+            if (solver_checkpoint_write(options->checkpoint, &checkpoint) && verbose)
+                printf(">> Checkpoint saved at try %d\n", tries);
+            checkpoint_time = omp_get_wtime();
+        }
+        if (interrupted)
+            break;
+    }
+
+    // the checkpoint of a finished run is of no use anymore
+    if (options->checkpoint != NULL && !interrupted)
+        solver_checkpoint_remove(options->checkpoint);
+
+    if (verbose)
+    {
+        printf("\n===========================\n");
+        printf("\nResults of the simulation: \n");
+        printf("\n===========================\n");
+
+        printf("\n---------------------------------------------------------------------------------\n");
+        printf(">>> Last output cost by the annealing algorithm: %d\n", cost);
+    }
+
+    // calculate cost of grid
+    cost = sudoku_cost(lines, columns, regions, &unweighted);
+
+    // an expired run returns the best grid seen, which may predate the current one, and the final grid is reported when
+    // it was never looked at (solved from the start)
+    if (watch.expired && watch.lowest_cost != -1 && watch.lowest_cost < cost)
+    {
+        sudoku_copy_content(&lines, anytime_best);
+        cost = watch.lowest_cost;
+    }
+    anytime_watch_improved(&watch, cost, lines, tries, memetic_stats.generations, moves);
+    if (watch.active && watch.lowest_cost < lowest_cost_found)
+        lowest_cost_found = watch.lowest_cost;
+#if _SHOW_
+    snapshot_channel_close(&channel, lines, cost, (lowest_cost_found == (int)INFINITY) ? cost : lowest_cost_found, solved, moves);
+#endif
+
+    result->solved = solved;
+    result->cached = false;
+    result->interrupted = interrupted;
+    result->expired = watch.expired;
+    result->cost = cost;
+    result->lowest_cost = lowest_cost_found;
+    result->tries = tries;
+    result->generations = memetic_stats.generations;
+    result->moves = moves;
+    result->sweeps = (sweep.n > 0) ? sweep.sweeps + (double)sweep.position / sweep.n : sweep.sweeps;
+    result->time = elapsed + omp_get_wtime() - start_time;
+    result->adaptive = selector.adaptive;
+    memcpy(result->probability, selector.probability, sizeof(result->probability));
+
+    // the solution is kept without the cache when it can't be stored in it
+    if (allocated)
+        sudoku_copy_content(&solution, lines);
+    if (options->cache != NULL && solved && !solution_cache_store(options->cache, &form, solution) && !options->quiet)
+        fprintf(stderr, "WARNING: the solution couldn't be stored in the solution cache\n");
+
+    // Free allocated memory of the various grids used
+    sudoku_free_pointers(regions);
+    sudoku_free_pointers(columns);
+    sudoku_free(lines);
+    grid_initializer_free(&initializer);
+    if (options->tightening)
+        cell_domains_free(&domains);
+    sudoku_free(best_grid);
+    sudoku_free(anytime_best);
+
+    return (allocated) ? cost : -1;
+}
@@ -0,0 +1,308 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "stream.h"
+#include "bank.h"
+
+/// @brief Opens a stream of puzzles: lines of 81 digits ('0' or '.' for the empty cells), lines of the text bank format
+///        (hash, puzzle and rating) or a binary bank, found from the start of the input, which may be gzip or zstd compressed
+/// @param stream the stream
+/// @param input the input the puzzles are read from
+/// @param output the output the solutions are written to
+/// @param options the settings of the solving algorithm
+/// @param ordered if the solutions are written in the order of the puzzles
+/// @param window the maximum number of puzzles read and not written yet, when ordered
+/// @param seed the seed the seeds of the puzzles are made from
+/// @param sink the result file each solution is written to as well, at the index of its puzzle, NULL if none
+void sudoku_stream_open(struct sudoku_stream *stream, FILE *input, FILE *output, struct solver_options *options, bool ordered,
+                        int window, unsigned int seed, struct result_sink *sink)
+{
+    memset(stream, 0, sizeof(struct sudoku_stream));
+    stream->input = input;
+    stream->output = output;
+    stream->options = options;
+    stream->sink = sink;
+    stream->seed = seed;
+    stream->ordered = ordered;
+    stream->window = (window > 0) ? window : 1;
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->space, NULL);
+
+    if (ordered && (stream->slots = calloc(stream->window, sizeof(struct stream_puzzle))) == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // a compressed input is decoded on a background thread while the puzzles already decoded are solved. The input can't be
+    // rewound (pipe): the whole magic of the compressions is read, up to the end of the first line, and the bytes read are
+    // replayed to the decoder or, if it isn't compressed, to the parsing of the first line
+    unsigned char magic[COMPRESSION_MAGIC_SIZE];
+    size_t got = 0, replayed = 0;
+    int c = EOF;
+    while (got < sizeof(magic) && (c = fgetc(input)) != EOF && (magic[got++] = (unsigned char)c) != '\n')
+        ;
+    if ((stream->compression = compression_detect(magic, got)) != COMPRESSION_NONE)
+    {
+        stream_decoder_open(&stream->decoder, input, stream->compression, magic, got);
+        stream->input = input = stream->decoder.output;
+        got = 0;
+    }
+
+    // its first bytes are compared to the magic of the binary banks one at a time and, as soon as one differs, the bytes
+    // read start the first line of a text stream
+    size_t length = 0;
+    c = EOF;
+    while (length < strlen(BANK_BINARY_MAGIC) && (c = (replayed < got) ? magic[replayed++] : fgetc(input)) != EOF)
+    {
+        stream->first[length++] = (char)c;
+        if (c != BANK_BINARY_MAGIC[length - 1])
+            break;
+    }
+    // the bytes of the magic left are still in the first line, only the last one may end it
+    while (replayed < got)
+        stream->first[length++] = (char)(c = magic[replayed++]);
+
+    if (length == strlen(BANK_BINARY_MAGIC) && memcmp(stream->first, BANK_BINARY_MAGIC, length) == 0)
+    { // the rest of the header of the binary bank, the records follow it
+        struct bank_binary_header header;
+        memcpy(header.magic, stream->first, length);
+        if (fread((char *)&header + length, sizeof(header) - length, 1, input) != 1 || header.record_size != sizeof(struct bank_record))
+        {
+            fprintf(stderr, "ERROR: invalid header of the binary puzzle bank on the input\n");
+            exit(EXIT_FAILURE);
+        }
+        stream->binary = true;
+        stream->records = (long)header.records;
+        return;
+    }
+
+    stream->first[length] = '\0';
+    if (length > 0 && c != '\n' && c != EOF && fgets(stream->first + length, sizeof(stream->first) - length, input) == NULL)
+        stream->first[length] = '\0';
+    stream->pending = (length > 0);
+}
+
+/// @brief Closes a stream of puzzles, the input and output aren't closed
+/// @param stream the stream
+/// @return true if the input was decoded without error (always true if it isn't compressed)
+bool sudoku_stream_close(struct sudoku_stream *stream)
+{
+    bool decoded = (stream->compression == COMPRESSION_NONE || stream_decoder_close(&stream->decoder));
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->space);
+    free(stream->slots);
+    stream->slots = NULL;
+    return decoded;
+}
+
+/// @brief Checks that no digit is given twice in a line, column or region of a puzzle, such a puzzle has no solution
+/// @param grid the grid of the puzzle, its empty cells are 0
+/// @return false if two givens are in conflict or a given is out of range, true otherwise
+static bool sudoku_stream_givens_valid(int grid[SUDOKU_SIZE][SUDOKU_SIZE])
+{
+    int lines[SUDOKU_SIZE] = {0}, columns[SUDOKU_SIZE] = {0}, regions[SUDOKU_SIZE] = {0};
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            if (grid[i][j] == 0)
+                continue;
+            if (grid[i][j] < 0 || grid[i][j] > SUDOKU_SIZE)
+                return false; // a corrupted record of a binary bank
+            int bit = 1 << grid[i][j], region = (i / SUDOKU_GRID_SIZE) * SUDOKU_GRID_SIZE + j / SUDOKU_GRID_SIZE;
+            if ((lines[i] | columns[j] | regions[region]) & bit)
+                return false;
+            lines[i] |= bit;
+            columns[j] |= bit;
+            regions[region] |= bit;
+        }
+    }
+    return true;
+}
+
+/// @brief Parses a line of a text stream: 81 digits, or the hash, the puzzle and the rating of the text bank format
+/// @param stream the stream
+/// @param line_buffer the line, without its linefeed
+/// @param puzzle the puzzle read
+/// @return true if the line holds a valid puzzle (without conflicting givens), false otherwise
+static bool sudoku_stream_parse(struct sudoku_stream *stream, char *line_buffer, struct stream_puzzle *puzzle)
+{
+    char first[LINE_SIZE], second[LINE_SIZE];
+    char *digits;
+    int fields = sscanf(line_buffer, "%99s %99s", first, second);
+
+    if (fields >= 1 && strlen(first) == PUZZLE_SIZE)
+    { // a bare puzzle is named after its line
+        digits = first;
+        snprintf(puzzle->hash, sizeof(puzzle->hash), "%ld", stream->line);
+    }
+    else if (fields == 2 && strlen(first) <= HASH_SIZE && strlen(second) == PUZZLE_SIZE)
+    {
+        digits = second;
+        strcpy(puzzle->hash, first);
+    }
+    else
+        return false;
+
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+    {
+        char c = digits[i];
+        if (c != '.' && (c < '0' || c > '9'))
+            return false;
+        puzzle->grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE] = (c >= '1' && c <= '9') ? c - '0' : 0; // '0' and '.' are empty cells
+    }
+    return sudoku_stream_givens_valid(puzzle->grid);
+}
+
+/// @brief Reads the next valid puzzle of the stream, the invalid records are skipped with a warning
+/// @param stream the stream
+/// @param puzzle the puzzle read
+/// @return true if a puzzle was read, false at the end of the input
+bool sudoku_stream_read(struct sudoku_stream *stream, struct stream_puzzle *puzzle)
+{
+    char line_buffer[LINE_SIZE * 2];
+
+    if (stream->binary)
+    {
+        struct bank_record record;
+        while (stream->records > 0 && fread(&record, sizeof(record), 1, stream->input) == 1)
+        {
+            stream->records--;
+            bank_record_decode(&record, puzzle->hash, puzzle->grid, NULL);
+            if (sudoku_stream_givens_valid(puzzle->grid))
+                return true;
+            fprintf(stderr, "WARNING: invalid puzzle %s of the input, skipped\n", puzzle->hash);
+            stream->invalid++;
+        }
+        return false;
+    }
+
+    while (true)
+    {
+        if (stream->pending)
+        {
+            strcpy(line_buffer, stream->first);
+            stream->pending = false;
+        }
+        else if (fgets(line_buffer, sizeof(line_buffer), stream->input) == NULL)
+            return false;
+        stream->line++;
+
+        size_t length = strlen(line_buffer);
+        bool complete = (length > 0 && line_buffer[length - 1] == '\n');
+        if (!complete && length == sizeof(line_buffer) - 1)
+        { // too long to be a puzzle, skip the rest of the line
+            int c;
+            while ((c = fgetc(stream->input)) != EOF && c != '\n')
+                ;
+        }
+        line_buffer[strcspn(line_buffer, "\r\n")] = '\0';
+
+        // blank lines and comments are ignored
+        char *start = line_buffer + strspn(line_buffer, " \t");
+        if (*start == '\0' || *start == '#')
+            continue;
+
+        if (length < sizeof(line_buffer) - 1 && sudoku_stream_parse(stream, start, puzzle))
+            return true;
+        fprintf(stderr, "WARNING: invalid puzzle on line %ld of the input, skipped\n", stream->line);
+        stream->invalid++;
+    }
+}
+
+/// @brief Writes the solution of a puzzle on a line: the hash of the puzzle, the grid found, its cost and the solving time
+/// @param stream the stream
+/// @param puzzle the solved puzzle
+void sudoku_stream_write(struct sudoku_stream *stream, struct stream_puzzle *puzzle)
+{
+    char digits[PUZZLE_SIZE + 1];
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        digits[i] = (char)('0' + puzzle->solution[i / SUDOKU_SIZE][i % SUDOKU_SIZE]);
+    digits[PUZZLE_SIZE] = '\0';
+
+    // flushed at once, the next program of the pipeline gets each solution as soon as it is found
+    fprintf(stream->output, "%s %s %d %f\n", puzzle->hash, digits, puzzle->result.cost, puzzle->result.time);
+    fflush(stream->output);
+}
+
+/// @brief Solves the puzzles of the stream one after the other until the input is exhausted, run by each thread
+/// @param stream the stream
+static void sudoku_stream_work(struct sudoku_stream *stream)
+{
+    struct stream_puzzle puzzle;
+    unsigned int seed;
+
+    // the solver works on grids given as arrays of lines
+    int *grid[SUDOKU_SIZE], *solution[SUDOKU_SIZE];
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        grid[i] = puzzle.grid[i];
+        solution[i] = puzzle.solution[i];
+    }
+
+    pthread_mutex_lock(&stream->lock);
+    while (true)
+    {
+        // the solutions are written in order: a new puzzle is only read once there is room for it in the window
+        while (stream->ordered && !stream->end && stream->read - stream->written >= stream->window)
+            pthread_cond_wait(&stream->space, &stream->lock);
+        if (stream->end || !sudoku_stream_read(stream, &puzzle))
+        {
+            stream->end = true;
+            pthread_cond_broadcast(&stream->space);
+            break;
+        }
+        puzzle.sequence = stream->read++;
+        pthread_mutex_unlock(&stream->lock);
+
+        // each puzzle gets its own seed, so the threads don't share any state while solving
+        seed = stream->seed ^ (unsigned int)(puzzle.sequence * 2654435761u);
+        if (sudoku_solve(grid, puzzle.hash, stream->options, solution, &seed, &puzzle.result) == -1)
+        {
+            fprintf(stderr, "ERROR: Out of memory!!\n");
+            exit(EXIT_FAILURE);
+        }
+
+        pthread_mutex_lock(&stream->lock);
+        if (puzzle.result.cost <= SOLUTION_COST)
+            stream->solved++;
+        // the records of the result file are at the index of their puzzle, they are written in any order
+        if (stream->sink != NULL)
+            result_sink_write(stream->sink, puzzle.sequence, puzzle.hash, &puzzle.result, solution);
+
+        if (!stream->ordered)
+        {
+            sudoku_stream_write(stream, &puzzle);
+            stream->written++;
+            continue;
+        }
+
+        // keep the solution until the previous puzzles are written, then write every solution that follows in order
+        struct stream_puzzle *slot = &stream->slots[puzzle.sequence % stream->window];
+        *slot = puzzle;
+        slot->done = true;
+        while ((slot = &stream->slots[stream->written % stream->window])->done)
+        {
+            sudoku_stream_write(stream, slot);
+            slot->done = false;
+            stream->written++;
+        }
+        pthread_cond_broadcast(&stream->space);
+    }
+    pthread_mutex_unlock(&stream->lock);
+}
+
+/// @brief Solves every puzzle of the stream with the given number of threads, each one solving a puzzle at a time
+/// @param stream the stream
+/// @param threads the number of threads
+/// @return the number of puzzles solved (cost SOLUTION_COST)
+long sudoku_stream_solve(struct sudoku_stream *stream, int threads)
+{
+    #pragma omp parallel num_threads(threads)
+    sudoku_stream_work(stream);
+
+    return stream->solved;
+}
@@ -1,5 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "cost.h"
+#include "moves.h"
+#include "utils.h"
+#include "canonical.h"
+#include "solver.h"
+#include "checkpoint.h"
+#include "verifier.h"
 
 #define ROWS 3
 #define COLS 4
@@ -86,6 +97,403 @@ int get_bound_randomm(unsigned int *seed, unsigned int lBound, unsigned int uBou
     return r;
 }
 
+#define TEST_PUZZLE_FILE SUDOKU_DIR "test.txt"
+#define TEST_PUZZLE "0000183b305c"
+#define TEST_MOVES 20000
+
+/// @brief Checks the single pass cost change of every cost function (weighted or not) against the difference of the
+///        costs of the whole grid before and after random cell changes, and the batched cost changes against the single ones
+/// @param seed the seed used in the pseudo random number generator
+/// @return the number of cost changes different from the one of the whole grid
+int test_cost_models(unsigned int *seed)
+{
+    char filename[FILE_SIZE] = TEST_PUZZLE_FILE;
+    int **original_grid = read_sudoku_file(filename, SUDOKU_SIZE, TEST_PUZZLE);
+    int **lines = create_sudoku_lines(original_grid);
+    int ***regions = create_sudoku_region(lines);
+    int ***columns = create_sudoku_columns(lines);
+    int weights[UNITS];
+    int errors = 0;
+
+    for (int weighted = 0; weighted < 2; weighted++)
+    {
+        for (enum cost_function kind = COST_PAIRS; kind < COST_FUNCTIONS; kind++)
+        {
+            struct cost_model model;
+            cost_model_init(&model, kind, original_grid, weighted ? weights : NULL);
+            for (int u = 0; u < UNITS; u++)
+                weights[u] = get_bound_random(seed, 1, 5);
+
+            sudoku_copy_content(&lines, original_grid);
+            sudoku_randomize(&lines, original_grid, seed);
+            int cost = sudoku_cost(lines, columns, regions, &model);
+            int i = -1, j = -1, new, delta, mismatches = 0;
+            for (int k = 0; k < TEST_MOVES; k++)
+            {
+                sudoku_get_random_cell(original_grid, &i, &j, seed);
+                new = get_bound_random(seed, 1, 9);
+                delta = sudoku_cell_delta(new, i, j, lines, columns, regions, &model);
+
+                // the batched evaluation of every number must agree with the single one
+                int deltas[SUDOKU_SIZE + 1];
+                sudoku_cell_deltas(i, j, lines, columns, regions, &model, deltas);
+                for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+                {
+                    if (deltas[nb] != sudoku_cell_delta(nb, i, j, lines, columns, regions, &model))
+                        mismatches++;
+                }
+
+                lines[i][j] = new;
+                if (cost + delta != sudoku_cost(lines, columns, regions, &model))
+                    mismatches++;
+                cost = sudoku_cost(lines, columns, regions, &model);
+            }
+
+            printf("cost function %-7s %-10s : %d mismatches in %d moves\n", cost_function_name(kind), weighted ? "weighted" : "unweighted", mismatches, TEST_MOVES);
+            errors += mismatches;
+        }
+    }
+
+    sudoku_free_pointers(regions);
+    sudoku_free_pointers(columns);
+    sudoku_free(lines);
+    sudoku_free(original_grid);
+    return errors;
+}
+
+#define TEST_SYMMETRIES 200
+#define TEST_EMPTY_CELLS 50
+
+/// @brief Fills a grid with a valid solution, each line being the previous one shifted by a region (or by one cell at the
+///        start of a band)
+/// @param grid the grid
+void test_fill_solution(int **grid)
+{
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+            grid[i][j] = (i * SUDOKU_GRID_SIZE + i / SUDOKU_GRID_SIZE + j) % SUDOKU_SIZE + 1;
+}
+
+/// @brief Shuffles a permutation of the given numbers in place
+/// @param permutation the numbers
+/// @param n the count of numbers
+/// @param seed the seed used in the pseudo random number generator
+void test_shuffle(int *permutation, int n, unsigned int *seed)
+{
+    for (int k = n - 1; k > 0; k--)
+    {
+        int r = get_bound_random(seed, 0, k);
+        int t = permutation[k];
+        permutation[k] = permutation[r];
+        permutation[r] = t;
+    }
+}
+
+/// @brief Maps a grid through a random symmetry of the sudoku: a transposition, permutations of the bands and of the
+///        stacks, of the lines inside each band and of the columns inside each stack, and a relabeling of the digits
+/// @param grid the grid
+/// @param symmetric the grid mapped
+/// @param seed the seed used in the pseudo random number generator
+void test_random_symmetry(int **grid, int **symmetric, unsigned int *seed)
+{
+    int bands[SUDOKU_GRID_SIZE], stacks[SUDOKU_GRID_SIZE], line[SUDOKU_SIZE], column[SUDOKU_SIZE], label[SUDOKU_SIZE + 1];
+    for (int b = 0; b < SUDOKU_GRID_SIZE; b++)
+        bands[b] = stacks[b] = b;
+    test_shuffle(bands, SUDOKU_GRID_SIZE, seed);
+    test_shuffle(stacks, SUDOKU_GRID_SIZE, seed);
+    for (int b = 0; b < SUDOKU_GRID_SIZE; b++)
+    {
+        int inner_lines[SUDOKU_GRID_SIZE], inner_columns[SUDOKU_GRID_SIZE];
+        for (int k = 0; k < SUDOKU_GRID_SIZE; k++)
+            inner_lines[k] = inner_columns[k] = k;
+        test_shuffle(inner_lines, SUDOKU_GRID_SIZE, seed);
+        test_shuffle(inner_columns, SUDOKU_GRID_SIZE, seed);
+        for (int k = 0; k < SUDOKU_GRID_SIZE; k++)
+        {
+            line[b * SUDOKU_GRID_SIZE + k] = bands[b] * SUDOKU_GRID_SIZE + inner_lines[k];
+            column[b * SUDOKU_GRID_SIZE + k] = stacks[b] * SUDOKU_GRID_SIZE + inner_columns[k];
+        }
+    }
+    label[0] = 0;
+    for (int nb = 1; nb <= SUDOKU_SIZE; nb++)
+        label[nb] = nb;
+    test_shuffle(label + 1, SUDOKU_SIZE, seed);
+
+    int transposed = get_bound_random(seed, 0, 1);
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            int nb = transposed ? grid[column[j]][line[i]] : grid[line[i]][column[j]];
+            symmetric[i][j] = label[nb];
+        }
+}
+
+/// @brief Checks that the puzzles mapped through random symmetries have the canonical grid of the original puzzle, and that
+///        a solution mapped through the symmetry of a canonical form and back is the solution
+/// @param seed the seed used in the pseudo random number generator
+/// @return the number of symmetric puzzles with another canonical grid and of solutions not mapped back
+int test_canonical_forms(unsigned int *seed)
+{
+    char filename[FILE_SIZE] = TEST_PUZZLE_FILE;
+    int **solution = read_sudoku_file(filename, SUDOKU_SIZE, TEST_PUZZLE);
+    test_fill_solution(solution);
+    int **puzzle = create_sudoku_lines(solution);
+    for (int k = 0; k < TEST_EMPTY_CELLS; k++)
+        puzzle[get_bound_random(seed, 0, SUDOKU_SIZE - 1)][get_bound_random(seed, 0, SUDOKU_SIZE - 1)] = 0;
+    int **symmetric_puzzle = create_sudoku_lines(puzzle);
+    int **symmetric_solution = create_sudoku_lines(solution);
+    int **restored = create_sudoku_lines(solution);
+
+    struct canonical_form original, form;
+    sudoku_canonicalize(puzzle, &original);
+
+    int different = 0, unrestored = 0;
+    uint8_t digits[PUZZLE_SIZE];
+    for (int s = 0; s < TEST_SYMMETRIES; s++)
+    {
+        // the same symmetry maps the puzzle and its solution
+        unsigned int symmetry_seed = *seed;
+        test_random_symmetry(puzzle, symmetric_puzzle, &symmetry_seed);
+        symmetry_seed = *seed;
+        test_random_symmetry(solution, symmetric_solution, &symmetry_seed);
+        *seed = symmetry_seed;
+
+        sudoku_canonicalize(symmetric_puzzle, &form);
+        if (memcmp(form.digits, original.digits, PUZZLE_SIZE) != 0)
+            different++;
+
+        canonical_form_apply(&form, symmetric_solution, digits);
+        canonical_form_restore(&form, digits, restored);
+        bool same = true;
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+            for (int j = 0; j < SUDOKU_SIZE; j++)
+                same = same && restored[i][j] == symmetric_solution[i][j];
+        if (!same)
+            unrestored++;
+    }
+
+    printf("canonical forms : %d different and %d solutions not restored in %d symmetries\n", different, unrestored, TEST_SYMMETRIES);
+
+    sudoku_free(restored);
+    sudoku_free(symmetric_solution);
+    sudoku_free(symmetric_puzzle);
+    sudoku_free(puzzle);
+    sudoku_free(solution);
+    return different + unrestored;
+}
+
+#define TEST_INTERRUPTIONS 3
+#define TEST_HARD_PUZZLE "100007090030020008009000500005300900010080002600004000300000010040000007007000300"
+
+/// @brief Checks that a run interrupted after each of its first tries and resumed from its checkpoint (seed and state) makes
+///        the moves and finds the grid of the uninterrupted run with the same seed, without and with the weighting and the
+///        tightening of the domains
+/// @param seed the seed used in the pseudo random number generator
+/// @return the number of resumed runs different from the uninterrupted one
+int test_checkpoint_resume(unsigned int *seed)
+{
+    char filename[FILE_SIZE] = TEST_PUZZLE_FILE;
+    char puzzle_hash[] = TEST_PUZZLE;
+    int **original_grid = read_sudoku_file(filename, SUDOKU_SIZE, TEST_PUZZLE);
+    int **solution = create_sudoku_lines(original_grid);
+    int **resumed_solution = create_sudoku_lines(original_grid);
+    int errors = 0;
+
+    // the givens of the test puzzle are enough to find every cell by propagation, the tightened runs take AI Escargot
+    // without one of its givens
+    int **hard_grid = create_sudoku_lines(original_grid);
+    for (int k = 0; k < PUZZLE_SIZE; k++)
+        hard_grid[k / SUDOKU_SIZE][k % SUDOKU_SIZE] = TEST_HARD_PUZZLE[k] - '0';
+
+    // the checkpoint is saved in a temporary file, only its name is kept
+    char checkpoint[] = "/tmp/sudoku_checkpoint_XXXXXX";
+    int fd = mkstemp(checkpoint);
+    if (fd == -1)
+    {
+        perror("mkstemp");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    unlink(checkpoint);
+
+    for (int state = 0; state < 2; state++)
+    {
+        struct solver_options options;
+        solver_options_init(&options);
+        options.quiet = true;
+        options.adaptive = false; // the adaptation depends on the time taken by the moves
+        options.weighting = options.tightening = (state == 1);
+        int **grid = (state == 1) ? hard_grid : original_grid;
+        unsigned int run_seed = get_bound_random(seed, 1, 1 << 30);
+
+        struct solver_result uninterrupted, resumed;
+        unsigned int uninterrupted_seed = run_seed;
+        sudoku_solve(grid, puzzle_hash, &options, solution, &uninterrupted_seed, &uninterrupted);
+
+        // each run stops at the end of its first try, the next one goes on from its checkpoint and the last one to the end
+        volatile sig_atomic_t interrupted = 1;
+        unsigned int resumed_seed = run_seed;
+        options.checkpoint = checkpoint;
+        options.interrupted = &interrupted;
+        int interruptions = 0;
+        do
+        {
+            interrupted = (interruptions < TEST_INTERRUPTIONS);
+            sudoku_solve(grid, puzzle_hash, &options, resumed_solution, &resumed_seed, &resumed);
+            interruptions += resumed.interrupted;
+            options.resume = true;
+        } while (resumed.interrupted);
+        solver_checkpoint_remove(checkpoint);
+
+        bool same = resumed.solved == uninterrupted.solved && resumed.tries == uninterrupted.tries &&
+                    resumed.moves == uninterrupted.moves && resumed.cost == uninterrupted.cost;
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+            for (int j = 0; j < SUDOKU_SIZE; j++)
+                same = same && resumed_solution[i][j] == solution[i][j];
+        if (!same)
+            errors++;
+
+        printf("checkpoint %-10s : %d interruptions, %d tries and %lld moves resumed, %d tries and %lld moves uninterrupted : %s\n",
+               state ? "tightened" : "plain", interruptions, resumed.tries, resumed.moves, uninterrupted.tries, uninterrupted.moves,
+               same ? "same" : "different");
+    }
+
+    sudoku_free(hard_grid);
+    sudoku_free(resumed_solution);
+    sudoku_free(solution);
+    sudoku_free(original_grid);
+    return errors;
+}
+
+#define TEST_VERIFICATIONS 20000
+#define TEST_PACKED_SIZE ((PUZZLE_SIZE + 1) / 2)
+
+/// @brief Verifies a solution against its puzzle cell by cell and unit by unit, as a reference for the verifier
+/// @param puzzle the digits of the puzzle, line by line, 0 for an empty cell
+/// @param solution the digits of the solution, line by line
+/// @return the outcome of the verification
+enum verify_outcome test_naive_verify(const uint8_t *puzzle, const uint8_t *solution)
+{
+    for (int k = 0; k < PUZZLE_SIZE; k++)
+        if (solution[k] < 1 || solution[k] > SUDOKU_SIZE)
+            return VERIFY_DIGITS;
+    for (int k = 0; k < PUZZLE_SIZE; k++)
+        if (puzzle[k] != 0 && puzzle[k] != solution[k])
+            return VERIFY_GIVENS;
+
+    // the 9 lines, the 9 columns and the 9 regions must each hold every digit once
+    for (int u = 0; u < UNITS; u++)
+    {
+        bool seen[SUDOKU_SIZE + 1] = {false};
+        for (int n = 0; n < SUDOKU_SIZE; n++)
+        {
+            int i, j;
+            if (u < SUDOKU_SIZE)
+                i = u, j = n;
+            else if (u < 2 * SUDOKU_SIZE)
+                i = n, j = u - SUDOKU_SIZE;
+            else
+            {
+                int r = u - 2 * SUDOKU_SIZE;
+                i = (r / SUDOKU_GRID_SIZE) * SUDOKU_GRID_SIZE + n / SUDOKU_GRID_SIZE;
+                j = (r % SUDOKU_GRID_SIZE) * SUDOKU_GRID_SIZE + n % SUDOKU_GRID_SIZE;
+            }
+            if (seen[solution[i * SUDOKU_SIZE + j]])
+                return VERIFY_UNITS;
+            seen[solution[i * SUDOKU_SIZE + j]] = true;
+        }
+    }
+    return VERIFY_VALID;
+}
+
+/// @brief Packs the digits of a grid two per byte, the first one in the high nibble
+/// @param digits the digits, line by line
+/// @param packed the packed digits
+void test_pack(const uint8_t *digits, uint8_t *packed)
+{
+    memset(packed, 0, TEST_PACKED_SIZE);
+    for (int k = 0; k < PUZZLE_SIZE; k++)
+        packed[k / 2] |= (k % 2 == 0) ? digits[k] << 4 : digits[k];
+}
+
+/// @brief Compares the verifier, on the digits and on the packed digits, with a naive verification on random solutions:
+///        valid ones (the test solution through a random symmetry), and ones with a digit out of range, a given changed,
+///        two cells or two lines swapped or random digits
+/// @param seed the seed used in the pseudo random number generator
+/// @return the number of outcomes different from the naive one
+int test_verifier(unsigned int *seed)
+{
+    char filename[FILE_SIZE] = TEST_PUZZLE_FILE;
+    int **grid = read_sudoku_file(filename, SUDOKU_SIZE, TEST_PUZZLE);
+    test_fill_solution(grid);
+    int **symmetric = create_sudoku_lines(grid);
+    int counts[VERIFY_OUTCOMES] = {0};
+    int mismatches = 0;
+
+    for (int v = 0; v < TEST_VERIFICATIONS; v++)
+    {
+        uint8_t puzzle[PUZZLE_SIZE], solution[PUZZLE_SIZE];
+        test_random_symmetry(grid, symmetric, seed);
+        for (int k = 0; k < PUZZLE_SIZE; k++)
+        {
+            solution[k] = symmetric[k / SUDOKU_SIZE][k % SUDOKU_SIZE];
+            puzzle[k] = (get_bound_random(seed, 0, 2) == 0) ? solution[k] : 0;
+        }
+
+        int k = get_bound_random(seed, 0, PUZZLE_SIZE - 1), l = get_bound_random(seed, 0, PUZZLE_SIZE - 1);
+        switch (v % 6)
+        {
+        case 1: // a digit out of range, that can still be packed
+            solution[k] = (get_bound_random(seed, 0, 1) == 0) ? 0 : get_bound_random(seed, SUDOKU_SIZE + 1, 15);
+            break;
+        case 2: // a given changed
+            puzzle[k] = solution[k];
+            solution[k] = solution[k] % SUDOKU_SIZE + 1;
+            break;
+        case 3: // two cells swapped, the givens are left as they are
+            puzzle[k] = puzzle[l] = 0;
+            uint8_t t = solution[k];
+            solution[k] = solution[l];
+            solution[l] = t;
+            break;
+        case 4: // random digits in a few cells
+            for (int n = get_bound_random(seed, 1, 4); n > 0; n--)
+                solution[get_bound_random(seed, 0, PUZZLE_SIZE - 1)] = get_bound_random(seed, 0, 15);
+            break;
+        case 5: // two lines swapped, only the regions are left invalid when they are in different bands
+            k /= SUDOKU_SIZE;
+            l /= SUDOKU_SIZE;
+            for (int j = 0; j < SUDOKU_SIZE; j++)
+            {
+                puzzle[k * SUDOKU_SIZE + j] = puzzle[l * SUDOKU_SIZE + j] = 0;
+                uint8_t t = solution[k * SUDOKU_SIZE + j];
+                solution[k * SUDOKU_SIZE + j] = solution[l * SUDOKU_SIZE + j];
+                solution[l * SUDOKU_SIZE + j] = t;
+            }
+            break;
+        }
+
+        uint8_t packed_puzzle[TEST_PACKED_SIZE], packed_solution[TEST_PACKED_SIZE];
+        test_pack(puzzle, packed_puzzle);
+        test_pack(solution, packed_solution);
+        enum verify_outcome expected = test_naive_verify(puzzle, solution);
+        if (sudoku_verify(puzzle, solution) != expected)
+            mismatches++;
+        if (sudoku_verify_packed(packed_puzzle, packed_solution) != expected)
+            mismatches++;
+        counts[expected]++;
+    }
+
+    printf("verifier : %d mismatches in %d solutions (", mismatches, TEST_VERIFICATIONS);
+    for (enum verify_outcome outcome = VERIFY_VALID; outcome < VERIFY_OUTCOMES; outcome++)
+        printf("%s%d %s", (outcome == VERIFY_VALID) ? "" : ", ", counts[outcome], verify_outcome_name(outcome));
+    printf(")\n");
+
+    sudoku_free(symmetric);
+    sudoku_free(grid);
+    return mismatches;
+}
+
 int main(void) {
     unsigned int seed = 123456;
 
@@ -105,5 +513,17 @@ int main(void) {
 
     printf("\n");
 
+    if (test_cost_models(&seed) != 0)
+        return EXIT_FAILURE;
+
+    if (test_canonical_forms(&seed) != 0)
+        return EXIT_FAILURE;
+
+    if (test_checkpoint_resume(&seed) != 0)
+        return EXIT_FAILURE;
+
+    if (test_verifier(&seed) != 0)
+        return EXIT_FAILURE;
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include <string.h>
+
+#include "trace.h"
+
+/// @brief Finds the trace level corresponding to the given name
+/// @param name the name of the level (sampled, accepted or complete)
+/// @param level the corresponding level
+/// @return true if the name is a known level, false otherwise
+bool trace_level_parse(const char *name, enum trace_level *level)
+{
+    for (int kind = 0; kind < TRACE_LEVELS; kind++)
+    {
+        if (strcmp(name, trace_level_name(kind)) == 0)
+        {
+            *level = kind;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Gets the name of the given trace level
+/// @param level the trace level
+/// @return the name of the level
+const char *trace_level_name(enum trace_level level)
+{
+    switch (level)
+    {
+    case TRACE_SAMPLED:
+        return "sampled";
+    case TRACE_ACCEPTED:
+        return "accepted";
+    case TRACE_COMPLETE:
+        return "complete";
+    default:
+        return "unknown";
+    }
+}
+
+/// @brief Writes the buffered events to the trace file, they are dropped once a write failed (the run goes on untraced)
+/// @param trace the trace
+static void trace_flush(struct trace_writer *trace)
+{
+    if (trace->used > 0 && !trace->failed && fwrite(trace->buffer, 1, trace->used, trace->fp) != trace->used)
+    {
+        perror("Problem encountered when writing the trace file");
+        trace->failed = true;
+    }
+    trace->used = 0;
+}
+
+/// @brief Appends an unsigned varint to the buffered events: 7 bits per byte, least significant first
+/// @param trace the trace
+/// @param value the value
+static inline void trace_put_varint(struct trace_writer *trace, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        trace->buffer[trace->used++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    trace->buffer[trace->used++] = (unsigned char)value;
+}
+
+/// @brief Appends a signed value to the buffered events, zigzag encoded so the small negative values stay short
+/// @param trace the trace
+/// @param value the value
+static inline void trace_put_signed(struct trace_writer *trace, int64_t value)
+{
+    trace_put_varint(trace, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+/// @brief Starts an event: makes room for it, then appends its tag and the number of moves since the previous event
+/// @param trace the trace
+/// @param tag the event, the acceptance of a move and its number of cells
+static inline void trace_put_event(struct trace_writer *trace, unsigned char tag)
+{
+    if (trace->used + TRACE_EVENT_SIZE > TRACE_BUFFER_SIZE)
+        trace_flush(trace);
+    trace->buffer[trace->used++] = tag;
+    trace_put_varint(trace, (uint64_t)(trace->moves - trace->last));
+    trace->last = trace->moves;
+}
+
+/// @brief Appends a whole grid to the buffered events, two digits per byte
+/// @param trace the trace
+/// @param lines the grid
+static void trace_put_grid(struct trace_writer *trace, int **lines)
+{
+    unsigned char *digits = trace->buffer + trace->used;
+    memset(digits, 0, RECORD_DIGITS);
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        digits[i / 2] |= lines[i / SUDOKU_SIZE][i % SUDOKU_SIZE] << ((i % 2 == 0) ? 4 : 0);
+    trace->used += RECORD_DIGITS;
+}
+
+/// @brief Creates a trace file
+/// @param trace the trace
+/// @param filename the trace file
+/// @param level what the trace records
+/// @return false if the file or its buffer couldn't be created (nothing is left open), true otherwise
+bool trace_open(struct trace_writer *trace, const char *filename, enum trace_level level)
+{
+    memset(trace, 0, sizeof(struct trace_writer));
+    trace->level = level;
+    if ((trace->fp = fopen(filename, "wb")) == NULL || (trace->buffer = malloc(TRACE_BUFFER_SIZE)) == NULL)
+    {
+        perror("Problem encountered when creating the trace file");
+        if (trace->fp != NULL)
+            fclose(trace->fp);
+        trace->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+/// @brief Writes the header of the trace, at the start of the run
+/// @param trace the trace
+/// @param original_grid the grid of the puzzle
+/// @param seed the seed of the run
+/// @param cost_function the cost function of the annealing
+/// @param flags TRACE_WEIGHTED and TRACE_TIGHTENED
+void trace_begin(struct trace_writer *trace, int **original_grid, unsigned int seed, int cost_function, unsigned int flags)
+{
+    struct trace_header header;
+    memset(&header, 0, sizeof(struct trace_header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.level = trace->level;
+    header.seed = seed;
+    header.cost_function = cost_function;
+    header.sample_period = TRACE_SAMPLE_PERIOD;
+    header.flags = flags;
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        header.givens[i / 2] |= original_grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE] << ((i % 2 == 0) ? 4 : 0);
+
+    memcpy(trace->buffer, &header, sizeof(struct trace_header));
+    trace->used = sizeof(struct trace_header);
+}
+
+/// @brief Records the start of a try
+/// @param trace the trace
+/// @param try the number of the try
+/// @param lines the starting grid of the try
+/// @param cost the cost of the grid
+void trace_try(struct trace_writer *trace, int try, int **lines, int cost)
+{
+    trace_put_event(trace, TRACE_TRY);
+    trace_put_varint(trace, (uint64_t)try);
+    trace_put_grid(trace, lines);
+    trace_put_signed(trace, cost);
+    trace->sample = trace->moves;
+}
+
+/// @brief Records the whole grid, after cells were changed outside of the moves
+/// @param trace the trace
+/// @param lines the grid
+/// @param cost the cost of the grid
+void trace_grid(struct trace_writer *trace, int **lines, int cost)
+{
+    trace_put_event(trace, TRACE_GRID);
+    trace_put_grid(trace, lines);
+    trace_put_signed(trace, cost);
+    trace->sample = trace->moves;
+}
+
+/// @brief Records a move, before it is undone if rejected: the cells hold their new values. Only the accepted moves are
+///        needed to rebuild the grids, the sampled level only keeps a snapshot of the grid once in a while
+/// @param trace the trace
+/// @param lines the grid, with the cells of the move changed
+/// @param n the number of cells of the move
+/// @param line the line index of each cell
+/// @param column the column index of each cell
+/// @param accepted if the move is accepted
+/// @param delta the change of the cost made by the move
+/// @param cost the cost of the grid once the move is accepted or undone
+void trace_move(struct trace_writer *trace, int **lines, int n, const int *line, const int *column, bool accepted, int delta, int cost)
+{
+    trace->moves++;
+    if (trace->level == TRACE_SAMPLED)
+    { // the grid only matches the cost once the move is accepted
+        if (accepted && trace->moves - trace->sample >= TRACE_SAMPLE_PERIOD)
+            trace_grid(trace, lines, cost);
+        return;
+    }
+    if (!accepted && trace->level != TRACE_COMPLETE)
+        return;
+
+    trace_put_event(trace, (unsigned char)(TRACE_MOVE | ((accepted) ? 0x10 : 0) | (n << 5)));
+    for (int k = 0; k < n; k++)
+    {
+        trace->buffer[trace->used++] = (unsigned char)(line[k] * SUDOKU_SIZE + column[k]);
+        trace->buffer[trace->used++] = (unsigned char)lines[line[k]][column[k]];
+    }
+    trace_put_signed(trace, delta);
+}
+
+/// @brief Records a new temperature
+/// @param trace the trace
+/// @param temperature the temperature
+void trace_temperature(struct trace_writer *trace, double temperature)
+{
+    float value = (float)temperature;
+    trace_put_event(trace, TRACE_TEMPERATURE);
+    memcpy(trace->buffer + trace->used, &value, sizeof(float));
+    trace->used += sizeof(float);
+}
+
+/// @brief Records a new cost of the grid, when the weights of the constraints were raised
+/// @param trace the trace
+/// @param cost the cost
+void trace_cost(struct trace_writer *trace, int cost)
+{
+    trace_put_event(trace, TRACE_COST);
+    trace_put_signed(trace, cost);
+}
+
+/// @brief Records the end of the run and closes the trace file
+/// @param trace the trace
+/// @param cost the unweighted cost of the final grid
+void trace_close(struct trace_writer *trace, int cost)
+{
+    trace_put_event(trace, TRACE_END);
+    trace_put_signed(trace, cost);
+    trace_flush(trace);
+    if (fclose(trace->fp) != 0)
+        perror("Problem encountered when closing the trace file");
+    free(trace->buffer);
+    trace->buffer = NULL;
+    trace->fp = NULL;
+}
+
+/// @brief Reads an unsigned varint (7 bits per byte, least significant first)
+/// @param fp the file
+/// @param value the value read
+/// @return true if a value was read, false at the end of the file
+static bool trace_read_varint(FILE *fp, uint64_t *value)
+{
+    int byte;
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if ((byte = getc(fp)) == EOF)
+            return false;
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+/// @brief Reads a zigzag encoded signed value
+/// @param fp the file
+/// @param value the value read
+/// @return true if a value was read, false at the end of the file
+static bool trace_read_signed(FILE *fp, int *value)
+{
+    uint64_t raw;
+    if (!trace_read_varint(fp, &raw))
+        return false;
+    *value = (int)((int64_t)(raw >> 1) ^ -(int64_t)(raw & 1));
+    return true;
+}
+
+/// @brief Reads a whole grid, two digits per byte
+/// @param fp the file
+/// @param grid the grid read
+/// @return true if the grid was read, false at the end of the file
+static bool trace_read_grid(FILE *fp, int grid[SUDOKU_SIZE][SUDOKU_SIZE])
+{
+    uint8_t digits[RECORD_DIGITS];
+    if (fread(digits, 1, RECORD_DIGITS, fp) != RECORD_DIGITS)
+        return false;
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE] = (digits[i / 2] >> ((i % 2 == 0) ? 4 : 0)) & 0xf;
+    return true;
+}
+
+/// @brief Opens a trace file and reads its header
+/// @param reader the trace being read
+/// @param filename the trace file
+/// @return true if the file is a trace, false otherwise
+bool trace_reader_open(struct trace_reader *reader, const char *filename)
+{
+    memset(reader, 0, sizeof(struct trace_reader));
+    if ((reader->fp = fopen(filename, "rb")) == NULL)
+        return false;
+    if (fread(&reader->header, sizeof(struct trace_header), 1, reader->fp) != 1 ||
+        memcmp(reader->header.magic, TRACE_MAGIC, sizeof(reader->header.magic)) != 0)
+    {
+        fclose(reader->fp);
+        reader->fp = NULL;
+        return false;
+    }
+    return true;
+}
+
+/// @brief Reads the next event of a trace
+/// @param reader the trace being read
+/// @param record the event read
+/// @return true if an event was read, false at the end of the trace or if it is truncated
+bool trace_read(struct trace_reader *reader, struct trace_record *record)
+{
+    int tag = getc(reader->fp);
+    uint64_t gap, value;
+    float temperature;
+    if (tag == EOF || !trace_read_varint(reader->fp, &gap))
+        return false;
+
+    reader->moves += (long long)gap;
+    record->event = tag & 0xf;
+    record->moves = reader->moves;
+    switch (record->event)
+    {
+    case TRACE_TRY:
+        if (!trace_read_varint(reader->fp, &value))
+            return false;
+        record->try = (int)value;
+        return trace_read_grid(reader->fp, record->grid) && trace_read_signed(reader->fp, &record->cost);
+    case TRACE_GRID:
+        return trace_read_grid(reader->fp, record->grid) && trace_read_signed(reader->fp, &record->cost);
+    case TRACE_MOVE:
+        record->accepted = (tag & 0x10) != 0;
+        record->n = tag >> 5;
+        if (record->n > MOVE_MAX_CELLS)
+            return false;
+        for (int k = 0; k < record->n; k++)
+        {
+            int cell = getc(reader->fp), digit = getc(reader->fp);
+            if (digit == EOF || cell >= PUZZLE_SIZE)
+                return false;
+            record->line[k] = cell / SUDOKU_SIZE;
+            record->column[k] = cell % SUDOKU_SIZE;
+            record->value[k] = digit;
+        }
+        return trace_read_signed(reader->fp, &record->delta);
+    case TRACE_TEMPERATURE:
+        if (fread(&temperature, sizeof(float), 1, reader->fp) != 1)
+            return false;
+        record->temperature = temperature;
+        return true;
+    case TRACE_COST:
+    case TRACE_END:
+        return trace_read_signed(reader->fp, &record->cost);
+    default:
+        return false;
+    }
+}
+
+/// @brief Closes a trace file being read
+/// @param reader the trace being read
+void trace_reader_close(struct trace_reader *reader)
+{
+    if (reader->fp != NULL)
+        fclose(reader->fp);
+    reader->fp = NULL;
+}
@@ -1,4 +1,6 @@
 #include "utils.h"
+#include "bank.h"
+#include "logger.h"
 
 /// @brief Get a random double from 0 to 1 [0;1]
 /// @return
@@ -21,104 +23,209 @@ int get_bound_random(unsigned int *seed, unsigned int lBound, unsigned int uBoun
 
 /// @brief Function which reads a specified file containing various sudoku puzzles, identified by their unique hash
 /// and writes the puzzle's grid into a 2D integer line array
-/// @param filename the specified file with the corresponding scheme:
+/// @param filename the specified file, in the binary format (see bank.h) or with the corresponding scheme:
 ///      12 bytes of SHA1 hash of the digits string (for randomising order)
 ///      81 bytes of puzzle digits
 ///       4 bytes of rating (nn.n)
 ///       3 bytes of white-space (including the linefeed);
 ///     100 bytes total
 /// @param sudoku_dimension the dimension of the sudoku in the file
-/// @param puzzle_hash the specific sudoku puzzle to read
-/// @return 
+/// @param puzzle_hash the specific sudoku puzzle to read, NULL for the first puzzle of the index of the bank
+/// @return the grid of the puzzle, its empty cells are 0
 int **read_sudoku_file(char *filename, size_t sudoku_dimension, char *puzzle_hash)
 {
-    int fd;
-    int pos = 0;
+    // the bank is memory-mapped and the puzzle found by binary search, in the sidecar index of a text bank
+    // or directly in the records of a binary bank
+    struct puzzle_bank bank;
+    puzzle_bank_open(&bank, filename);
 
-    char c;                     // current character
-    char *line_buffer;          // buffer of read characters
-    size_t bytes_read;          // numbers of characters read
-    off_t size = LINE_SIZE + 1; // the size of each line
-
-    // The elements to get from each line of the given file
-    double difficulty;
+    int grid[SUDOKU_SIZE][SUDOKU_SIZE];
     char hash[HASH_SIZE + 1];
-    char puzzle[PUZZLE_SIZE + 1];
-
-    if ((fd = open(filename, O_RDONLY)) == -1)
+    double difficulty;
+    bool found;
+    if (puzzle_hash != (char *)NULL)
+        found = puzzle_bank_get(&bank, puzzle_hash, grid, &difficulty);
+    else
+        found = (bank.n > 0 && puzzle_bank_at(&bank, 0, hash, grid, &difficulty));
+    if (!found)
     {
-        perror("Problem encountered when opening puzzle file");
+        fprintf(stderr, "ERROR: puzzle %s not found in %s\n", (puzzle_hash != (char *)NULL) ? puzzle_hash : "", filename);
         exit(EXIT_FAILURE);
     }
+#if _DEBUG_
+    printf("Sudoku file %s | %f\n", (puzzle_hash != (char *)NULL) ? puzzle_hash : hash, difficulty);
+#endif
+    puzzle_bank_close(&bank);
 
-    if ((line_buffer = (char *)malloc(sizeof(char) * size)) == NULL)
+    int *rows[SUDOKU_SIZE];
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+        rows[i] = grid[i];
+    int **puzzle_grid = create_sudoku_lines(rows);
+    if (puzzle_grid == NULL)
     {
-        fprintf(stderr, "ERROR: Out of memory!!!\n");
+        fprintf(stderr, "ERROR: Out of memory!!\n");
         exit(EXIT_FAILURE);
     }
 
-    // This loop iterates through each character in the line of size LINE_SIZE (100 bytes),
-    // get the hash, puzzle and difficulty form the line and start again at the next line
+    return puzzle_grid;
+}
+
+/// @brief Returns a 2D array containing each region in order (from left to right)
+/// @param sudoku_grid
+/// @return An integer array containing every region of the sudoku grid in a 1D array for each region block, NULL if the memory
+///         couldn't be allocated
+int ***create_sudoku_region(int **sudoku_grid)
+{
+    int ***puzzle_grid;
+
+    int lines = SUDOKU_SIZE, cols = SUDOKU_SIZE;
 
-    lseek(fd, 0, SEEK_SET); // make suze to start at the start of the file
-    while ((bytes_read = read(fd, &c, sizeof(char))) > 0)
+    if ((puzzle_grid = (int ***)malloc(sizeof(int **) * lines)) == NULL)
+        return NULL;
+
+    for (int i = 0; i < lines; i++)
     {
-        if (c == '\n') // end of current sudoku grid entry
+        if ((puzzle_grid[i] = (int **)malloc(cols * sizeof(int *))) == NULL)
         {
-            line_buffer[pos] = '\0';
+            while (i-- > 0)
+                free(puzzle_grid[i]);
+            free(puzzle_grid);
+            return NULL;
+        }
+    }
 
-            //printf("%s\n", line_buffer);
-            if (sscanf(line_buffer, "%s %s %lf", hash, puzzle, &difficulty) != 3)
-            {
-                fprintf(stderr, "ERROR: invalid input line %s|\n|", line_buffer);
-                break;
-            }
-#if _DEBUG_
-            printf("Sudoku file %s | %s | %f\n", hash, puzzle, difficulty);
-#endif
-            // if the specific puzzle hash is given, then retrieve it from given file
-            if (puzzle_hash != (char *)NULL)
-            {
-                if (strcmp(hash, puzzle_hash) == 0)
-                {
-                    break;
-                }
-            }
+    int i, j, k, cursor;
+    int i_offset = 0, j_offset = 0;
+    for (k = 0; k < SUDOKU_SIZE; k++, j_offset += 3)
+    {
+        cursor = 0;
 
-            pos = 0;
-            line_buffer[pos] = '\0'; // empty the line buffer
+        if (k != 0 && k % 3 == 0)
+        {
+            i_offset += 3;
+            j_offset = 0;
         }
-        else
+
+        for (i = 0; i < SUDOKU_SIZE / 3; i++)
         {
-            line_buffer[pos++] = c;
+            for (j = 0; j < SUDOKU_SIZE / 3; j++)
+            {
+                puzzle_grid[k][cursor] = &sudoku_grid[i + i_offset][j + j_offset];
+                cursor++;
+            }
         }
     }
-    // free the line buffer and close the file handler
-    free(line_buffer);
-    close(fd);
 
+    return puzzle_grid;
+}
+
+/// @brief Returns a 2D array containing each line of the sudoku grid in order (from top to bottom)
+/// Each value points to the values in the provided array
+/// @param sudoku_grid the provided array
+/// @return the copy of the grid, NULL if the memory couldn't be allocated
+int **create_sudoku_lines(int **sudoku_grid)
+{
     int **puzzle_grid;
+
     int lines = SUDOKU_SIZE, cols = SUDOKU_SIZE;
 
     if ((puzzle_grid = (int **)malloc(sizeof(int *) * lines)) == NULL)
+        return NULL;
+
+    for (int i = 0; i < lines; i++)
     {
-        fprintf(stderr, "ERROR: Out of memory!!\n");
-        exit(EXIT_FAILURE);
+        if ((puzzle_grid[i] = (int *)malloc(cols * sizeof(int))) == NULL)
+        {
+            while (i-- > 0)
+                free(puzzle_grid[i]);
+            free(puzzle_grid);
+            return NULL;
+        }
     }
+
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+        {
+            puzzle_grid[i][j] = sudoku_grid[i][j];
+        }
+    }
+
+    return puzzle_grid;
+}
+
+/// @brief Returns a 2D array containing each line of the sudoku grid in order (from left to right)
+/// Each value points to the values in the provided array
+/// @param sudoku_grid the provided array
+/// @return the columns of the grid, NULL if the memory couldn't be allocated
+int ***create_sudoku_columns(int **sudoku_grid)
+{
+    int ***puzzle_grid;
+
+    int lines = SUDOKU_SIZE, cols = SUDOKU_SIZE;
+
+    if ((puzzle_grid = (int ***)malloc(sizeof(int **) * lines)) == NULL)
+        return NULL;
+
     for (int i = 0; i < lines; i++)
-        puzzle_grid[i] = (int *)malloc(sizeof(int) * cols);
+    {
+        if ((puzzle_grid[i] = (int **)malloc(cols * sizeof(int *))) == NULL)
+        {
+            while (i-- > 0)
+                free(puzzle_grid[i]);
+            free(puzzle_grid);
+            return NULL;
+        }
+    }
 
-    int line = 0;
-    for (int i = 0; i < PUZZLE_SIZE; i++)
+    int i, j;
+    for (i = 0; i < SUDOKU_SIZE; i++)
     {
-        if (i != 0 && i % SUDOKU_SIZE == 0)
-            line++;
-        puzzle_grid[line][i % SUDOKU_SIZE] = puzzle[i] - '0';
+        for (j = 0; j < SUDOKU_SIZE; j++)
+        {
+            puzzle_grid[i][j] = &sudoku_grid[j][i];
+        }
     }
 
     return puzzle_grid;
 }
 
+/**
+ * @brief Frees memory from each line and the sudoku grid itself
+ *
+ * @param sudoku_grid
+ */
+void sudoku_free(int **sudoku_grid)
+{
+    if (sudoku_grid != NULL)
+    {
+        // Free dynamically allocated memory
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+        {
+            free(sudoku_grid[i]);
+        }
+        free(sudoku_grid);
+    }
+}
+
+/**
+ * @brief Frees memory from each line and the sudoku grid itself
+ *
+ * @param sudoku_grid
+ */
+void sudoku_free_pointers(int ***sudoku_grid)
+{
+    if (sudoku_grid != NULL)
+    {
+        // Free dynamically allocated memory
+        for (int i = 0; i < SUDOKU_SIZE; i++)
+        {
+            free(sudoku_grid[i]);
+        }
+        free(sudoku_grid);
+    }
+}
+
 /// @brief Prints a sudoku grid from a 2D array of pointers, assuming the 2D grid is structured with lines and columns
 /// @param sudoku_grid
 void print_sudoku_pointers(int ***sudoku_grid)
@@ -200,6 +307,39 @@ void sudoku_randomize(int ***sudoku_grid, int ** original_grid, unsigned int * s
     }
 }
 
+/// @brief Randomize a fraction of the non fixed cells of the given sudoku grid, the cells are chosen at random
+///        and always get a value different from their current one
+/// @param sudoku_grid the given sudoku grid
+/// @param original_grid the starting grid, used to find the non fixed cells
+/// @param fraction the fraction of the non fixed cells to randomize, between 0 and 1
+/// @param seed the randomization seed used
+void sudoku_perturb(int ***sudoku_grid, int ** original_grid, double fraction, unsigned int * seed) {
+    int free_cells[PUZZLE_SIZE];
+    int n = 0;
+
+    for (int cell = 0; cell < PUZZLE_SIZE; cell++)
+    {
+        if (original_grid[cell / SUDOKU_SIZE][cell % SUDOKU_SIZE] == 0)
+            free_cells[n++] = cell;
+    }
+
+    int count = (int)(fraction * n + 0.5);
+    for (int k = 0; k < count && k < n; k++)
+    {
+        // partial shuffle of the free cells so each one is chosen at most once
+        int pick = get_bound_random(seed, k, n - 1);
+        int cell = free_cells[pick];
+        free_cells[pick] = free_cells[k];
+        free_cells[k] = cell;
+
+        int *value = &(*sudoku_grid)[cell / SUDOKU_SIZE][cell % SUDOKU_SIZE];
+        int new;
+        while ((new = get_bound_random(seed, 1, 9)) == *value)
+            ;
+        *value = new;
+    }
+}
+
 /// @brief Copies the content of a sudoku grid into another
 /// @param sudoku_grid the grid to modify the content of
 /// @param content the content to copy
@@ -213,7 +353,7 @@ void sudoku_copy_content(int ***sudoku_grid, int **content) {
     }
 }
 
-/// @brief Utility function to append the results obtained from the algorithm to a file
+/// @brief Utility function to append the results obtained from the algorithm to a file, through the logger
 /// @param filename the file in question, is created if doesn't exist yet. We assume it corresponds to the sudoku hash
 /// @param score the value returned from the cost function in the sudoku solving algorithm
 /// @param n_try the current try number
@@ -222,20 +362,42 @@ void sudoku_write_stats(char * filename, int score, int n_try, char * date) {
     char file[FILE_SIZE];
     snprintf(file, FILE_SIZE, "%s%s-%s.txt", "./data/", filename, date);
 
-    FILE *fp = fopen(file, "a+");
+    logger_write(file, "%d %d\n", n_try, score);
+}
 
-    if(!fp) fp = fopen(file, "w+");
-    if(!fp) {
-        fprintf(stderr, "Can't open file for statistics of sudoku [%s]\n", filename);
-        return;
-    }
+/// @brief Utility function to record the calibrated temperatures of the algorithm at the top of the statistics file,
+///        as a comment line so the file can still be plotted as is
+/// @param filename the file in question, is created if doesn't exist yet. We assume it corresponds to the sudoku hash
+/// @param start_temperature the start temperature of each try
+/// @param stop_temperature the temperature at which each try stops
+/// @param date the current file execution timestamp (h:m:s)
+void sudoku_write_calibration(char * filename, double start_temperature, double stop_temperature, char * date) {
+    char file[FILE_SIZE];
+    snprintf(file, FILE_SIZE, "%s%s-%s.txt", "./data/", filename, date);
+
+    logger_write(file, "# start_temperature: %f stop_temperature: %f\n", start_temperature, stop_temperature);
+}
 
-    fprintf(fp, "%d %d\n", n_try, score);
+/// @brief Utility function to append the probability of each kind of move learned during a try to a file,
+///        one line per try so the last one can be given back as the starting probabilities of another run
+/// @param filename the file in question, is created if doesn't exist yet. We assume it corresponds to the sudoku hash
+/// @param n_try the current try number
+/// @param probabilities the probability of each kind of move
+/// @param n the number of kinds of moves
+/// @param date the current file execution timestamp (h:m:s)
+void sudoku_write_operators(char * filename, int n_try, double * probabilities, int n, char * date) {
+    char file[FILE_SIZE];
+    char line[LOGGER_LINE_SIZE];
+    snprintf(file, FILE_SIZE, "%s%s-%s-operators.txt", "./data/", filename, date);
 
-    fclose(fp);
+    int length = snprintf(line, sizeof(line), "%d", n_try);
+    for(int i = 0; i < n && length < (int)sizeof(line); i++)
+        length += snprintf(line + length, sizeof(line) - length, " %f", probabilities[i]);
+
+    logger_write(file, "%s\n", line);
 }
 
-/// @brief Utility function to print the debug outputinfo  of the sudoku algorithm to the specified file
+/// @brief Utility function to print the debug outputinfo  of the sudoku algorithm to the specified file, through the logger
 /// @param filename the specified file
 /// @param info the debug info to send to tthe file 
 /// @param date the current file execution timestamp (h:m:s)
@@ -243,21 +405,13 @@ void sudoku_debug_output(char * filename, char * info, char * date) {
     char file[FILE_SIZE];
     snprintf(file, FILE_SIZE, "%s%s-%s.txt", "./debug/", filename, date);
 
-    FILE *fp = fopen(file, "a+");
-
-    if(!fp) fp = fopen(file, "w+");
-    if(!fp) {
-        fprintf(stderr, "Can't open file for statistics of sudoku [%s]\n", filename);
-        return;
-    }
-
-    fprintf(fp, "> [%s]\n", info);
-
-    fclose(fp);
+    logger_write(file, "> [%s]\n", info);
 }
 
 /// @brief Prints the current configuration of the sudoku solving alogrithm
-void print_config() {
+/// @param start_temperature the start temperature used by the algorithm
+/// @param stop_temperature the stop temperature used by the algorithm
+void print_config(double start_temperature, double stop_temperature) {
     printf("Current configuration: \n");
     if(KEEP_START) printf("  %s>[KEEP_START]Keep starting sudoku each try:%s %sON%s\n", CLR_YEL, CLR_RESET, CLR_GRN, CLR_RESET);
     else printf("  %s>[KEEP_START]Keep starting sudoku each try:%s %sOFF%s\n", CLR_YEL, CLR_RESET, CLR_RED, CLR_RESET);
@@ -276,5 +430,9 @@ void print_config() {
 
     printf("  %s>[SOLUTION_COST]The cost for the sudoku to be considered solved:%s %d\n", CLR_YEL, CLR_RESET, SOLUTION_COST);
 
-    printf("  %s>[START_TEMPERATURE]Starting temperature:%s %s%f%s\n", CLR_YEL, CLR_RESET, CLR_RED, START_TEMPERATURE, CLR_RESET);
+    if(AUTO_TEMPERATURE) printf("  %s>[AUTO_TEMPERATURE]Calibrate the temperatures from the initial grid:%s %sON%s\n", CLR_YEL, CLR_RESET, CLR_GRN, CLR_RESET);
+    else printf("  %s>[AUTO_TEMPERATURE]Calibrate the temperatures from the initial grid:%s %sOFF%s\n", CLR_YEL, CLR_RESET, CLR_RED, CLR_RESET);
+
+    printf("  %s>[START_TEMPERATURE]Starting temperature:%s %s%f%s\n", CLR_YEL, CLR_RESET, CLR_RED, start_temperature, CLR_RESET);
+    printf("  %s>[TEMPERATURE_CEILING]Stopping temperature:%s %s%f%s\n", CLR_YEL, CLR_RESET, CLR_RED, stop_temperature, CLR_RESET);
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <string.h>
+
+#include "verifier.h"
+
+_Static_assert(SUDOKU_SIZE == 9 && SUDOKU_GRID_SIZE == 3, "the verification kernels are written for 9x9 grids");
+
+// the kernels are also built for AVX2 on x86-64, the version run is chosen when the program is loaded
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define VERIFY_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define VERIFY_TARGETS
+#endif
+
+// 16 digits of a grid, and the bits of the digits of a unit in the first 9 of 16 lanes
+typedef uint8_t digit_lanes __attribute__((vector_size(16)));
+typedef uint16_t unit_lanes __attribute__((vector_size(32)));
+
+// the bits of the digits 1 to 9, every other byte has none
+static const uint16_t digit_bits[256] = {[1] = 1 << 1, [2] = 1 << 2, [3] = 1 << 3, [4] = 1 << 4, [5] = 1 << 5,
+                                         [6] = 1 << 6, [7] = 1 << 7, [8] = 1 << 8, [9] = 1 << 9};
+
+#define UNIT_BITS 0x3fe // the bits of a unit holding every digit
+#define DIGIT_CHUNKS ((PUZZLE_SIZE + 15) / 16)
+
+/// @brief Gets the name of the given outcome
+/// @param outcome the outcome
+/// @return the name of the outcome
+const char *verify_outcome_name(enum verify_outcome outcome)
+{
+    switch (outcome)
+    {
+    case VERIFY_VALID:
+        return "valid";
+    case VERIFY_DIGITS:
+        return "digits";
+    case VERIFY_GIVENS:
+        return "givens";
+    case VERIFY_UNITS:
+        return "units";
+    default:
+        return "unknown";
+    }
+}
+
+/// @brief Finds if any lane of the given digit lanes is set
+/// @param lanes the lanes
+/// @return true if a lane isn't 0
+static inline bool lanes_any(digit_lanes lanes)
+{
+    uint64_t words[2];
+    memcpy(words, &lanes, sizeof(words));
+    return (words[0] | words[1]) != 0;
+}
+
+/// @brief Verifies a solution against its puzzle: the digits and the givens are compared 16 cells at once, then the digits
+///        of each cell are turned into bits and the bits of the lines, the columns and the regions are OR-ed together, every
+///        unit of a valid grid holding the 9 bits
+/// @param puzzle the digits of the puzzle, line by line, 0 for an empty cell
+/// @param solution the digits of the solution, line by line
+/// @return the outcome of the verification
+VERIFY_TARGETS
+enum verify_outcome sudoku_verify(const uint8_t *puzzle, const uint8_t *solution)
+{
+    // the cells past the grid are an empty cell of the puzzle holding a 1
+    digit_lanes givens[DIGIT_CHUNKS], digits[DIGIT_CHUNKS];
+    memset(givens, 0, sizeof(givens));
+    memset(digits, 1, sizeof(digits));
+    memcpy(givens, puzzle, PUZZLE_SIZE);
+    memcpy(digits, solution, PUZZLE_SIZE);
+
+    digit_lanes out_of_range = {0}, changed = {0};
+    for (int k = 0; k < DIGIT_CHUNKS; k++)
+    {
+        out_of_range |= (digit_lanes)((digits[k] - 1) > SUDOKU_SIZE - 1);
+        changed |= (digit_lanes)((givens[k] != 0) & (givens[k] != digits[k]));
+    }
+    if (lanes_any(out_of_range))
+        return VERIFY_DIGITS;
+    if (lanes_any(changed))
+        return VERIFY_GIVENS;
+
+    // the bits of each line in the lanes of its columns, the bits of the whole line are OR-ed on the way
+    uint16_t line_bits[SUDOKU_SIZE][16] __attribute__((aligned(32))) = {{0}};
+    uint16_t lines_bits[16] __attribute__((aligned(32))) = {0};
+    for (int i = 0; i < SUDOKU_SIZE; i++)
+    {
+        uint16_t bits = 0;
+        for (int j = 0; j < SUDOKU_SIZE; j++)
+            bits |= line_bits[i][j] = digit_bits[solution[i * SUDOKU_SIZE + j]];
+        lines_bits[i] = bits;
+    }
+
+    unit_lanes lines[SUDOKU_SIZE], units;
+    memcpy(lines, line_bits, sizeof(lines));
+    memcpy(&units, lines_bits, sizeof(units));
+
+    const unit_lanes full = {UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS,
+                             UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS, UNIT_BITS};
+    // the lanes left out of each check
+    const unit_lanes past_units = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff};
+    const unit_lanes past_regions = {0, 0xffff, 0xffff, 0, 0xffff, 0xffff, 0, 0xffff, 0xffff,
+                                     0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff};
+    // the lanes of the next two columns
+    const unit_lanes next = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 15};
+    const unit_lanes after_next = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 15, 15};
+
+    // the lines, then the columns: the lines OR-ed together
+    unit_lanes valid = (units == full) | past_units;
+    units = lines[0];
+    for (int i = 1; i < SUDOKU_SIZE; i++)
+        units |= lines[i];
+    valid &= (units == full) | past_units;
+
+    // the regions of each band: the lines of the band OR-ed together, then each column with the next two ones
+    for (int band = 0; band < SUDOKU_SIZE; band += SUDOKU_GRID_SIZE)
+    {
+        units = lines[band] | lines[band + 1] | lines[band + 2];
+        units |= __builtin_shuffle(units, next) | __builtin_shuffle(units, after_next);
+        valid &= (units == full) | past_regions;
+    }
+
+    uint64_t words[4];
+    memcpy(words, &valid, sizeof(words));
+    return ((words[0] & words[1] & words[2] & words[3]) == ~0ULL) ? VERIFY_VALID : VERIFY_UNITS;
+}
+
+/// @brief Verifies a solution against its puzzle, both with their digits packed two per byte (the first one in the high
+///        nibble) as in the records of the banks, the result files and the solution cache
+/// @param puzzle the packed digits of the puzzle
+/// @param solution the packed digits of the solution
+/// @return the outcome of the verification
+enum verify_outcome sudoku_verify_packed(const uint8_t *puzzle, const uint8_t *solution)
+{
+    uint8_t puzzle_digits[PUZZLE_SIZE + 1], solution_digits[PUZZLE_SIZE + 1];
+    for (int k = 0; k < (PUZZLE_SIZE + 1) / 2; k++)
+    {
+        puzzle_digits[2 * k] = puzzle[k] >> 4;
+        puzzle_digits[2 * k + 1] = puzzle[k] & 0xf;
+        solution_digits[2 * k] = solution[k] >> 4;
+        solution_digits[2 * k + 1] = solution[k] & 0xf;
+    }
+    return sudoku_verify(puzzle_digits, solution_digits);
+}
+
+/// @brief Verifies a batch of solutions against their puzzles, spread over the threads
+/// @param puzzles the digits of the puzzles, PUZZLE_SIZE bytes each
+/// @param solutions the digits of the solutions, PUZZLE_SIZE bytes each
+/// @param n the number of solutions
+/// @param outcomes the outcome of each verification
+/// @return the number of valid solutions
+long sudoku_verify_batch(const uint8_t *puzzles, const uint8_t *solutions, size_t n, enum verify_outcome *outcomes)
+{
+    long valid = 0;
+#pragma omp parallel for schedule(static) reduction(+ : valid)
+    for (size_t k = 0; k < n; k++)
+    {
+        outcomes[k] = sudoku_verify(puzzles + k * PUZZLE_SIZE, solutions + k * PUZZLE_SIZE);
+        valid += (outcomes[k] == VERIFY_VALID);
+    }
+    return valid;
+}
@@ -0,0 +1,321 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <omp.h>
+
+#include "config.h"
+#include "bank.h"
+#include "sink.h"
+#include "verifier.h"
+
+/// @brief A block of results verified at once
+struct verify_block
+{
+    size_t n;                          // the number of results of the block
+    char (*hash)[HASH_SIZE + 1];       // the hash of the puzzle of each result
+    uint8_t *puzzles;                  // the digits of the puzzles, PUZZLE_SIZE bytes each
+    uint8_t *solutions;                // the digits of the solutions, PUZZLE_SIZE bytes each
+    bool *known;                       // if the puzzle of each result is in the bank
+    enum verify_outcome *outcomes;     // the outcome of each verification
+};
+
+/// @brief The counts of the results verified
+struct verify_totals
+{
+    long results;                     // the number of results read
+    long unsolved;                    // the number of results not claimed solved, not verified
+    long unknown;                     // the number of results whose puzzle isn't in the bank
+    long outcomes[VERIFY_OUTCOMES];   // the number of results of each outcome
+};
+
+/// @brief Prints how to use the solution verifier
+/// @param program the name of the program
+void print_usage(char *program)
+{
+    fprintf(stderr, "Use: %s bank [results]\n", program);
+    fprintf(stderr, "Where :\n");
+    fprintf(stderr, "  bank    : The file containing the sudoku puzzles solved (text or binary format)\n");
+    fprintf(stderr, "  results : The results of the solver, the standard input if not given: a binary result file (-F binary),\n");
+    fprintf(stderr, "            a JSONL result file (-F jsonl) or the solutions written with -S\n");
+    fprintf(stderr, "The solutions claimed solved are verified against their puzzle, the invalid ones are printed with the reason\n");
+}
+
+/// @brief Allocates a block of results
+/// @param block the block
+void verify_block_init(struct verify_block *block)
+{
+    block->n = 0;
+    block->hash = malloc(VERIFY_BATCH * sizeof(*block->hash));
+    block->puzzles = malloc(VERIFY_BATCH * PUZZLE_SIZE);
+    block->solutions = malloc(VERIFY_BATCH * PUZZLE_SIZE);
+    block->known = malloc(VERIFY_BATCH * sizeof(bool));
+    block->outcomes = malloc(VERIFY_BATCH * sizeof(enum verify_outcome));
+    if (block->hash == NULL || block->puzzles == NULL || block->solutions == NULL || block->known == NULL || block->outcomes == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory!!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/// @brief Frees a block of results
+/// @param block the block
+void verify_block_free(struct verify_block *block)
+{
+    free(block->hash);
+    free(block->puzzles);
+    free(block->solutions);
+    free(block->known);
+    free(block->outcomes);
+}
+
+/// @brief Looks the puzzles of a block up in the bank, verifies the solutions and prints the invalid ones
+/// @param block the block, emptied
+/// @param bank the puzzle bank
+/// @param totals the counts of the results verified
+void verify_block_flush(struct verify_block *block, struct puzzle_bank *bank, struct verify_totals *totals)
+{
+    long n = (long)block->n;
+
+#pragma omp parallel for schedule(static)
+    for (long k = 0; k < n; k++)
+    {
+        int grid[SUDOKU_SIZE][SUDOKU_SIZE];
+        uint8_t *puzzle = block->puzzles + k * PUZZLE_SIZE;
+        if ((block->known[k] = puzzle_bank_get(bank, block->hash[k], grid, NULL)))
+        {
+            for (int i = 0; i < PUZZLE_SIZE; i++)
+                puzzle[i] = (uint8_t)grid[i / SUDOKU_SIZE][i % SUDOKU_SIZE];
+        }
+        else
+            memset(puzzle, 0, PUZZLE_SIZE);
+    }
+
+    sudoku_verify_batch(block->puzzles, block->solutions, block->n, block->outcomes);
+
+    for (long k = 0; k < n; k++)
+    {
+        if (!block->known[k])
+        {
+            totals->unknown++;
+            printf("%s unknown\n", block->hash[k]);
+            continue;
+        }
+        totals->outcomes[block->outcomes[k]]++;
+        if (block->outcomes[k] != VERIFY_VALID)
+            printf("%s %s\n", block->hash[k], verify_outcome_name(block->outcomes[k]));
+    }
+    block->n = 0;
+}
+
+/// @brief Adds a result to the block, the block is verified once full
+/// @param block the block
+/// @param hash the hash of the puzzle, at most HASH_SIZE characters are kept
+/// @param length the length of the hash
+/// @param solution the digits of the solution (characters '0' to '9' if text, digits otherwise)
+/// @param text if the digits are characters
+/// @param bank the puzzle bank
+/// @param totals the counts of the results verified
+void verify_block_add(struct verify_block *block, const char *hash, size_t length, const uint8_t *solution, bool text,
+                      struct puzzle_bank *bank, struct verify_totals *totals)
+{
+    if (length > HASH_SIZE)
+        length = HASH_SIZE;
+    memcpy(block->hash[block->n], hash, length);
+    block->hash[block->n][length] = '\0';
+
+    uint8_t *digits = block->solutions + block->n * PUZZLE_SIZE;
+    for (int i = 0; i < PUZZLE_SIZE; i++)
+        digits[i] = (text) ? (uint8_t)(solution[i] - '0') : solution[i];
+
+    if (++block->n == VERIFY_BATCH)
+        verify_block_flush(block, bank, totals);
+}
+
+/// @brief Verifies the records of a binary result file
+/// @param records the records
+/// @param n the number of records
+/// @param block the block of results
+/// @param bank the puzzle bank
+/// @param totals the counts of the results verified
+void verify_records(const struct sink_record *records, size_t n, struct verify_block *block, struct puzzle_bank *bank,
+                    struct verify_totals *totals)
+{
+    for (size_t k = 0; k < n; k++)
+    {
+        const struct sink_record *record = &records[k];
+        if (!record->written)
+            continue;
+        totals->results++;
+        if (!record->solved)
+        {
+            totals->unsolved++;
+            continue;
+        }
+
+        uint8_t digits[RECORD_DIGITS * 2];
+        for (int i = 0; i < RECORD_DIGITS; i++)
+        {
+            digits[2 * i] = record->solution[i] >> 4;
+            digits[2 * i + 1] = record->solution[i] & 0xf;
+        }
+        verify_block_add(block, record->hash, strnlen(record->hash, HASH_SIZE), digits, false, bank, totals);
+    }
+}
+
+/// @brief Verifies a result line: a JSONL line of a result file, or a line written with -S (hash, grid found, cost and time)
+/// @param line the line
+/// @param block the block of results
+/// @param bank the puzzle bank
+/// @param totals the counts of the results verified
+void verify_line(const char *line, struct verify_block *block, struct puzzle_bank *bank, struct verify_totals *totals)
+{
+    const char *hash, *solution;
+    size_t length;
+    bool solved;
+
+    line += strspn(line, " \t");
+    if (*line == '\0' || *line == '\n' || *line == '#')
+        return;
+
+    if (*line == '{')
+    { // the escaped characters of the hashes are never the ones of a bank
+        if ((hash = strstr(line, "\"hash\":\"")) == NULL || (solution = strstr(line, "\"solution\":\"")) == NULL)
+        {
+            fprintf(stderr, "WARNING: invalid result line skipped: %s", line);
+            return;
+        }
+        hash += strlen("\"hash\":\"");
+        length = strcspn(hash, "\"");
+        solution += strlen("\"solution\":\"");
+        solved = (strstr(line, "\"solved\":true") != NULL);
+    }
+    else
+    {
+        int cost;
+        hash = line;
+        length = strcspn(hash, " \t");
+        solution = hash + length + strspn(hash + length, " \t");
+        solved = (sscanf(solution + strcspn(solution, " \t"), "%d", &cost) == 1 && cost <= SOLUTION_COST);
+    }
+
+    if (strspn(solution, "0123456789") != PUZZLE_SIZE)
+    {
+        fprintf(stderr, "WARNING: invalid result line skipped: %s", line);
+        return;
+    }
+    totals->results++;
+    if (!solved)
+    {
+        totals->unsolved++;
+        return;
+    }
+    verify_block_add(block, hash, length, (const uint8_t *)solution, true, bank, totals);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    // the bank is in the directory of the sudoku puzzles, as for the solver
+    char filename[FILE_SIZE] = SUDOKU_DIR;
+    strncat(filename, argv[1], FILE_SIZE - strlen(filename) - 1);
+    struct puzzle_bank bank;
+    puzzle_bank_open(&bank, filename);
+
+    FILE *input = stdin;
+    if (argc == 3 && (input = fopen(argv[2], "rb")) == NULL)
+    {
+        perror("Problem encountered when opening the result file");
+        exit(EXIT_FAILURE);
+    }
+
+    struct verify_block block;
+    struct verify_totals totals = {0};
+    verify_block_init(&block);
+    double start_time = omp_get_wtime();
+
+    // the binary result files start with their magic, which never starts a result line
+    struct sink_header header;
+    char line[LINE_SIZE * 4];
+    size_t length = 0;
+    int c = 0;
+    while (length < sizeof(header.magic) && (c = fgetc(input)) != EOF && c != '\n')
+        line[length++] = (char)c;
+
+    if (length == sizeof(header.magic) && memcmp(line, SINK_BINARY_MAGIC, length) == 0)
+    {
+        memcpy(header.magic, line, length);
+        if (fread((char *)&header + length, sizeof(header) - length, 1, input) != 1 || header.record_size != sizeof(struct sink_record))
+        {
+            fprintf(stderr, "ERROR: invalid header of the binary result file\n");
+            exit(EXIT_FAILURE);
+        }
+
+        struct stat status;
+        if (fstat(fileno(input), &status) == 0 && S_ISREG(status.st_mode))
+        { // a result file is mapped at once, the records of the blocks are never copied
+            size_t records = (status.st_size - sizeof(header)) / sizeof(struct sink_record);
+            records = (header.records < records) ? header.records : records;
+            void *map = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fileno(input), 0);
+            if (map == MAP_FAILED)
+            {
+                perror("Problem encountered when mapping the result file");
+                exit(EXIT_FAILURE);
+            }
+            madvise(map, status.st_size, MADV_SEQUENTIAL);
+            verify_records((const struct sink_record *)((char *)map + sizeof(header)), records, &block, &bank, &totals);
+            munmap(map, status.st_size);
+        }
+        else
+        { // a stream of records
+            struct sink_record *records = malloc(VERIFY_BATCH * sizeof(struct sink_record));
+            size_t n, left = header.records;
+            if (records == NULL)
+            {
+                fprintf(stderr, "ERROR: Out of memory!!\n");
+                exit(EXIT_FAILURE);
+            }
+            while (left > 0 && (n = fread(records, sizeof(struct sink_record), (left < VERIFY_BATCH) ? left : VERIFY_BATCH, input)) > 0)
+            {
+                verify_records(records, n, &block, &bank, &totals);
+                left -= n;
+            }
+            free(records);
+        }
+    }
+    else
+    { // result lines, the start of the first one is already read
+        line[length] = '\0';
+        if (length > 0 && c != '\n' && c != EOF && fgets(line + length, sizeof(line) - length, input) == NULL)
+            line[length] = '\0';
+        if (length > 0)
+            verify_line(line, &block, &bank, &totals);
+        while (fgets(line, sizeof(line), input) != NULL)
+            verify_line(line, &block, &bank, &totals);
+    }
+    verify_block_flush(&block, &bank, &totals);
+    double CPU_time = omp_get_wtime() - start_time;
+
+    long invalid = totals.outcomes[VERIFY_DIGITS] + totals.outcomes[VERIFY_GIVENS] + totals.outcomes[VERIFY_UNITS];
+    fprintf(stderr, ">> Results read : %ld (%ld not solved, not verified)\n", totals.results, totals.unsolved);
+    fprintf(stderr, ">> Solutions valid : %ld/%ld\n", totals.outcomes[VERIFY_VALID], totals.outcomes[VERIFY_VALID] + invalid);
+    fprintf(stderr, ">> Solutions invalid : %ld (digits %ld, givens %ld, units %ld)\n", invalid, totals.outcomes[VERIFY_DIGITS],
+            totals.outcomes[VERIFY_GIVENS], totals.outcomes[VERIFY_UNITS]);
+    if (totals.unknown > 0)
+        fprintf(stderr, ">> Puzzles not found in the bank : %ld\n", totals.unknown);
+    fprintf(stderr, ">> Results per second : %f\n", (CPU_time > 0) ? totals.results / CPU_time : 0);
+
+    verify_block_free(&block);
+    if (input != stdin)
+        fclose(input);
+    puzzle_bank_close(&bank);
+    return (invalid > 0 || totals.unknown > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
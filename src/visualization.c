@@ -1,79 +1,174 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <unistd.h>
-#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <curses.h>
 
 #include "config.h"
-#include <curses.h>
+#include "snapshot.h"
+
+#define ESC 27
 
-#define ESC '\e'
+// the color pairs of the viewer
+enum view_color
+{
+    VIEW_GIVEN = 1, // the digits of the puzzle
+    VIEW_CELL,      // the digits placed by the solver without conflict
+    VIEW_CONFLICT,  // the digits in conflict with another one of their line, column or region
+    VIEW_TITLE      // the labels
+};
 
-void show_sudoku_grid(int sudoku[][]) {
-    int i;
-    
-    window_erase(stdscr);
+/// @brief Finds if the digit of a cell is also in another cell of its line, column or region
+/// @param grid the digits of the grid
+/// @param cell the index of the cell
+/// @return true if the digit is in conflict
+static bool cell_conflict(const uint8_t *grid, int cell)
+{
+    int line = cell / SUDOKU_SIZE, column = cell % SUDOKU_SIZE;
+    int region_line = line - line % SUDOKU_GRID_SIZE, region_column = column - column % SUDOKU_GRID_SIZE;
+    uint8_t digit = grid[cell];
+    if (digit == 0)
+        return false;
+
+    for (int k = 0; k < SUDOKU_SIZE; k++)
+    {
+        int same_line = line * SUDOKU_SIZE + k;
+        int same_column = k * SUDOKU_SIZE + column;
+        int same_region = (region_line + k / SUDOKU_GRID_SIZE) * SUDOKU_SIZE + region_column + k % SUDOKU_GRID_SIZE;
+        if ((same_line != cell && grid[same_line] == digit) || (same_column != cell && grid[same_column] == digit) ||
+            (same_region != cell && grid[same_region] == digit))
+            return true;
+    }
+    return false;
+}
 
-    printw("╭-------+-------+-------╮\n");
-    for (i = 0; i < SUDOKU_SIZE; i++)
+/// @brief Draws the grid of the run: the givens, the digits in conflict and the others in their own color
+/// @param state the state of the run
+/// @param top the line of the screen the grid starts at
+static void show_sudoku_grid(const struct sudoku_snapshot *state, int top)
+{
+    for (int i = 0; i < SUDOKU_SIZE; i++)
     {
-        for (j = 0; j < SUDOKU_SIZE; j++)
+        if (i % SUDOKU_GRID_SIZE == 0)
+            mvprintw(top++, 0, "+-------+-------+-------+");
+        move(top++, 0);
+        for (int j = 0; j < SUDOKU_SIZE; j++)
         {
-            if (j == 0)
-                printw("| ");
-            printw("%d ", sudoku[i][j]);
-            if ((j + 1) % 3 == 0)
+            int cell = i * SUDOKU_SIZE + j;
+            int color = (state->givens[cell] != 0) ? VIEW_GIVEN : (cell_conflict(state->grid, cell)) ? VIEW_CONFLICT : VIEW_CELL;
+            if (j % SUDOKU_GRID_SIZE == 0)
                 printw("| ");
+            attron(COLOR_PAIR(color));
+            if (state->grid[cell] == 0)
+                printw(". ");
+            else
+                printw("%d ", state->grid[cell]);
+            attroff(COLOR_PAIR(color));
         }
-        printw("\n");
-        if ((i + 1) % 3 == 0)
-            printw("├-------+-------+-------┤\n");
+        printw("|");
     }
-    
-    window_refresh(stdscr);
+    mvprintw(top, 0, "+-------+-------+-------+");
 }
- 
-int main() {
-    int fd, i;
-
-    size_t offset = 0;
-    size_t bytes, bytes_read;
-    int sudoku_buffer[SUDOKU_SIZE][SUDOKU_SIZE];
-
-    ncurses_init();
-        
-    ncurses_colors();
-    palette();
-
-    if((fd = open(DATA_PIPE, O_RDONLY)) == -1) {
-        perror("Error opening pipe");
-        exit(EXIT_FAILURE);
-    }
-    
-    while(true) {
-        if((bytes = read(fd, &sudoku_buffer[offset], sizeof(int) * SUDOKU_SIZE)) == -1) {
-            perror("Error reading sudoku data from pipe");
-            exit(EXIT_FAILURE);
-        }
 
-        bytes_read += bytes;
+/// @brief Draws the state of the run
+/// @param state the state of the run
+/// @param speed the moves per second measured between the last two states
+/// @param running if the process of the run is still alive
+static void show_state(const struct sudoku_snapshot *state, double speed, bool running)
+{
+    const char *status = (state->finished) ? ((state->solved) ? "solved" : "finished, not solved") : (running) ? "running" : "stopped";
+    attron(COLOR_PAIR(VIEW_TITLE) | A_BOLD);
+    mvprintw(0, 0, "Sudoku run of process %d: %s", state->pid, status);
+    attroff(COLOR_PAIR(VIEW_TITLE) | A_BOLD);
+
+    show_sudoku_grid(state, 2);
 
-        if(bytes_read > PUZZLE_SIZE) {
-            //reset offset and bytes read
-            offset = 0;
-            bytes_read = 0;
-            show_sudoku_grid(sudoku_buffer);
+    int line = 2 + SUDOKU_SIZE + SUDOKU_GRID_SIZE + 2;
+    mvprintw(line++, 0, "Cost        : %d", state->cost);
+    if (state->lowest_cost >= 0)
+        mvprintw(line++, 0, "Lowest cost : %d", state->lowest_cost);
+    else
+        mvprintw(line++, 0, "Lowest cost : -");
+    mvprintw(line++, 0, "Try         : %d", state->tries);
+    mvprintw(line++, 0, "Temperature : %f", state->temperature);
+    mvprintw(line++, 0, "Moves       : %lld (%.0f per second)", (long long)state->moves, speed);
+    mvprintw(line++, 0, "Time        : %.1f s", state->time);
+    mvprintw(line + 1, 0, "q or ESC to quit");
+}
+
+/// @brief Finds if the process of a run is still alive
+/// @param state the state of the run
+/// @return true if the process is alive
+static bool run_alive(const struct sudoku_snapshot *state)
+{
+    return state->pid > 0 && (kill(state->pid, 0) == 0 || errno != ESRCH);
+}
+
+int main()
+{
+    const struct sudoku_snapshot *snapshot = NULL;
+    struct sudoku_snapshot state, previous = {0};
+    double speed = 0;
+    int key;
+
+    initscr();
+    cbreak();
+    noecho();
+    curs_set(0);
+    keypad(stdscr, TRUE);
+    start_color();
+    use_default_colors();
+    init_pair(VIEW_GIVEN, COLOR_CYAN, -1);
+    init_pair(VIEW_CELL, COLOR_GREEN, -1);
+    init_pair(VIEW_CONFLICT, COLOR_RED, -1);
+    init_pair(VIEW_TITLE, COLOR_YELLOW, -1);
+    // one frame each time getch gives up waiting for a key
+    timeout(1000 / VISUALIZATION_FPS);
+
+    while ((key = getch()) != 'q' && key != ESC)
+    {
+        erase();
+        if (snapshot == NULL && (snapshot = snapshot_attach()) == NULL)
+        {
+            mvprintw(0, 0, "Waiting for a run of the solver built with 'make show'...");
+            mvprintw(2, 0, "q or ESC to quit");
+            refresh();
+            continue;
         }
 
-        offset++;
-        if(sudoku_data == -1) break;
-    }
-    
-    if(close(fd) == -1) {
-        perror("Error closing pipe");
-        exit(EXIT_FAILURE);
+        // the solver never waits for the viewer, only the last state published is drawn
+        snapshot_read(snapshot, &state);
+        if (state.published != previous.published && state.time > previous.time && state.started == previous.started)
+            speed = (state.moves - previous.moves) / (state.time - previous.time);
+        else if (state.started != previous.started)
+            speed = 0;
+        previous = state;
+
+        bool running = !state.finished && run_alive(&state);
+        show_state(&state, speed, running);
+        refresh();
+
+        if (!running)
+        { // follow the next run as soon as it starts
+            const struct sudoku_snapshot *next = snapshot_attach();
+            struct sudoku_snapshot next_state;
+            if (next != NULL)
+            {
+                snapshot_read(next, &next_state);
+                if (next_state.started != state.started)
+                {
+                    snapshot_detach(snapshot);
+                    snapshot = next;
+                }
+                else
+                    snapshot_detach(next);
+            }
+        }
     }
 
-    ncurses_stop();
-    
+    snapshot_detach(snapshot);
+    endwin();
     return EXIT_SUCCESS;
 }